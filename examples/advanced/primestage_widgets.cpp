@@ -6,13 +6,19 @@
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -61,6 +67,64 @@ struct DemoApp {
   DemoState state;
 };
 
+// Advanced PrimeFrame integration (documented exception): the host's waitEvents() has no timeout,
+// so a helper thread wakes the loop at the next timer deadline. It wakes through
+// AppPlatformServices::onPostedUpdate, the hook App documents as thread-safe for waking the host
+// from worker posts, rather than calling into the host from a thread it does not own.
+class HostWakeTimer {
+public:
+  explicit HostWakeTimer(std::function<void()> wake)
+      : wake_(std::move(wake)), thread_([this](std::stop_token stop) { run(stop); }) {}
+
+  ~HostWakeTimer() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      thread_.request_stop();
+    }
+    changed_.notify_all();
+  }
+
+  void arm(std::optional<PrimeStage::TimerScheduler::Clock::time_point> deadline) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (deadline_ == deadline) {
+        return;
+      }
+      deadline_ = deadline;
+    }
+    changed_.notify_all();
+  }
+
+private:
+  void run(std::stop_token stop) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop.stop_requested()) {
+      if (!deadline_.has_value()) {
+        changed_.wait(lock, [&] { return stop.stop_requested() || deadline_.has_value(); });
+        continue;
+      }
+      auto deadline = *deadline_;
+      if (changed_.wait_until(lock, deadline, [&] {
+            return stop.stop_requested() || deadline_ != deadline;
+          })) {
+        continue;
+      }
+      deadline_.reset();
+      lock.unlock();
+      if (wake_) {
+        wake_();
+      }
+      lock.lock();
+    }
+  }
+
+  std::function<void()> wake_;
+  std::mutex mutex_;
+  std::condition_variable changed_;
+  std::optional<PrimeStage::TimerScheduler::Clock::time_point> deadline_;
+  std::jthread thread_;
+};
+
 PrimeStage::UiNode createSection(PrimeStage::UiNode parent, std::string_view title) {
   PrimeStage::StackSpec sectionSpec;
   sectionSpec.size.stretchX = 1.0f;
@@ -313,6 +377,7 @@ void rebuildUi(PrimeStage::UiNode root, DemoApp& app) {
           return PrimeStage::widgetIdentityId(node.label);
         });
     treeModel.bind(tree);
+    app.ui.applyPlatformServices(tree);
     data.createTreeView(tree);
   }
 
@@ -485,8 +550,13 @@ int main(int argc, char** argv) {
   };
 
   bool running = true;
+  // Copied once connectHostServices() has installed the wake hook, before the thread starts.
+  HostWakeTimer wakeTimer(app.ui.platformServices().onPostedUpdate);
 
   while (running) {
+    // A pending frame is already requested at the bottom of the loop; arming "now" for it would
+    // send a second, immediate wake.
+    wakeTimer.arm(app.ui.lifecycle().framePending() ? std::nullopt : app.ui.nextWakeDeadline());
     app.host->waitEvents();
 
     // Advanced PrimeFrame integration (documented exception): this advanced sample consumes raw
@@ -523,6 +593,8 @@ int main(int argc, char** argv) {
       }
     }
 
+    // Cursor blink and double-click expiry are deadline timers; only blink requests a frame.
+    (void)app.ui.runDueTimers();
     runRebuildIfNeeded(app);
 
     if (app.ui.lifecycle().framePending()) {
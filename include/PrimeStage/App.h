@@ -5,20 +5,34 @@
 #include "PrimeStage/Render.h"
 #include "PrimeStage/Ui.h"
 
+#include <atomic>
+#include <chrono>
 #include <cstdint>
+#include <deque>
+#include <exception>
 #include <functional>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace PrimeStage {
 
+namespace Internal {
+class BuildTaskPool;
+} // namespace Internal
+
 struct AppPlatformServices {
   TextFieldClipboard textFieldClipboard{};
   SelectableTextClipboard selectableTextClipboard{};
   std::function<void(CursorHint)> onCursorHintChanged;
   std::function<void(int32_t, int32_t, int32_t, int32_t)> onImeCompositionRectChanged;
+  // Invoked on the posting thread when App::post makes the update queue non-empty. Must be
+  // thread-safe and installed before worker threads start posting.
+  std::function<void()> onPostedUpdate;
 };
 
 enum class AppActionSource : uint8_t {
@@ -49,7 +63,10 @@ using AppActionCallback = std::function<void(AppActionInvocation const&)>;
 
 class App {
 public:
-  App() = default;
+  App();
+  ~App();
+  App(App const&) = delete;
+  App& operator=(App const&) = delete;
 
   [[nodiscard]] FrameLifecycle& lifecycle() { return lifecycle_; }
   [[nodiscard]] FrameLifecycle const& lifecycle() const { return lifecycle_; }
@@ -65,6 +82,7 @@ public:
   void setPlatformServices(AppPlatformServices const& services);
   void applyPlatformServices(TextFieldSpec& spec) const;
   void applyPlatformServices(SelectableTextSpec& spec) const;
+  void applyPlatformServices(TreeViewSpec& spec) const;
   void connectHostServices(PrimeHost::Host& host, PrimeHost::SurfaceId surfaceId);
   void clearHostServices();
   bool registerAction(std::string_view actionId, AppActionCallback callback);
@@ -76,15 +94,59 @@ public:
                     std::optional<AppShortcut> shortcut = std::nullopt);
   std::function<void()> makeActionCallback(std::string actionId);
 
+  // Swaps the default theme's palette and style tables in place and re-runs the readability pass.
+  // Primitives reference styles by token, so when text metrics are unchanged (e.g. light/dark or
+  // accent swaps) the switch costs a single render. Changed text metrics request a rebuild, since
+  // widgets measure text into their size hints at build time. Returns true when a rebuild was
+  // requested. Later rebuilds, background ones included, keep the theme.
+  bool setTheme(PrimeFrame::Theme const& theme);
+  [[nodiscard]] std::optional<PrimeFrame::Theme> const& theme() const { return theme_; }
+
   void setSurfaceMetrics(uint32_t width, uint32_t height, float scale = 1.0f);
   void setRenderMetrics(uint32_t width, uint32_t height, float scale = 1.0f);
 
+  // Thread-safe update posting for worker threads. Updates run on the UI thread when the next frame
+  // starts (runRebuildIfNeeded drains them first) and schedule a single rebuild. Posts sharing a key
+  // coalesce so only the newest one runs per frame.
+  void post(std::function<void()> update);
+  void post(std::string_view key, std::function<void()> update);
+  std::size_t drainPostedUpdates();
+  // Also resumes a pending progressive build when no rebuild is requested; returns true when
+  // either ran.
   [[nodiscard]] bool runRebuildIfNeeded(std::function<void(UiNode)> const& rebuildUi);
+  // Progressive construction: with a non-zero budget, UiNode::deferred sections are built after the
+  // rebuild closure returns, only as many per frame as fit the budget. Unfinished sections present
+  // as empty placeholders and input keeps dispatching while the rest fills in. Zero disables it.
+  void setProgressiveBuildBudget(std::chrono::microseconds budget);
+  [[nodiscard]] std::chrono::microseconds progressiveBuildBudget() const {
+    return progressiveBuildBudget_;
+  }
+  [[nodiscard]] bool progressiveBuildPending() const { return buildQueue_.pending(); }
+  // Worker threads used by UiNode::prepareInParallel during rebuilds (the building thread helps).
+  // Zero, the default, prepares parallel sections serially.
+  void setBuildThreadCount(size_t workerCount);
+  [[nodiscard]] size_t buildThreadCount() const;
+  // Opt-in asynchronous rebuild: builds into a back frame on a worker thread while input keeps
+  // dispatching against the front frame. The closure must only read data it captured by value.
+  // When `identity` is provided, focus is carried over to the node registered under the same
+  // identity after the swap; the worker owns the reconciler until then.
+  [[nodiscard]] bool startBackgroundRebuild(std::function<void(UiNode)> rebuildUi,
+                                            WidgetIdentityReconciler* identity = nullptr);
+  // Swaps a finished background frame in at a frame boundary; returns false while it is running.
+  [[nodiscard]] bool commitBackgroundRebuild();
+  [[nodiscard]] bool backgroundRebuildInFlight() const { return lifecycle_.rebuildInFlight(); }
   [[nodiscard]] bool runLayoutIfNeeded();
   [[nodiscard]] bool dispatchFrameEvent(PrimeFrame::Event const& event);
   [[nodiscard]] InputBridgeResult bridgeHostInputEvent(PrimeHost::InputEvent const& input,
                                                        PrimeHost::EventBatch const& batch,
                                                        HostKey exitKey = HostKey::Escape);
+  // Dispatches a whole host batch: consecutive pointer moves collapse to the last move per pointer,
+  // consecutive scrolls are summed and the IME rect syncs once at the end. Pending layout runs up
+  // front and again before any event that follows a layout-dirtying one (a resize, or a handler
+  // that moved nodes), so no event hit tests stale layout. Resize payloads update surface metrics
+  // in order; other payloads are left to the host.
+  [[nodiscard]] InputBridgeResult dispatchEventBatch(PrimeHost::EventBatch const& batch,
+                                                     HostKey exitKey = HostKey::Escape);
   [[nodiscard]] bool focusWidget(WidgetFocusHandle handle);
   [[nodiscard]] bool isWidgetFocused(WidgetFocusHandle handle) const;
   [[nodiscard]] bool setWidgetVisible(WidgetVisibilityHandle handle, bool visible);
@@ -95,38 +157,92 @@ public:
 
   [[nodiscard]] RenderStatus renderToTarget(RenderTarget const& target);
   [[nodiscard]] RenderStatus renderToPng(std::string_view path);
+  // Pipelined presentation: captures an immutable snapshot here and rasterizes it on a dedicated
+  // render thread, so UI work for the next frame overlaps raster work for this one. Blocks only
+  // when the bounded render queue is full. `onComplete` runs on the render thread.
+  [[nodiscard]] RenderStatus submitRenderToTarget(RenderTarget const& target,
+                                                  RenderPipeline::Completion onComplete = {});
+  void waitForRenderIdle();
 
   void markFramePresented() { lifecycle_.markFramePresented(); }
 
+  // Deadline-driven wakeups (cursor blink, double-click expiry). Hosts wait on events until
+  // nextWakeDeadline() instead of polling, then call runDueTimers() before presenting.
+  [[nodiscard]] TimerScheduler& timers() { return timers_; }
+  [[nodiscard]] TimerScheduler const& timers() const { return timers_; }
+  [[nodiscard]] std::optional<TimerScheduler::Clock::time_point> nextWakeDeadline() const;
+  std::size_t runDueTimers(TimerScheduler::Clock::time_point now = TimerScheduler::Clock::now());
+
   // Low-level escape hatches for advanced runtime integrations.
   [[nodiscard]] PrimeFrame::Frame& frame() { return frame_; }
   [[nodiscard]] PrimeFrame::Frame const& frame() const { return frame_; }
   [[nodiscard]] PrimeFrame::LayoutOutput& layout() { return layout_; }
   [[nodiscard]] PrimeFrame::LayoutOutput const& layout() const { return layout_; }
+  [[nodiscard]] UiMemoCache const& memoCache() const { return memoCache_; }
+  [[nodiscard]] ThemeStyleTable const& themeStyles() const { return styleTable_; }
+  [[nodiscard]] FocusRing const& focusRing() const { return *focusRing_; }
   [[nodiscard]] PrimeFrame::FocusManager& focus() { return focus_; }
   [[nodiscard]] PrimeFrame::FocusManager const& focus() const { return focus_; }
   [[nodiscard]] PrimeFrame::EventRouter& router() { return router_; }
   [[nodiscard]] PrimeFrame::EventRouter const& router() const { return router_; }
 
 private:
+  // Action ids are interned once per registration; lookups and shortcut bindings refer to the
+  // stable slot index instead of comparing strings.
   struct ActionEntry {
     std::string id;
     AppActionCallback callback{};
+    AppActionCallback pendingCallback{};
+    AppActionInvocation invocation{};
+    std::vector<uint64_t> shortcutKeys{};
+    uint32_t invokeDepth = 0u;
+    bool active = false;
   };
   struct ShortcutEntry {
     AppShortcut shortcut{};
-    std::string actionId;
+    uint32_t actionSlot = 0u;
   };
 
-  [[nodiscard]] ActionEntry* findAction(std::string_view actionId);
-  [[nodiscard]] ActionEntry const* findAction(std::string_view actionId) const;
+  [[nodiscard]] std::optional<uint32_t> findActionSlot(std::string_view actionId) const;
+  [[nodiscard]] bool invokeActionSlot(uint32_t slot,
+                                      AppActionSource source,
+                                      std::optional<AppShortcut> const& shortcut);
+  void settleActionSlot(uint32_t slot);
+  void releaseShortcutKey(uint32_t slot, uint64_t key);
   [[nodiscard]] bool dispatchShortcut(PrimeHost::KeyEvent const& event);
   [[nodiscard]] float resolvedLayoutScale() const;
   [[nodiscard]] uint32_t resolvedLayoutWidth() const;
   [[nodiscard]] uint32_t resolvedLayoutHeight() const;
   void syncImeCompositionRect();
+  [[nodiscard]] bool runProgressiveBuildStep();
+  void flushBatchedInput(PrimeHost::EventBatch const& batch,
+                         HostKey exitKey,
+                         InputBridgeResult& merged);
+
+  struct BackgroundRebuild {
+    PrimeFrame::Frame frame{};
+    std::function<void(UiNode)> rebuildUi{};
+    std::optional<PrimeFrame::Theme> theme{};
+    // Focus handlers in `frame` capture this ring; it replaces focusRing_ at commit.
+    std::unique_ptr<FocusRing> focusRing = std::make_unique<FocusRing>();
+    WidgetIdentityReconciler* identity = nullptr;
+    std::exception_ptr error{};
+    std::atomic<bool> done{false};
+    std::thread worker{};
+  };
 
+  // Declared before frame_ so widget timers are cancelled against a live scheduler on teardown.
+  mutable TimerScheduler timers_{};
   PrimeFrame::Frame frame_{};
+  UiMemoCache memoCache_{};
+  ThemeStyleTable styleTable_{};
+  // Heap-owned so a background rebuild's ring, captured by its frame's handlers, can replace it.
+  std::unique_ptr<FocusRing> focusRing_ = std::make_unique<FocusRing>();
+  std::optional<PrimeFrame::Theme> theme_{};
+  ProgressiveBuildQueue buildQueue_{};
+  // Private type (src/PrimeStageBuildTaskPool.h); keeps thread headers out of the public API.
+  std::unique_ptr<Internal::BuildTaskPool> buildPool_;
+  std::chrono::microseconds progressiveBuildBudget_{0};
   PrimeFrame::LayoutEngine layoutEngine_{};
   PrimeFrame::LayoutOutput layout_{};
   PrimeFrame::EventRouter router_{};
@@ -135,8 +251,10 @@ private:
   InputBridgeState inputBridge_{};
   RenderOptions renderOptions_{};
   AppPlatformServices platformServices_{};
-  std::vector<ActionEntry> actions_{};
-  std::vector<ShortcutEntry> shortcutBindings_{};
+  std::deque<ActionEntry> actions_{};
+  std::vector<uint32_t> freeActionSlots_{};
+  std::unordered_map<std::string_view, uint32_t> actionSlots_{};
+  std::unordered_map<uint64_t, std::vector<ShortcutEntry>> shortcutBindings_{};
   uint32_t surfaceWidth_ = 1280u;
   uint32_t surfaceHeight_ = 720u;
   float surfaceScale_ = 1.0f;
@@ -148,6 +266,13 @@ private:
   int32_t imeY_ = 0;
   int32_t imeW_ = 0;
   int32_t imeH_ = 0;
+  bool batchDispatchActive_ = false;
+  std::vector<PrimeHost::PointerEvent> batchPendingMoves_{};
+  std::optional<PrimeHost::ScrollEvent> batchPendingScroll_{};
+  std::unique_ptr<BackgroundRebuild> backgroundRebuild_{};
+  std::unique_ptr<RenderPipeline> renderPipeline_{};
+  PostedUpdateQueue postedUpdates_{};
+  WidgetIdentityReconciler* pendingFocusIdentity_ = nullptr;
 };
 
 } // namespace PrimeStage
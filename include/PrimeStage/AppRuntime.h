@@ -1,5 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 namespace PrimeStage {
 
 class FrameLifecycle {
@@ -7,6 +23,7 @@ public:
   bool rebuildPending() const { return rebuildPending_; }
   bool layoutPending() const { return layoutPending_; }
   bool framePending() const { return framePending_; }
+  bool rebuildInFlight() const { return rebuildInFlight_; }
 
   void requestRebuild() {
     rebuildPending_ = true;
@@ -27,6 +44,19 @@ public:
     framePending_ = true;
   }
 
+  // Background rebuilds consume the pending request when the worker starts, so requests made while
+  // it runs stay pending and schedule another rebuild after the swap.
+  void markRebuildStarted() {
+    rebuildPending_ = false;
+    rebuildInFlight_ = true;
+  }
+
+  void markRebuildSwapped() {
+    rebuildInFlight_ = false;
+    layoutPending_ = true;
+    framePending_ = true;
+  }
+
   void markLayoutComplete() { layoutPending_ = false; }
 
   void markFramePresented() { framePending_ = false; }
@@ -55,6 +85,312 @@ private:
   bool rebuildPending_ = true;
   bool layoutPending_ = true;
   bool framePending_ = true;
+  bool rebuildInFlight_ = false;
+};
+
+// Carries layout requests out of widget handlers, which cannot reach the App dispatching the
+// event. Recycled collection rows move by rewriting localY, so scrolling or rebinding them calls
+// request(); App dispatch holds a scope and turns a request into FrameLifecycle::requestLayout.
+// Outside a scope the request is dropped, since hosts driving PrimeFrame directly own layout.
+class LayoutRequestScope {
+public:
+  LayoutRequestScope() : previous_(active_) { active_ = this; }
+  ~LayoutRequestScope() { active_ = previous_; }
+  LayoutRequestScope(LayoutRequestScope const&) = delete;
+  LayoutRequestScope& operator=(LayoutRequestScope const&) = delete;
+
+  static void request() {
+    if (active_) {
+      active_->requested_ = true;
+    }
+  }
+  bool requested() const { return requested_; }
+
+private:
+  LayoutRequestScope* previous_ = nullptr;
+  bool requested_ = false;
+  static inline thread_local LayoutRequestScope* active_ = nullptr;
+};
+
+using TimerId = uint64_t;
+inline constexpr TimerId InvalidTimerId = 0u;
+
+// Whether a fired timer changes what is on screen. StateOnly timers (click expiry) only reset
+// bookkeeping, so firing them must not cost a frame.
+enum class TimerEffect : uint8_t {
+  Repaint,
+  StateOnly,
+};
+
+// Deadline scheduler for widget-driven visual changes (cursor blink, click expiry). Timers live in
+// a min-heap ordered by deadline; cancellation drops the callback and lazily prunes the heap, so the
+// next deadline is always a live timer. Hosts sleep until nextDeadline() instead of polling.
+// The scheduler belongs to the UI thread. A background rebuild builds widgets on a worker, so the
+// worker holds a DeferScope: its schedule() and cancel() calls are queued under a lock and only
+// reach the heap when the UI thread calls adoptDeferred() at commit.
+class TimerScheduler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  class DeferScope {
+  public:
+    explicit DeferScope(TimerScheduler& scheduler) : previous_(deferring_) {
+      deferring_ = &scheduler;
+    }
+    ~DeferScope() { deferring_ = previous_; }
+    DeferScope(DeferScope const&) = delete;
+    DeferScope& operator=(DeferScope const&) = delete;
+
+  private:
+    TimerScheduler* previous_ = nullptr;
+  };
+
+  TimerId schedule(Clock::time_point deadline,
+                   std::function<void()> callback,
+                   TimerEffect effect = TimerEffect::Repaint) {
+    if (!callback) {
+      return InvalidTimerId;
+    }
+    TimerId id = nextId_.fetch_add(1u, std::memory_order_relaxed);
+    if (deferring_ == this) {
+      std::lock_guard<std::mutex> lock(deferredMutex_);
+      deferred_.push_back(Deferred{Entry{deadline, id}, Pending{std::move(callback), effect}});
+      return id;
+    }
+    insert(Entry{deadline, id}, Pending{std::move(callback), effect});
+    return id;
+  }
+
+  bool cancel(TimerId id) {
+    if (cancelDeferred(id)) {
+      return true;
+    }
+    if (deferring_ == this || callbacks_.erase(id) == 0u) {
+      return false;
+    }
+    pruneCancelled();
+    return true;
+  }
+
+  // Moves timers queued by a background build into the heap; UI thread only.
+  size_t adoptDeferred() {
+    std::vector<Deferred> adopted;
+    {
+      std::lock_guard<std::mutex> lock(deferredMutex_);
+      adopted.swap(deferred_);
+    }
+    for (Deferred& timer : adopted) {
+      insert(timer.entry, std::move(timer.pending));
+    }
+    return adopted.size();
+  }
+
+  [[nodiscard]] bool pending(TimerId id) const {
+    {
+      std::lock_guard<std::mutex> lock(deferredMutex_);
+      for (Deferred const& timer : deferred_) {
+        if (timer.entry.id == id) {
+          return true;
+        }
+      }
+    }
+    return deferring_ != this && callbacks_.find(id) != callbacks_.end();
+  }
+  // Live timers only; timers still queued by a background build are not counted until adopted.
+  [[nodiscard]] size_t pendingCount() const { return callbacks_.size(); }
+
+  [[nodiscard]] std::optional<Clock::time_point> nextDeadline() const {
+    if (heap_.empty()) {
+      return std::nullopt;
+    }
+    return heap_.front().deadline;
+  }
+
+  // Runs every timer due at `now`. Timers scheduled by callbacks wait for the next call, so a
+  // callback that re-arms itself cannot starve the caller.
+  size_t runDue(Clock::time_point now) {
+    lastRepaintCount_ = 0u;
+    std::vector<TimerId> due = std::move(dueScratch_);
+    due.clear();
+    while (!heap_.empty() && heap_.front().deadline <= now) {
+      std::pop_heap(heap_.begin(), heap_.end(), LaterEntry{});
+      due.push_back(heap_.back().id);
+      heap_.pop_back();
+    }
+    size_t fired = 0u;
+    for (TimerId id : due) {
+      auto it = callbacks_.find(id);
+      if (it == callbacks_.end()) {
+        continue;
+      }
+      Pending timer = std::move(it->second);
+      callbacks_.erase(it);
+      timer.callback();
+      fired += 1u;
+      if (timer.effect == TimerEffect::Repaint) {
+        lastRepaintCount_ += 1u;
+      }
+    }
+    pruneCancelled();
+    due.clear();
+    dueScratch_ = std::move(due);
+    return fired;
+  }
+
+  // Repaint timers fired by the last runDue(); StateOnly timers are excluded.
+  [[nodiscard]] size_t lastRepaintCount() const { return lastRepaintCount_; }
+
+  void clear() {
+    heap_.clear();
+    callbacks_.clear();
+    std::lock_guard<std::mutex> lock(deferredMutex_);
+    deferred_.clear();
+  }
+
+private:
+  struct Entry {
+    Clock::time_point deadline{};
+    TimerId id = InvalidTimerId;
+  };
+  struct Pending {
+    std::function<void()> callback;
+    TimerEffect effect = TimerEffect::Repaint;
+  };
+  struct Deferred {
+    Entry entry{};
+    Pending pending{};
+  };
+  struct LaterEntry {
+    bool operator()(Entry const& lhs, Entry const& rhs) const {
+      if (lhs.deadline != rhs.deadline) {
+        return lhs.deadline > rhs.deadline;
+      }
+      return lhs.id > rhs.id;
+    }
+  };
+
+  void insert(Entry entry, Pending pending) {
+    callbacks_.emplace(entry.id, std::move(pending));
+    heap_.push_back(entry);
+    std::push_heap(heap_.begin(), heap_.end(), LaterEntry{});
+  }
+
+  bool cancelDeferred(TimerId id) {
+    std::lock_guard<std::mutex> lock(deferredMutex_);
+    for (auto it = deferred_.begin(); it != deferred_.end(); ++it) {
+      if (it->entry.id == id) {
+        deferred_.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void pruneCancelled() {
+    while (!heap_.empty() && callbacks_.find(heap_.front().id) == callbacks_.end()) {
+      std::pop_heap(heap_.begin(), heap_.end(), LaterEntry{});
+      heap_.pop_back();
+    }
+  }
+
+  std::vector<Entry> heap_{};
+  std::unordered_map<TimerId, Pending> callbacks_{};
+  std::vector<TimerId> dueScratch_{};
+  std::atomic<TimerId> nextId_{1u};
+  size_t lastRepaintCount_ = 0u;
+  mutable std::mutex deferredMutex_{};
+  std::vector<Deferred> deferred_{};
+  static inline thread_local TimerScheduler* deferring_ = nullptr;
+};
+
+// Multi-producer, single-consumer queue for UI updates posted from worker threads. Producers push
+// with one CAS onto an intrusive stack; the UI thread takes the whole stack with one exchange and
+// replays it in post order. Keyed updates coalesce: only the newest update per key runs per drain.
+// Nodes keep the key text and drain compares it, so distinct keys never collapse into one.
+class PostedUpdateQueue {
+public:
+  PostedUpdateQueue() = default;
+  PostedUpdateQueue(PostedUpdateQueue const&) = delete;
+  PostedUpdateQueue& operator=(PostedUpdateQueue const&) = delete;
+  ~PostedUpdateQueue() {
+    Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+    while (node) {
+      Node* next = node->next;
+      delete node;
+      node = next;
+    }
+  }
+
+  // Safe from any thread. Returns true when the queue was empty, i.e. the consumer may be idle and
+  // needs a wake-up; later posts before the next drain return false.
+  bool push(std::function<void()> update) {
+    if (!update) {
+      return false;
+    }
+    return pushNode(new Node{std::move(update), {}, false, nullptr});
+  }
+
+  bool push(std::string_view key, std::function<void()> update) {
+    if (!update) {
+      return false;
+    }
+    return pushNode(new Node{std::move(update), std::string(key), true, nullptr});
+  }
+
+  [[nodiscard]] bool empty() const { return head_.load(std::memory_order_acquire) == nullptr; }
+
+  // Consumer thread only. Updates posted while draining run on the next drain.
+  size_t drain() {
+    Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+    if (!node) {
+      return 0u;
+    }
+    std::vector<std::unique_ptr<Node>> batch;
+    batch.swap(drainScratch_);
+    batch.clear();
+    seenKeys_.clear();
+    // The stack is newest-first: the first node seen for a key is the one that survives. Seen keys
+    // view the surviving nodes' strings, which stay put while `batch` owns them.
+    while (node) {
+      std::unique_ptr<Node> owned(node);
+      node = node->next;
+      if (owned->keyed && !seenKeys_.insert(std::string_view(owned->key)).second) {
+        continue;
+      }
+      batch.push_back(std::move(owned));
+    }
+    seenKeys_.clear();
+    size_t ran = 0u;
+    for (auto it = batch.rbegin(); it != batch.rend(); ++it) {
+      (*it)->update();
+      ran += 1u;
+    }
+    batch.clear();
+    drainScratch_.swap(batch);
+    return ran;
+  }
+
+private:
+  struct Node {
+    std::function<void()> update;
+    std::string key;
+    bool keyed = false;
+    Node* next = nullptr;
+  };
+
+  bool pushNode(Node* node) {
+    Node* head = head_.load(std::memory_order_relaxed);
+    do {
+      node->next = head;
+    } while (!head_.compare_exchange_weak(head, node,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+    return head == nullptr;
+  }
+
+  std::atomic<Node*> head_{nullptr};
+  std::vector<std::unique_ptr<Node>> drainScratch_{};
+  std::unordered_set<std::string_view> seenKeys_{};
 };
 
 } // namespace PrimeStage
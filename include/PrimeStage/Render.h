@@ -1,11 +1,20 @@
 #pragma once
 
+#include "PrimeFrame/Flatten.h"
 #include "PrimeFrame/Frame.h"
 #include "PrimeFrame/Layout.h"
 
+#include <condition_variable>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
 #include <span>
+#include <string>
 #include <string_view>
+#include <thread>
+#include <vector>
 
 namespace PrimeStage {
 
@@ -78,10 +87,12 @@ struct RenderStatus {
 
 [[nodiscard]] std::string_view renderStatusMessage(RenderStatusCode code);
 
+// `overlay` commands are drawn on top of the flattened frame; App passes its shared focus ring.
 [[nodiscard]] RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
                                                PrimeFrame::LayoutOutput const& layout,
                                                RenderTarget const& target,
-                                               RenderOptions const& options = {});
+                                               RenderOptions const& options = {},
+                                               std::span<PrimeFrame::DrawCommand const> overlay = {});
 
 [[nodiscard]] RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
                                                RenderTarget const& target,
@@ -90,10 +101,79 @@ struct RenderStatus {
 [[nodiscard]] RenderStatus renderFrameToPng(PrimeFrame::Frame& frame,
                                             PrimeFrame::LayoutOutput const& layout,
                                             std::string_view path,
-                                            RenderOptions const& options = {});
+                                            RenderOptions const& options = {},
+                                            std::span<PrimeFrame::DrawCommand const> overlay = {});
 
 [[nodiscard]] RenderStatus renderFrameToPng(PrimeFrame::Frame& frame,
                                             std::string_view path,
                                             RenderOptions const& options = {});
 
+// Frame-independent copy of everything needed to rasterize one frame. Text commands are rebound to
+// one snapshot-owned buffer, so a snapshot stays valid while the source frame is mutated or
+// rebuilt. Recycled snapshots keep the buffer's capacity, so steady-state capture does not
+// allocate for text. The buffer is a vector rather than a string because a string keeps short
+// text inline and a move would relocate it under the views; for the same reason snapshots are
+// move-only.
+struct RenderSnapshot {
+  RenderSnapshot() = default;
+  RenderSnapshot(RenderSnapshot&&) noexcept = default;
+  RenderSnapshot& operator=(RenderSnapshot&&) noexcept = default;
+  RenderSnapshot(RenderSnapshot const&) = delete;
+  RenderSnapshot& operator=(RenderSnapshot const&) = delete;
+
+  PrimeFrame::RenderBatch batch;
+  RenderOptions options{};
+  std::vector<char> textStorage;
+};
+
+void captureRenderSnapshot(PrimeFrame::Frame const& frame,
+                           PrimeFrame::LayoutOutput const& layout,
+                           RenderOptions const& options,
+                           RenderSnapshot& out);
+
+[[nodiscard]] RenderStatus renderSnapshotToTarget(RenderSnapshot const& snapshot,
+                                                  RenderTarget const& target);
+
+// Dedicated raster thread fed through a bounded queue. submit() blocks while `maxQueued` snapshots
+// are already waiting, which keeps the UI thread at most one or two frames ahead of the raster.
+// Completions run on the render thread; target pixels must stay valid until then.
+class RenderPipeline {
+public:
+  using Completion = std::function<void(RenderStatus const&)>;
+
+  explicit RenderPipeline(size_t maxQueued = 1u);
+  ~RenderPipeline();
+  RenderPipeline(RenderPipeline const&) = delete;
+  RenderPipeline& operator=(RenderPipeline const&) = delete;
+
+  // Returns a recycled snapshot so steady-state capture reuses batch and text storage.
+  [[nodiscard]] RenderSnapshot acquireSnapshot();
+  // Validates the target synchronously; raster status is reported through `onComplete`.
+  [[nodiscard]] RenderStatus submit(RenderSnapshot snapshot,
+                                    RenderTarget const& target,
+                                    Completion onComplete = {});
+  void waitIdle();
+  [[nodiscard]] size_t pending() const;
+  [[nodiscard]] size_t maxQueued() const { return maxQueued_; }
+
+private:
+  struct Job {
+    RenderSnapshot snapshot;
+    RenderTarget target{};
+    Completion onComplete;
+  };
+
+  void run();
+
+  mutable std::mutex mutex_;
+  std::condition_variable workAvailable_;
+  std::condition_variable queueChanged_;
+  std::deque<Job> queue_;
+  std::vector<RenderSnapshot> recycled_;
+  size_t maxQueued_ = 1u;
+  bool rendering_ = false;
+  bool stopping_ = false;
+  std::thread worker_;
+};
+
 } // namespace PrimeStage
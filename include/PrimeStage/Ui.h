@@ -1,18 +1,22 @@
 #pragma once
 
+#include "PrimeFrame/Flatten.h"
 #include "PrimeFrame/Frame.h"
+#include "PrimeFrame/Layout.h"
 
 #include <concepts>
 #include <chrono>
 #include <cstdint>
 #include <deque>
 #include <functional>
+#include <list>
 #include <memory>
 #include <optional>
 #include <span>
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <ranges>
@@ -25,6 +29,7 @@ struct LayoutOutput;
 namespace PrimeStage {
 
 struct TextSelectionLayout;
+class TimerScheduler;
 
 enum class CursorHint : uint8_t {
   Arrow,
@@ -389,6 +394,9 @@ struct TextFieldSpec : FocusableWidgetSpec {
   PrimeFrame::RectStyleToken selectionStyle = 0;
   PrimeFrame::RectStyleOverride selectionStyleOverride{};
   std::chrono::milliseconds cursorBlinkInterval{std::chrono::milliseconds(500)};
+  // Optional deadline scheduler (see App::applyPlatformServices). When set, the focused field
+  // drives its own cursor blink instead of relying on updateTextFieldBlink polling.
+  TimerScheduler* timers = nullptr;
   bool allowNewlines = false;
   bool handleClipboardShortcuts = true;
   bool setCursorToEndOnFocus = true;
@@ -729,6 +737,98 @@ struct TableColumn {
 struct TableRowInfo {
   int rowIndex = -1;
   std::span<const std::string_view> row{};
+  // From TableDataSource::rowKey; invalid for tables built from `rows`.
+  WidgetIdentityId key = InvalidWidgetIdentityId;
+};
+
+// Rows read in place from an app model; the table copies no cell text. The table keeps these
+// functions for its lifetime, so whatever they reference must outlive the frame it was built in.
+// The row count is read once per build.
+struct TableDataSource {
+  std::function<size_t()> rowCount;
+  // Text of `column` in `row`. Views need only stay valid until the next call; the table copies
+  // what it keeps.
+  std::function<std::string_view(size_t row, size_t column)> cell;
+  // Optional stable key per row, reported in TableRowInfo::key.
+  std::function<WidgetIdentityId(size_t row)> rowKey;
+};
+
+// How auto-sized columns (TableColumn::width == 0) are measured.
+struct TableAutoWidthPolicy {
+  // 0 measures every cell. Otherwise a column is sized from its header, its first `sampleRows`
+  // cells and the `longestCells` cells with the most bytes; the rest only have their length read.
+  size_t sampleRows = 0u;
+  size_t longestCells = 16u;
+  // Spreads columns of at least `parallelThreshold` rows over the build threads App attaches during
+  // rebuilds (App::setBuildThreadCount). TableDataSource::cell must then be safe to call from
+  // several threads.
+  bool parallel = false;
+  size_t parallelThreshold = 65536u;
+};
+
+// Auto-sized column widths kept across rebuilds of one table. While TableSpec::modelRevision is
+// unchanged the cached widths are reused without reading any cell. When it changes, only the rows
+// reported through rowsInserted and rowsUpdated since the previous build are measured. A column
+// whose widest cell was updated or removed is measured again, and so is every column when the
+// revision changes without a report or the row count disagrees with the reports.
+class TableColumnWidthCache {
+public:
+  void rowsInserted(size_t first, size_t count);
+  void rowsUpdated(size_t first, size_t count);
+  void rowsRemoved(size_t first, size_t count);
+  // Measures every column again on the next build, e.g. after the theme's text styles changed.
+  void invalidate();
+  [[nodiscard]] uint64_t revision() const { return revision_; }
+  // Cells whose text the last build measured.
+  [[nodiscard]] size_t measuredCellCount() const { return measuredCellCount_; }
+
+private:
+  friend class UiNode;
+
+  static constexpr size_t NoRow = static_cast<size_t>(-1);
+
+  struct Column {
+    std::string label;
+    PrimeFrame::TextStyleToken headerStyle = 0;
+    PrimeFrame::TextStyleToken cellStyle = 0;
+    float headerWidth = 0.0f;
+    float cellWidth = 0.0f;
+    size_t widestRow = NoRow;
+    bool dirty = true;
+  };
+
+  struct RowRange {
+    size_t begin = 0u;
+    size_t end = 0u;
+  };
+
+  // Widest header or cell text per column, 0 for fixed-width columns. Valid until the next call.
+  std::span<float const> measure(PrimeFrame::Frame& frame,
+                                 std::span<TableColumn const> columns,
+                                 TableAutoWidthPolicy const& policy,
+                                 uint64_t revision,
+                                 size_t rowCount,
+                                 std::function<std::string_view(size_t, size_t)> const& cell);
+
+  std::vector<Column> columns_;
+  // Rows inserted or updated since the last build, in current row indices.
+  std::vector<RowRange> pending_;
+  std::vector<float> widths_;
+  TableAutoWidthPolicy policy_{};
+  uint64_t revision_ = 0u;
+  // Row count of the last build, adjusted by the reported inserts and removals.
+  size_t rowCount_ = 0u;
+  size_t measuredCellCount_ = 0u;
+  bool valid_ = false;
+  bool reported_ = false;
+};
+
+struct TableScrollInfo {
+  float offset = 0.0f;
+  float maxOffset = 0.0f;
+  float progress = 0.0f;
+  float viewportHeight = 0.0f;
+  float contentHeight = 0.0f;
 };
 
 struct TableCallbacks {
@@ -736,6 +836,8 @@ struct TableCallbacks {
   std::function<void(TableRowInfo const&)> onSelect;
   // Legacy alias retained for compatibility.
   std::function<void(TableRowInfo const&)> onRowClicked;
+  // Fired when a virtualized table scrolls.
+  std::function<void(TableScrollInfo const&)> onScrollChanged;
 };
 
 struct ListRowInfo {
@@ -784,10 +886,26 @@ struct TableSpec : FocusableWidgetSpec {
   int selectedRow = -1;
   bool showHeaderDividers = true;
   bool showColumnDividers = true;
+  // Materialize only the rows inside the viewport (plus `overscanRows` above and below) and
+  // recycle their nodes as the table scrolls.
+  bool virtualized = false;
+  int overscanRows = 4;
+  // Initial scroll offset of a virtualized table; feed back onScrollChanged to keep it across
+  // rebuilds.
+  float scrollOffset = 0.0f;
   bool clipChildren = true;
   TableCallbacks callbacks{};
   std::vector<TableColumn> columns;
+  // Copied into the table so callback payloads outlive the caller's buffers; set `dataSource`
+  // instead to read rows in place.
   std::vector<std::vector<std::string_view>> rows;
+  // When `cell` is set, rows come from here and `rows` is ignored.
+  TableDataSource dataSource{};
+  // Optional app-owned cache for auto-sized columns; bump `modelRevision` whenever the rows change
+  // and report the change to the cache.
+  TableColumnWidthCache* widthCache = nullptr;
+  uint64_t modelRevision = 0u;
+  TableAutoWidthPolicy autoWidth{};
 };
 
 struct TreeNode {
@@ -795,10 +913,13 @@ struct TreeNode {
   std::vector<TreeNode> children;
   bool expanded = true;
   bool selected = false;
+  // Stable model key; lets TreeViewState remember expansion across rebuilds.
+  WidgetIdentityId key = InvalidWidgetIdentityId;
 };
 
 struct TreeViewRowInfo {
   int rowIndex = -1;
+  // Child indices from the root; only valid for the duration of the callback.
   std::span<const uint32_t> path{};
   bool hasChildren = false;
   bool expanded = false;
@@ -824,7 +945,96 @@ struct TreeViewCallbacks {
   std::function<void(TreeViewScrollInfo const&)> onScrollChanged;
 };
 
+// Expansion owned by a TreeView, keyed by TreeNode::key. Nodes without an entry start from
+// TreeNode::expanded.
+struct TreeViewState {
+  std::unordered_map<WidgetIdentityId, bool> expanded;
+};
+
+// Hierarchy enumerated on demand. `parent` is InvalidWidgetIdentityId for the roots; child keys
+// must be valid and unique, since they also key TreeViewState::expanded.
+struct TreeDataSource {
+  std::function<size_t(WidgetIdentityId parent)> childCount;
+  std::function<WidgetIdentityId(WidgetIdentityId parent, size_t index)> childKey;
+  std::function<std::string(WidgetIdentityId key)> label;
+  // Optional; without it every node shows a caret until its branch is loaded and found empty.
+  std::function<bool(WidgetIdentityId key)> hasChildren;
+  // Optional asynchronous enumeration. While it returns false the branch shows a single loading
+  // row and nothing is cached; call TreeDataProvider::invalidate(parent) and rebuild once the
+  // children are available.
+  std::function<bool(WidgetIdentityId parent)> childrenReady;
+  std::string loadingLabel = "Loading...";
+};
+
+// Branches loaded from a TreeDataSource, kept in a least-recently-used cache of up to
+// `branchCapacity` branches, or of every branch the last flatten visited when that is more. A
+// branch's child keys are enumerated the first time it is expanded; a child's label is fetched the
+// first time a row showing it is bound. Returned views stay valid until the next call that loads a
+// branch.
+class TreeDataProvider {
+public:
+  // Nothing is evicted while a scope is alive; the branches touched under it stay cached
+  // afterwards. Flattening a tree holds one, so it never reloads the branch it is walking.
+  class PinScope {
+  public:
+    explicit PinScope(TreeDataProvider& provider);
+    ~PinScope();
+    PinScope(PinScope const&) = delete;
+    PinScope& operator=(PinScope const&) = delete;
+
+  private:
+    TreeDataProvider& provider_;
+  };
+
+  explicit TreeDataProvider(TreeDataSource source, size_t branchCapacity = 256u);
+
+  // std::nullopt while the source reports the branch as still loading.
+  [[nodiscard]] std::optional<size_t> childCount(WidgetIdentityId parent);
+  [[nodiscard]] WidgetIdentityId childKey(WidgetIdentityId parent, size_t index);
+  [[nodiscard]] std::string_view childLabel(WidgetIdentityId parent, size_t index);
+  [[nodiscard]] bool childHasChildren(WidgetIdentityId parent, size_t index);
+  [[nodiscard]] std::string_view loadingLabel() const { return source_.loadingLabel; }
+  // Drops a cached branch so it is enumerated again, e.g. after an asynchronous load finished.
+  void invalidate(WidgetIdentityId parent);
+  void clear();
+  [[nodiscard]] size_t branchCapacity() const { return branchCapacity_; }
+  [[nodiscard]] size_t cachedBranchCount() const { return branches_.size(); }
+  // Number of branches enumerated from the source so far, including reloads after eviction.
+  [[nodiscard]] size_t loadCount() const { return loadCount_; }
+
+private:
+  struct Branch {
+    std::vector<WidgetIdentityId> keys;
+    std::vector<std::optional<std::string>> labels;
+    // -1 until known.
+    std::vector<int8_t> hasChildren;
+    std::list<WidgetIdentityId>::iterator use;
+    uint64_t pinEpoch = 0u;
+  };
+
+  Branch* branch(WidgetIdentityId parent);
+  void touch(Branch& branch);
+  void trim(size_t limit);
+
+  TreeDataSource source_;
+  size_t branchCapacity_ = 0u;
+  std::unordered_map<WidgetIdentityId, Branch> branches_;
+  // Most recently used first.
+  std::list<WidgetIdentityId> useOrder_;
+  size_t pinDepth_ = 0u;
+  uint64_t pinEpoch_ = 0u;
+  size_t pinnedCount_ = 0u;
+  size_t retainedCount_ = 0u;
+  size_t loadCount_ = 0u;
+};
+
 struct TreeViewSpec : FocusableWidgetSpec {
+  // When set, expand/collapse is applied in place by splicing rows into the recycled row window
+  // (as if `virtualized`) and recorded here; onExpandedChanged becomes a notification.
+  TreeViewState* state = nullptr;
+  // With `state`, rows are enumerated from the provider instead of `nodes`: only expanded
+  // branches are loaded and only bound rows fetch their labels. Branches start collapsed.
+  TreeDataProvider* provider = nullptr;
   float rowStartX = 8.0f;
   float rowStartY = 36.0f;
   float rowWidthInset = 20.0f;
@@ -840,12 +1050,18 @@ struct TreeViewSpec : FocusableWidgetSpec {
   float linkEndInset = 4.0f;
   float selectionAccentWidth = 3.0f;
   float doubleClickMs = 350.0f;
+  // Optional deadline scheduler used to expire pending double-click state.
+  TimerScheduler* timers = nullptr;
   bool keyboardNavigation = true;
   bool showHeaderDivider = false;
   float headerDividerY = 0.0f;
   bool showConnectors = true;
   bool showCaretMasks = true;
   bool showScrollBar = true;
+  // Materialize only the rows inside the viewport (plus `overscanRows` above and below) and
+  // recycle their nodes as the tree scrolls.
+  bool virtualized = false;
+  int overscanRows = 4;
   bool clipChildren = true;
   bool visible = true;
   PrimeFrame::RectStyleToken rowStyle = 0;
@@ -1173,7 +1389,8 @@ TreeModelAdapter makeTreeModel(NodeRange const& nodes,
     node.label = adapter.ownedLabels_.back();
     node.expanded = static_cast<bool>(std::invoke(expandedOf, nodeValue));
     node.selected = static_cast<bool>(std::invoke(selectedOf, nodeValue));
-    adapter.nodeKeys_.push_back(detail::resolveModelKey(keyOf, nodeValue));
+    node.key = detail::resolveModelKey(keyOf, nodeValue);
+    adapter.nodeKeys_.push_back(node.key);
 
     auto const& children = std::invoke(childrenOf, nodeValue);
     for (auto const& childValue : children) {
@@ -1379,6 +1596,191 @@ private:
   std::optional<WidgetIdentityId> pendingFocusedIdentityId_;
 };
 
+class UiNode;
+
+// Retains UiNode::memo subtrees across rebuilds of the same frame. beginRebuild detaches the cached
+// subtrees and clears everything else under the root; memo calls whose dependency hash is unchanged
+// re-attach the cached nodes (with their primitives and callbacks) instead of running the builder,
+// and endRebuild destroys cached subtrees that were not requested again.
+class UiMemoCache {
+public:
+  UiMemoCache() = default;
+  UiMemoCache(UiMemoCache const&) = delete;
+  UiMemoCache& operator=(UiMemoCache const&) = delete;
+  ~UiMemoCache();
+
+  void beginRebuild(PrimeFrame::Frame& frame, PrimeFrame::NodeId rootId);
+  void endRebuild();
+  // Forgets cached subtrees without touching the frame, e.g. after the frame was replaced.
+  void clear();
+  [[nodiscard]] bool empty() const { return entries_.empty(); }
+  [[nodiscard]] size_t size() const { return entries_.size(); }
+  [[nodiscard]] size_t reusedCount() const { return reusedCount_; }
+
+private:
+  friend class UiNode;
+
+  struct Entry {
+    uint64_t dependencyHash = 0u;
+    std::vector<PrimeFrame::NodeId> nodes;
+    WidgetIdentityId parentKey = InvalidWidgetIdentityId;
+    bool used = false;
+  };
+
+  void memo(UiNode& parent,
+            WidgetIdentityId key,
+            uint64_t dependencyHash,
+            std::function<void(UiNode&)> const& builder);
+  void detach(Entry const& entry);
+  void destroy(Entry const& entry);
+  void release(WidgetIdentityId key);
+  void markNestedUsed(WidgetIdentityId key);
+
+  PrimeFrame::Frame* frame_ = nullptr;
+  std::unordered_map<WidgetIdentityId, Entry> entries_;
+  std::vector<WidgetIdentityId> buildStack_;
+  size_t reusedCount_ = 0u;
+  UiMemoCache* previousActive_ = nullptr;
+  bool active_ = false;
+};
+
+// Runs the readability pass UiNode construction applies to a frame's default theme: a palette or
+// base text style that would leave default text unreadable on the default fill is patched. Themes
+// edited outside a rebuild (App::setTheme) call it directly.
+void ensureReadableTheme(PrimeFrame::Frame& frame);
+
+// Text styles of a frame's default theme, resolved once per token. While a table is attached to
+// the building thread (beginBuild/endBuild; App attaches one around rebuilds), text measurement and
+// line-height lookups index into it instead of resolving the theme on every call. The table
+// compiles lazily on first lookup, so theme edits made before any text is measured are picked up;
+// call invalidate() after editing text styles in place mid-build.
+class ThemeStyleTable {
+public:
+  struct TextEntry {
+    PrimeFrame::ResolvedTextStyle style{};
+    float lineHeight = 0.0f;
+  };
+
+  ThemeStyleTable() = default;
+  ThemeStyleTable(ThemeStyleTable const&) = delete;
+  ThemeStyleTable& operator=(ThemeStyleTable const&) = delete;
+  ~ThemeStyleTable();
+
+  void beginBuild(PrimeFrame::Frame& frame);
+  void endBuild();
+  void invalidate() { compiled_ = false; }
+  // Entry for `token`, or nullptr when the frame has no default theme or the token is unknown.
+  [[nodiscard]] TextEntry const* text(PrimeFrame::TextStyleToken token);
+  [[nodiscard]] PrimeFrame::Frame const* frame() const { return frame_; }
+  [[nodiscard]] size_t compileCount() const { return compileCount_; }
+
+private:
+  void compile(PrimeFrame::Theme const& theme);
+
+  PrimeFrame::Frame* frame_ = nullptr;
+  PrimeFrame::Theme const* theme_ = nullptr;
+  PrimeFrame::TextStyle const* textStyles_ = nullptr;
+  size_t textStyleCount_ = 0u;
+  std::vector<TextEntry> text_;
+  size_t compileCount_ = 0u;
+  bool compiled_ = false;
+  ThemeStyleTable* previousActive_ = nullptr;
+  bool active_ = false;
+};
+
+// Focus ring shared by every focusable widget built while it is attached to the building thread
+// (beginBuild/endBuild; App attaches one around rebuilds). Widgets register their ring rect and
+// style through focus/blur handlers instead of each carrying an overlay node with four rect
+// primitives, so a focus change only retargets the ring. appendDrawCommands() positions the ring
+// from the focused node's LayoutOut when the frame is rendered. Widgets built without an attached
+// ring keep their own overlay nodes. Handlers capture the ring, not the frame, so a frame moved
+// into place (a background rebuild) keeps drawing through the ring it was built with; the owner
+// uses one ring per frame and clear()s it when that frame is replaced.
+class FocusRing {
+public:
+  struct Target {
+    PrimeFrame::NodeId node{};
+    // Ring bounds relative to the node's layout origin.
+    float x = 0.0f;
+    float y = 0.0f;
+    float width = 0.0f;
+    float height = 0.0f;
+    PrimeFrame::RectStyleToken token = 0;
+    PrimeFrame::RectStyleOverride overrideStyle{};
+  };
+
+  FocusRing() = default;
+  FocusRing(FocusRing const&) = delete;
+  FocusRing& operator=(FocusRing const&) = delete;
+  ~FocusRing();
+
+  void beginBuild();
+  void endBuild();
+  void show(Target const& target) { target_ = target; }
+  void hide(PrimeFrame::NodeId node);
+  void clear() { target_.reset(); }
+  [[nodiscard]] std::optional<Target> const& target() const { return target_; }
+  // Appends the ring edges when `focusedNode` is the shown target and it was laid out visible.
+  // Edges are clipped by clipping ancestors exactly like the overlay nodes they replace.
+  void appendDrawCommands(PrimeFrame::Frame& frame,
+                          PrimeFrame::LayoutOutput const& layout,
+                          PrimeFrame::NodeId focusedNode,
+                          std::vector<PrimeFrame::DrawCommand>& out) const;
+
+private:
+  std::optional<Target> target_;
+  FocusRing* previousActive_ = nullptr;
+  bool active_ = false;
+};
+
+// Resumable construction work for progressive builds. While a queue is active for a frame,
+// UiNode::deferred queues its builder instead of running it; run() then drains queued sections in
+// FIFO order until a time budget is spent, so a large UI fills in over several frames.
+class ProgressiveBuildQueue {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  ProgressiveBuildQueue() = default;
+  ProgressiveBuildQueue(ProgressiveBuildQueue const&) = delete;
+  ProgressiveBuildQueue& operator=(ProgressiveBuildQueue const&) = delete;
+  ~ProgressiveBuildQueue();
+
+  // Drops sections queued for a previous frame and starts collecting for `frame`.
+  void begin(PrimeFrame::Frame& frame);
+  void end();
+  // Runs queued sections until `budget` is spent; always runs at least one so construction makes
+  // progress under any budget. Sections deferred by a running section are appended to the queue.
+  size_t run(Clock::duration budget);
+  void clear();
+  [[nodiscard]] bool pending() const { return !jobs_.empty(); }
+  [[nodiscard]] size_t pendingCount() const { return jobs_.size(); }
+
+private:
+  friend class UiNode;
+
+  struct Job {
+    PrimeFrame::NodeId section{};
+    bool allowAbsolute = false;
+    std::function<void(UiNode&)> builder;
+  };
+
+  void activate();
+  void deactivate();
+
+  PrimeFrame::Frame* frame_ = nullptr;
+  std::deque<Job> jobs_;
+  ProgressiveBuildQueue* previousActive_ = nullptr;
+  bool active_ = false;
+};
+
+// One independent section for UiNode::prepareInParallel. `prepare` does the frame-free work (data
+// shaping, sorting, formatting) and may run on any thread; `build` adds the section's nodes and
+// runs serially on the building thread in declaration order, so the tree matches a serial build.
+struct ParallelSection {
+  std::function<void()> prepare;
+  std::function<void(UiNode&)> build;
+};
+
 struct ScrollView;
 struct Window;
 
@@ -1451,6 +1853,23 @@ public:
   UiNode& setVisible(bool visible);
   UiNode& setSize(SizeSpec const& size);
   UiNode& setHitTestVisible(bool visible);
+  // Memoized section keyed by `key`: when `dependencyHash` matches the previous rebuild, the children
+  // the builder added last time are re-attached as-is and `builder` is skipped. Reuse needs an active
+  // UiMemoCache for this frame (App provides one); otherwise the builder always runs. Builders should
+  // only add children to the node they receive.
+  UiNode& memo(std::string_view key,
+               uint64_t dependencyHash,
+               std::function<void(UiNode&)> const& builder);
+  // Progressive section: creates a stack from `placeholder` and fills it with `builder`. Under an
+  // active ProgressiveBuildQueue (App progressive builds) the builder runs on a later frame and the
+  // empty stack is laid out as a placeholder until then; otherwise it runs immediately. Deferred
+  // builders outlive the rebuild closure, so they must not capture its locals by reference.
+  UiNode deferred(StackSpec const& placeholder, std::function<void(UiNode&)> builder);
+  // Runs the `prepare` steps of `sections` concurrently on the build threads App attaches during
+  // rebuilds (App::setBuildThreadCount), then runs every `build` step serially on this thread in
+  // order. Only data preparation is parallel: widgets capture their frame and node ids, so node
+  // creation stays on the building thread.
+  UiNode& prepareInParallel(std::span<ParallelSection const> sections);
   template <typename Fn>
   UiNode with(Fn&& fn) {
     std::forward<Fn>(fn)(*this);
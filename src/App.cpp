@@ -1,7 +1,10 @@
 #include "PrimeStage/App.h"
 
+#include "PrimeStageBuildTaskPool.h"
+
 #include <algorithm>
 #include <cmath>
+#include <exception>
 #include <span>
 #include <utility>
 
@@ -31,6 +34,85 @@ int32_t round_to_i32(float value) {
   return static_cast<int32_t>(std::lround(value));
 }
 
+void configure_rebuild_root(PrimeFrame::Frame& frame, PrimeFrame::NodeId rootId) {
+  if (PrimeFrame::Node* rootNode = frame.getNode(rootId)) {
+    rootNode->layout = PrimeFrame::LayoutType::Overlay;
+    rootNode->visible = true;
+    rootNode->clipChildren = true;
+    rootNode->hitTestVisible = false;
+  }
+}
+
+PrimeFrame::NodeId create_rebuild_root(PrimeFrame::Frame& frame) {
+  PrimeFrame::NodeId rootId = frame.createNode();
+  frame.addRoot(rootId);
+  configure_rebuild_root(frame, rootId);
+  return rootId;
+}
+
+void apply_theme_tables(PrimeFrame::Frame& frame, PrimeFrame::Theme const& source) {
+  if (PrimeFrame::Theme* target = frame.getTheme(PrimeFrame::DefaultThemeId)) {
+    target->name = source.name;
+    target->palette = source.palette;
+    target->rectStyles = source.rectStyles;
+    target->textStyles = source.textStyles;
+  }
+}
+
+bool same_text_metrics(PrimeFrame::Theme const& lhs, PrimeFrame::Theme const& rhs) {
+  if (lhs.textStyles.size() != rhs.textStyles.size()) {
+    return false;
+  }
+  for (size_t index = 0u; index < lhs.textStyles.size(); ++index) {
+    auto token = static_cast<PrimeFrame::TextStyleToken>(index);
+    PrimeFrame::ResolvedTextStyle a = PrimeFrame::resolveTextStyle(lhs, token, {});
+    PrimeFrame::ResolvedTextStyle b = PrimeFrame::resolveTextStyle(rhs, token, {});
+    if (a.size != b.size || a.weight != b.weight || a.lineHeight != b.lineHeight ||
+        a.tracking != b.tracking || a.slant != b.slant) {
+      return false;
+    }
+  }
+  return true;
+}
+
+struct MemoRebuildScope {
+  UiMemoCache& cache;
+  ~MemoRebuildScope() { cache.endRebuild(); }
+};
+
+struct BuildPoolScope {
+  explicit BuildPoolScope(Internal::BuildTaskPool& target) : pool(target) { pool.beginBuild(); }
+  ~BuildPoolScope() { pool.endBuild(); }
+  Internal::BuildTaskPool& pool;
+};
+
+struct StyleTableScope {
+  StyleTableScope(ThemeStyleTable& target, PrimeFrame::Frame& frame) : table(target) {
+    table.beginBuild(frame);
+  }
+  ~StyleTableScope() { table.endBuild(); }
+  ThemeStyleTable& table;
+};
+
+struct FocusRingScope {
+  explicit FocusRingScope(FocusRing& target) : ring(target) { ring.beginBuild(); }
+  ~FocusRingScope() { ring.endBuild(); }
+  FocusRing& ring;
+};
+
+struct ProgressiveBuildScope {
+  ProgressiveBuildQueue* queue;
+  ~ProgressiveBuildScope() {
+    if (queue) {
+      queue->end();
+    }
+  }
+};
+
+uint64_t shortcut_key(uint32_t keyCode, PrimeHost::KeyModifierMask modifiers) {
+  return (static_cast<uint64_t>(keyCode) << 32u) | static_cast<uint64_t>(modifiers);
+}
+
 } // namespace
 
 void App::setPlatformServices(AppPlatformServices const& services) {
@@ -38,6 +120,9 @@ void App::setPlatformServices(AppPlatformServices const& services) {
 }
 
 void App::applyPlatformServices(TextFieldSpec& spec) const {
+  if (!spec.timers) {
+    spec.timers = &timers_;
+  }
   if (!spec.clipboard.setText && platformServices_.textFieldClipboard.setText) {
     spec.clipboard.setText = platformServices_.textFieldClipboard.setText;
   }
@@ -57,6 +142,12 @@ void App::applyPlatformServices(TextFieldSpec& spec) const {
   }
 }
 
+void App::applyPlatformServices(TreeViewSpec& spec) const {
+  if (!spec.timers) {
+    spec.timers = &timers_;
+  }
+}
+
 void App::applyPlatformServices(SelectableTextSpec& spec) const {
   if (!spec.clipboard.setText && platformServices_.selectableTextClipboard.setText) {
     spec.clipboard.setText = platformServices_.selectableTextClipboard.setText;
@@ -74,6 +165,21 @@ void App::applyPlatformServices(SelectableTextSpec& spec) const {
   }
 }
 
+std::optional<TimerScheduler::Clock::time_point> App::nextWakeDeadline() const {
+  if (lifecycle_.framePending() || buildQueue_.pending()) {
+    return TimerScheduler::Clock::now();
+  }
+  return timers_.nextDeadline();
+}
+
+std::size_t App::runDueTimers(TimerScheduler::Clock::time_point now) {
+  std::size_t fired = timers_.runDue(now);
+  if (timers_.lastRepaintCount() > 0u) {
+    lifecycle_.requestFrame();
+  }
+  return fired;
+}
+
 void App::connectHostServices(PrimeHost::Host& host, PrimeHost::SurfaceId surfaceId) {
   AppPlatformServices services = platformServices_;
 
@@ -108,6 +214,13 @@ void App::connectHostServices(PrimeHost::Host& host, PrimeHost::SurfaceId surfac
     }
     (void)host.setImeCompositionRect(surfaceId, x, y, width, height);
   };
+  // requestFrame doubles as the host wake primitive so worker posts interrupt waitEvents().
+  services.onPostedUpdate = [&host, surfaceId]() {
+    if (!surfaceId.isValid()) {
+      return;
+    }
+    (void)host.requestFrame(surfaceId, false);
+  };
   setPlatformServices(services);
 }
 
@@ -116,31 +229,47 @@ void App::clearHostServices() {
   platformServices_.selectableTextClipboard = {};
   platformServices_.onCursorHintChanged = {};
   platformServices_.onImeCompositionRectChanged = {};
+  platformServices_.onPostedUpdate = {};
 }
 
-App::ActionEntry* App::findAction(std::string_view actionId) {
-  auto it = std::find_if(actions_.begin(), actions_.end(), [actionId](ActionEntry const& entry) {
-    return entry.id == actionId;
-  });
-  return it == actions_.end() ? nullptr : &*it;
-}
-
-App::ActionEntry const* App::findAction(std::string_view actionId) const {
-  auto it = std::find_if(actions_.begin(), actions_.end(), [actionId](ActionEntry const& entry) {
-    return entry.id == actionId;
-  });
-  return it == actions_.end() ? nullptr : &*it;
+std::optional<uint32_t> App::findActionSlot(std::string_view actionId) const {
+  auto it = actionSlots_.find(actionId);
+  if (it == actionSlots_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
 }
 
 bool App::registerAction(std::string_view actionId, AppActionCallback callback) {
   if (actionId.empty() || !callback) {
     return false;
   }
-  if (ActionEntry* existing = findAction(actionId)) {
-    existing->callback = std::move(callback);
+  if (std::optional<uint32_t> existing = findActionSlot(actionId)) {
+    ActionEntry& entry = actions_[*existing];
+    if (entry.invokeDepth > 0u) {
+      // Replacing a callback from inside its own invocation is applied once it returns.
+      entry.pendingCallback = std::move(callback);
+    } else {
+      entry.callback = std::move(callback);
+    }
     return true;
   }
-  actions_.push_back(ActionEntry{std::string(actionId), std::move(callback)});
+  uint32_t slot = 0u;
+  if (!freeActionSlots_.empty()) {
+    slot = freeActionSlots_.back();
+    freeActionSlots_.pop_back();
+  } else {
+    slot = static_cast<uint32_t>(actions_.size());
+    actions_.emplace_back();
+  }
+  ActionEntry& entry = actions_[slot];
+  entry.id = std::string(actionId);
+  entry.callback = std::move(callback);
+  entry.invocation = AppActionInvocation{};
+  entry.invocation.actionId = entry.id;
+  entry.active = true;
+  // Deque slots never move, so the map can key on a view of the interned id.
+  actionSlots_.emplace(std::string_view(entry.id), slot);
   return true;
 }
 
@@ -148,67 +277,140 @@ bool App::unregisterAction(std::string_view actionId) {
   if (actionId.empty()) {
     return false;
   }
-  auto it = std::find_if(actions_.begin(), actions_.end(), [actionId](ActionEntry const& entry) {
-    return entry.id == actionId;
-  });
-  if (it == actions_.end()) {
+  auto it = actionSlots_.find(actionId);
+  if (it == actionSlots_.end()) {
     return false;
   }
-  actions_.erase(it);
-  shortcutBindings_.erase(
-      std::remove_if(shortcutBindings_.begin(),
-                     shortcutBindings_.end(),
-                     [actionId](ShortcutEntry const& entry) {
-                       return entry.actionId == actionId;
-                     }),
-      shortcutBindings_.end());
+  uint32_t slot = it->second;
+  actionSlots_.erase(it);
+  ActionEntry& entry = actions_[slot];
+  for (uint64_t key : entry.shortcutKeys) {
+    auto bucket = shortcutBindings_.find(key);
+    if (bucket == shortcutBindings_.end()) {
+      continue;
+    }
+    std::vector<ShortcutEntry>& bindings = bucket->second;
+    bindings.erase(std::remove_if(bindings.begin(),
+                                  bindings.end(),
+                                  [slot](ShortcutEntry const& binding) {
+                                    return binding.actionSlot == slot;
+                                  }),
+                   bindings.end());
+    if (bindings.empty()) {
+      shortcutBindings_.erase(bucket);
+    }
+  }
+  entry.shortcutKeys.clear();
+  entry.active = false;
+  if (entry.invokeDepth == 0u) {
+    settleActionSlot(slot);
+  }
   return true;
 }
 
+void App::settleActionSlot(uint32_t slot) {
+  ActionEntry& entry = actions_[slot];
+  if (entry.pendingCallback) {
+    entry.callback = std::move(entry.pendingCallback);
+    entry.pendingCallback = {};
+  }
+  if (entry.active) {
+    return;
+  }
+  entry.id.clear();
+  entry.callback = {};
+  entry.pendingCallback = {};
+  entry.invocation = AppActionInvocation{};
+  freeActionSlots_.push_back(slot);
+}
+
+void App::releaseShortcutKey(uint32_t slot, uint64_t key) {
+  std::vector<uint64_t>& keys = actions_[slot].shortcutKeys;
+  auto it = std::find(keys.begin(), keys.end(), key);
+  if (it != keys.end()) {
+    *it = keys.back();
+    keys.pop_back();
+  }
+}
+
 bool App::bindShortcut(AppShortcut const& shortcut, std::string_view actionId) {
-  if (actionId.empty() || !findAction(actionId)) {
+  if (actionId.empty()) {
     return false;
   }
-  auto it = std::find_if(shortcutBindings_.begin(),
-                         shortcutBindings_.end(),
-                         [&](ShortcutEntry const& entry) {
-                           return entry.shortcut == shortcut;
-                         });
-  if (it != shortcutBindings_.end()) {
-    it->actionId = std::string(actionId);
+  std::optional<uint32_t> slot = findActionSlot(actionId);
+  if (!slot) {
+    return false;
+  }
+  uint64_t key = shortcut_key(hostKeyCode(shortcut.key), shortcut.modifiers);
+  std::vector<ShortcutEntry>& bindings = shortcutBindings_[key];
+  auto it = std::find_if(bindings.begin(), bindings.end(), [&](ShortcutEntry const& entry) {
+    return entry.shortcut == shortcut;
+  });
+  if (it != bindings.end()) {
+    if (it->actionSlot != *slot) {
+      releaseShortcutKey(it->actionSlot, key);
+      it->actionSlot = *slot;
+      actions_[*slot].shortcutKeys.push_back(key);
+    }
     return true;
   }
-  shortcutBindings_.push_back(ShortcutEntry{shortcut, std::string(actionId)});
+  bindings.push_back(ShortcutEntry{shortcut, *slot});
+  actions_[*slot].shortcutKeys.push_back(key);
   return true;
 }
 
 bool App::unbindShortcut(AppShortcut const& shortcut) {
-  auto it = std::find_if(shortcutBindings_.begin(),
-                         shortcutBindings_.end(),
-                         [&](ShortcutEntry const& entry) {
-                           return entry.shortcut == shortcut;
-                         });
-  if (it == shortcutBindings_.end()) {
+  uint64_t key = shortcut_key(hostKeyCode(shortcut.key), shortcut.modifiers);
+  auto bucket = shortcutBindings_.find(key);
+  if (bucket == shortcutBindings_.end()) {
     return false;
   }
-  shortcutBindings_.erase(it);
+  std::vector<ShortcutEntry>& bindings = bucket->second;
+  auto it = std::find_if(bindings.begin(), bindings.end(), [&](ShortcutEntry const& entry) {
+    return entry.shortcut == shortcut;
+  });
+  if (it == bindings.end()) {
+    return false;
+  }
+  releaseShortcutKey(it->actionSlot, key);
+  bindings.erase(it);
+  if (bindings.empty()) {
+    shortcutBindings_.erase(bucket);
+  }
   return true;
 }
 
 bool App::invokeAction(std::string_view actionId,
                        AppActionSource source,
                        std::optional<AppShortcut> shortcut) {
-  ActionEntry* action = findAction(actionId);
-  if (!action) {
+  std::optional<uint32_t> slot = findActionSlot(actionId);
+  if (!slot) {
     return false;
   }
-  std::string actionIdCopy = action->id;
-  AppActionCallback callback = action->callback;
-  AppActionInvocation invocation;
-  invocation.actionId = std::move(actionIdCopy);
-  invocation.source = source;
-  invocation.shortcut = shortcut;
-  callback(invocation);
+  return invokeActionSlot(*slot, source, shortcut);
+}
+
+bool App::invokeActionSlot(uint32_t slot,
+                           AppActionSource source,
+                           std::optional<AppShortcut> const& shortcut) {
+  ActionEntry& action = actions_[slot];
+  // The callback is invoked in place. Unregistering or replacing it from inside the callback is
+  // deferred by invokeDepth, and nested invocations get their own payload so the outer one stays
+  // intact.
+  AppActionInvocation nestedInvocation;
+  AppActionInvocation* invocation = &action.invocation;
+  if (action.invokeDepth > 0u) {
+    nestedInvocation.actionId = action.id;
+    invocation = &nestedInvocation;
+  }
+  invocation->source = source;
+  invocation->shortcut = shortcut;
+  action.invokeDepth += 1u;
+  action.callback(*invocation);
+  action.invokeDepth -= 1u;
+  if (action.invokeDepth == 0u) {
+    settleActionSlot(slot);
+  }
   lifecycle_.requestFrame();
   return true;
 }
@@ -226,24 +428,19 @@ bool App::dispatchShortcut(PrimeHost::KeyEvent const& event) {
   if (!event.pressed) {
     return false;
   }
-  auto it = std::find_if(shortcutBindings_.begin(),
-                         shortcutBindings_.end(),
-                         [&](ShortcutEntry const& entry) {
-                           if (hostKeyCode(entry.shortcut.key) != event.keyCode) {
-                             return false;
-                           }
-                           if (entry.shortcut.modifiers != event.modifiers) {
-                             return false;
-                           }
-                           if (event.repeat && !entry.shortcut.allowRepeat) {
-                             return false;
-                           }
-                           return true;
-                         });
-  if (it == shortcutBindings_.end()) {
+  auto bucket = shortcutBindings_.find(shortcut_key(event.keyCode, event.modifiers));
+  if (bucket == shortcutBindings_.end()) {
     return false;
   }
-  return invokeAction(it->actionId, AppActionSource::Shortcut, it->shortcut);
+  for (ShortcutEntry const& entry : bucket->second) {
+    if (event.repeat && !entry.shortcut.allowRepeat) {
+      continue;
+    }
+    // Copy the small binding so the action may rebind shortcuts while it runs.
+    ShortcutEntry matched = entry;
+    return invokeActionSlot(matched.actionSlot, AppActionSource::Shortcut, matched.shortcut);
+  }
+  return false;
 }
 
 void App::setSurfaceMetrics(uint32_t width, uint32_t height, float scale) {
@@ -270,24 +467,211 @@ void App::setRenderMetrics(uint32_t width, uint32_t height, float scale) {
   lifecycle_.requestLayout();
 }
 
+App::App() : buildPool_(std::make_unique<Internal::BuildTaskPool>()) {}
+
+App::~App() {
+  renderPipeline_.reset();
+  if (backgroundRebuild_ && backgroundRebuild_->worker.joinable()) {
+    backgroundRebuild_->worker.join();
+  }
+}
+
+void App::post(std::function<void()> update) {
+  if (postedUpdates_.push(std::move(update)) && platformServices_.onPostedUpdate) {
+    platformServices_.onPostedUpdate();
+  }
+}
+
+void App::post(std::string_view key, std::function<void()> update) {
+  if (postedUpdates_.push(key, std::move(update)) && platformServices_.onPostedUpdate) {
+    platformServices_.onPostedUpdate();
+  }
+}
+
+std::size_t App::drainPostedUpdates() {
+  std::size_t ran = postedUpdates_.drain();
+  if (ran > 0u) {
+    lifecycle_.requestRebuild();
+  }
+  return ran;
+}
+
 bool App::runRebuildIfNeeded(std::function<void(UiNode)> const& rebuildUi) {
-  if (!lifecycle_.rebuildPending()) {
+  (void)drainPostedUpdates();
+  // A synchronous rebuild must not race a background one; its request stays pending until the
+  // background frame has been swapped in.
+  if (lifecycle_.rebuildInFlight()) {
     return false;
   }
-  frame_ = PrimeFrame::Frame();
+  if (!lifecycle_.rebuildPending()) {
+    return runProgressiveBuildStep();
+  }
   router_.clearAllCaptures();
+  if (buildQueue_.pending()) {
+    // Unfinished sections belong to the old tree, and memoized subtrees may still hold their
+    // empty placeholders; start from a fresh frame.
+    buildQueue_.clear();
+    memoCache_.clear();
+  }
+
+  auto const buildStart = ProgressiveBuildQueue::Clock::now();
+  bool const progressive = progressiveBuildBudget_.count() > 0;
+  PrimeFrame::NodeId rootId{};
+  if (!memoCache_.empty() && !frame_.roots().empty()) {
+    // Retained rebuild: keep the frame so memoized subtrees survive; the cache clears the rest.
+    rootId = frame_.roots().front();
+    configure_rebuild_root(frame_, rootId);
+  } else {
+    frame_ = PrimeFrame::Frame();
+    focusRing_->clear();
+    if (theme_) {
+      apply_theme_tables(frame_, *theme_);
+    }
+    rootId = create_rebuild_root(frame_);
+  }
+  memoCache_.beginRebuild(frame_, rootId);
+  if (progressive) {
+    buildQueue_.begin(frame_);
+  }
+  {
+    MemoRebuildScope memoScope{memoCache_};
+    ProgressiveBuildScope buildScope{progressive ? &buildQueue_ : nullptr};
+    BuildPoolScope poolScope{*buildPool_};
+    StyleTableScope styleScope{styleTable_, frame_};
+    FocusRingScope ringScope{*focusRing_};
+    rebuildUi(UiNode(frame_, rootId, true));
+  }
+  lifecycle_.markRebuildComplete();
+  if (buildQueue_.pending()) {
+    // Spend whatever the closure left of this frame's budget on deferred sections.
+    auto const elapsed = ProgressiveBuildQueue::Clock::now() - buildStart;
+    if (elapsed < progressiveBuildBudget_) {
+      BuildPoolScope poolScope{*buildPool_};
+      StyleTableScope styleScope{styleTable_, frame_};
+      FocusRingScope ringScope{*focusRing_};
+      (void)buildQueue_.run(progressiveBuildBudget_ - elapsed);
+    }
+  }
+  return true;
+}
 
-  PrimeFrame::NodeId rootId = frame_.createNode();
-  frame_.addRoot(rootId);
-  if (PrimeFrame::Node* rootNode = frame_.getNode(rootId)) {
-    rootNode->layout = PrimeFrame::LayoutType::Overlay;
-    rootNode->visible = true;
-    rootNode->clipChildren = true;
-    rootNode->hitTestVisible = false;
+bool App::setTheme(PrimeFrame::Theme const& theme) {
+  theme_ = theme;
+  PrimeFrame::Theme const* current = frame_.getTheme(PrimeFrame::DefaultThemeId);
+  bool metricsChanged = !current || !same_text_metrics(*current, theme);
+  apply_theme_tables(frame_, theme);
+  // A swap creates no UiNode, so run the readability pass here rather than on the next rebuild.
+  ensureReadableTheme(frame_);
+  styleTable_.invalidate();
+  if (metricsChanged) {
+    // Widgets bake measured text into the size hints they set at build time, so a layout alone
+    // would keep the old sizes.
+    lifecycle_.requestRebuild();
+    return true;
   }
+  // Colors are resolved from tokens at flatten time, so the next render picks the swap up.
+  lifecycle_.requestFrame();
+  return false;
+}
 
-  rebuildUi(UiNode(frame_, rootId, true));
-  lifecycle_.markRebuildComplete();
+void App::setProgressiveBuildBudget(std::chrono::microseconds budget) {
+  progressiveBuildBudget_ = std::max(budget, std::chrono::microseconds{0});
+}
+
+void App::setBuildThreadCount(size_t workerCount) {
+  buildPool_->resize(workerCount);
+}
+
+size_t App::buildThreadCount() const {
+  return buildPool_->workerCount();
+}
+
+bool App::runProgressiveBuildStep() {
+  if (!buildQueue_.pending()) {
+    return false;
+  }
+  // Deferred sections only add nodes under their placeholders, so existing ids, focus and
+  // captures stay valid; a relayout picks up the new content.
+  {
+    BuildPoolScope poolScope{*buildPool_};
+    StyleTableScope styleScope{styleTable_, frame_};
+    FocusRingScope ringScope{*focusRing_};
+    (void)buildQueue_.run(progressiveBuildBudget_);
+  }
+  lifecycle_.requestLayout();
+  return true;
+}
+
+bool App::startBackgroundRebuild(std::function<void(UiNode)> rebuildUi,
+                                 WidgetIdentityReconciler* identity) {
+  (void)drainPostedUpdates();
+  if (!rebuildUi || !lifecycle_.rebuildPending() || lifecycle_.rebuildInFlight()) {
+    return false;
+  }
+  if (identity) {
+    identity->beginRebuild(focus_.focusedNode());
+  }
+
+  auto job = std::make_unique<BackgroundRebuild>();
+  job->rebuildUi = std::move(rebuildUi);
+  job->theme = theme_;
+  job->identity = identity;
+  BackgroundRebuild* raw = job.get();
+  backgroundRebuild_ = std::move(job);
+  lifecycle_.markRebuildStarted();
+
+  // The worker attaches its own ring: the UI thread keeps building progressive sections and
+  // retargeting focusRing_ while the rebuild is in flight.
+  raw->worker = std::thread([raw, timers = &timers_]() {
+    try {
+      if (raw->theme) {
+        apply_theme_tables(raw->frame, *raw->theme);
+      }
+      PrimeFrame::NodeId rootId = create_rebuild_root(raw->frame);
+      ThemeStyleTable styles;
+      StyleTableScope styleScope{styles, raw->frame};
+      FocusRingScope ringScope{*raw->focusRing};
+      // Widgets wired through applyPlatformServices() point at timers_; queue their timers until
+      // the commit instead of touching the UI thread's heap.
+      TimerScheduler::DeferScope timerScope{*timers};
+      raw->rebuildUi(UiNode(raw->frame, rootId, true));
+    } catch (...) {
+      raw->error = std::current_exception();
+    }
+    raw->done.store(true, std::memory_order_release);
+  });
+  return true;
+}
+
+bool App::commitBackgroundRebuild() {
+  if (!backgroundRebuild_ || !backgroundRebuild_->done.load(std::memory_order_acquire)) {
+    return false;
+  }
+  std::unique_ptr<BackgroundRebuild> job = std::move(backgroundRebuild_);
+  job->worker.join();
+  lifecycle_.markRebuildSwapped();
+
+  if (job->error) {
+    // Mirror the synchronous path: a failed rebuild keeps the request pending and the front frame
+    // stays in place.
+    lifecycle_.requestRebuild();
+    std::rethrow_exception(job->error);
+  }
+
+  frame_ = std::move(job->frame);
+  focusRing_ = std::move(job->focusRing);
+  if (theme_) {
+    // The worker built with the theme current at start; a setTheme() since then wins.
+    apply_theme_tables(frame_, *theme_);
+    ensureReadableTheme(frame_);
+    styleTable_.invalidate();
+  }
+  (void)timers_.adoptDeferred();
+  router_.clearAllCaptures();
+  // Background builds do not use the memo cache; its node ids belonged to the replaced frame.
+  memoCache_.clear();
+  buildQueue_.clear();
+  pendingFocusIdentity_ = job->identity;
   return true;
 }
 
@@ -299,6 +683,10 @@ bool App::runLayoutIfNeeded() {
     options.rootHeight = static_cast<float>(resolvedLayoutHeight()) / scale;
     layoutEngine_.layout(frame_, layout_, options);
     focus_.updateAfterRebuild(frame_, layout_);
+    if (pendingFocusIdentity_) {
+      (void)pendingFocusIdentity_->restoreFocus(focus_, frame_, layout_);
+      pendingFocusIdentity_ = nullptr;
+    }
   });
   if (didLayout) {
     syncImeCompositionRect();
@@ -307,14 +695,22 @@ bool App::runLayoutIfNeeded() {
 }
 
 bool App::dispatchFrameEvent(PrimeFrame::Event const& event) {
+  // Batched dispatch syncs the IME rect once after the batch, but a resize or a handled event
+  // earlier in the batch may have dirtied layout, so later events never hit test stale layout.
   (void)runLayoutIfNeeded();
   PrimeFrame::NodeId focusedBefore = focus_.focusedNode();
+  LayoutRequestScope layoutRequests;
   bool handled = router_.dispatch(event, frame_, layout_, &focus_);
+  if (layoutRequests.requested()) {
+    lifecycle_.requestLayout();
+  }
   bool focusChanged = focus_.focusedNode() != focusedBefore;
   if (handled || focusChanged) {
     lifecycle_.requestFrame();
   }
-  syncImeCompositionRect();
+  if (!batchDispatchActive_) {
+    syncImeCompositionRect();
+  }
   return handled || focusChanged;
 }
 
@@ -346,6 +742,87 @@ InputBridgeResult App::bridgeHostInputEvent(PrimeHost::InputEvent const& input,
   return result;
 }
 
+InputBridgeResult App::dispatchEventBatch(PrimeHost::EventBatch const& batch, HostKey exitKey) {
+  InputBridgeResult merged;
+  (void)runLayoutIfNeeded();
+  batchDispatchActive_ = true;
+  batchPendingMoves_.clear();
+  batchPendingScroll_.reset();
+
+  for (PrimeHost::Event const& event : batch.events) {
+    if (auto const* input = std::get_if<PrimeHost::InputEvent>(&event.payload)) {
+      if (auto const* pointer = std::get_if<PrimeHost::PointerEvent>(input)) {
+        if (pointer->phase == PrimeHost::PointerPhase::Move) {
+          if (batchPendingScroll_) {
+            flushBatchedInput(batch, exitKey, merged);
+          }
+          auto it = std::find_if(batchPendingMoves_.begin(),
+                                 batchPendingMoves_.end(),
+                                 [pointer](PrimeHost::PointerEvent const& pending) {
+                                   return pending.pointerId == pointer->pointerId;
+                                 });
+          if (it != batchPendingMoves_.end()) {
+            *it = *pointer;
+          } else {
+            batchPendingMoves_.push_back(*pointer);
+          }
+          continue;
+        }
+      } else if (auto const* scroll = std::get_if<PrimeHost::ScrollEvent>(input)) {
+        if (!batchPendingMoves_.empty() ||
+            (batchPendingScroll_ && batchPendingScroll_->isLines != scroll->isLines)) {
+          flushBatchedInput(batch, exitKey, merged);
+        }
+        if (batchPendingScroll_) {
+          batchPendingScroll_->deltaX += scroll->deltaX;
+          batchPendingScroll_->deltaY += scroll->deltaY;
+        } else {
+          batchPendingScroll_ = *scroll;
+        }
+        continue;
+      }
+      // Down/up/cancel, key and text events keep their order relative to coalesced runs.
+      flushBatchedInput(batch, exitKey, merged);
+      InputBridgeResult result = bridgeHostInputEvent(*input, batch, exitKey);
+      merged.requestFrame = merged.requestFrame || result.requestFrame;
+      merged.bypassFrameCap = merged.bypassFrameCap || result.bypassFrameCap;
+      merged.requestExit = merged.requestExit || result.requestExit;
+    } else if (auto const* resize = std::get_if<PrimeHost::ResizeEvent>(&event.payload)) {
+      flushBatchedInput(batch, exitKey, merged);
+      setSurfaceMetrics(resize->width, resize->height, resize->scale);
+      merged.bypassFrameCap = true;
+    }
+  }
+  flushBatchedInput(batch, exitKey, merged);
+
+  batchDispatchActive_ = false;
+  syncImeCompositionRect();
+  if (merged.requestFrame) {
+    lifecycle_.requestFrame();
+  }
+  return merged;
+}
+
+void App::flushBatchedInput(PrimeHost::EventBatch const& batch,
+                            HostKey exitKey,
+                            InputBridgeResult& merged) {
+  auto dispatch = [&](PrimeHost::InputEvent const& input) {
+    InputBridgeResult result = bridgeHostInputEvent(input, batch, exitKey);
+    merged.requestFrame = merged.requestFrame || result.requestFrame;
+    merged.bypassFrameCap = merged.bypassFrameCap || result.bypassFrameCap;
+    merged.requestExit = merged.requestExit || result.requestExit;
+  };
+  for (PrimeHost::PointerEvent const& move : batchPendingMoves_) {
+    dispatch(PrimeHost::InputEvent{move});
+  }
+  batchPendingMoves_.clear();
+  if (batchPendingScroll_) {
+    PrimeHost::ScrollEvent scroll = *batchPendingScroll_;
+    batchPendingScroll_.reset();
+    dispatch(PrimeHost::InputEvent{scroll});
+  }
+}
+
 bool App::focusWidget(WidgetFocusHandle handle) {
   PrimeFrame::NodeId nodeId = handle.lowLevelNodeId();
   if (!nodeId.isValid()) {
@@ -417,7 +894,11 @@ bool App::dispatchWidgetEvent(WidgetActionHandle handle, PrimeFrame::Event const
   if (!callback || !callback->onEvent) {
     return false;
   }
+  LayoutRequestScope layoutRequests;
   bool handled = callback->onEvent(event);
+  if (layoutRequests.requested()) {
+    lifecycle_.requestLayout();
+  }
   if (handled) {
     lifecycle_.requestFrame();
   }
@@ -427,12 +908,34 @@ bool App::dispatchWidgetEvent(WidgetActionHandle handle, PrimeFrame::Event const
 
 RenderStatus App::renderToTarget(RenderTarget const& target) {
   (void)runLayoutIfNeeded();
-  return renderFrameToTarget(frame_, layout_, target, renderOptions_);
+  std::vector<PrimeFrame::DrawCommand> ring;
+  focusRing_->appendDrawCommands(frame_, layout_, focus_.focusedNode(), ring);
+  return renderFrameToTarget(frame_, layout_, target, renderOptions_, ring);
 }
 
 RenderStatus App::renderToPng(std::string_view path) {
   (void)runLayoutIfNeeded();
-  return renderFrameToPng(frame_, layout_, path, renderOptions_);
+  std::vector<PrimeFrame::DrawCommand> ring;
+  focusRing_->appendDrawCommands(frame_, layout_, focus_.focusedNode(), ring);
+  return renderFrameToPng(frame_, layout_, path, renderOptions_, ring);
+}
+
+RenderStatus App::submitRenderToTarget(RenderTarget const& target,
+                                       RenderPipeline::Completion onComplete) {
+  (void)runLayoutIfNeeded();
+  if (!renderPipeline_) {
+    renderPipeline_ = std::make_unique<RenderPipeline>();
+  }
+  RenderSnapshot snapshot = renderPipeline_->acquireSnapshot();
+  captureRenderSnapshot(frame_, layout_, renderOptions_, snapshot);
+  focusRing_->appendDrawCommands(frame_, layout_, focus_.focusedNode(), snapshot.batch.commands);
+  return renderPipeline_->submit(std::move(snapshot), target, std::move(onComplete));
+}
+
+void App::waitForRenderIdle() {
+  if (renderPipeline_) {
+    renderPipeline_->waitIdle();
+  }
 }
 
 float App::resolvedLayoutScale() const {
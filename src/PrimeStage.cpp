@@ -660,12 +660,85 @@ PrimeFrame::Color resolve_theme_surface_color(PrimeFrame::Theme const& theme) {
   return theme.palette[0];
 }
 
-void ensure_readable_theme_defaults(PrimeFrame::Frame& frame) {
-  PrimeFrame::Theme* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
-  if (!theme) {
-    return;
+constexpr size_t ReadableThemePaletteSamples = 8u;
+
+// Everything patch_readable_theme_defaults reads, captured once a theme has passed validation.
+// UiNode construction compares against it instead of re-running the contrast checks, so the
+// builder hot path only re-validates after the theme was replaced or edited.
+struct ValidatedThemeInputs {
+  PrimeFrame::Theme const* theme = nullptr;
+  size_t paletteSize = 0u;
+  size_t rectStyleCount = 0u;
+  size_t textStyleCount = 0u;
+  PrimeFrame::RectStyle rect{};
+  PrimeFrame::TextStyle text{};
+  std::array<PrimeFrame::Color, ReadableThemePaletteSamples> samples{};
+  PrimeFrame::Color fillColor{};
+  PrimeFrame::Color textColor{};
+};
+
+thread_local ValidatedThemeInputs validatedTheme;
+
+bool color_equals(PrimeFrame::Color const& lhs, PrimeFrame::Color const& rhs) {
+  return lhs.r == rhs.r && lhs.g == rhs.g && lhs.b == rhs.b && lhs.a == rhs.a;
+}
+
+PrimeFrame::Color palette_color_or_default(PrimeFrame::Theme const& theme, size_t token) {
+  return token < theme.palette.size() ? theme.palette[token] : PrimeFrame::Color{};
+}
+
+ValidatedThemeInputs capture_theme_inputs(PrimeFrame::Theme const& theme) {
+  ValidatedThemeInputs inputs;
+  inputs.theme = &theme;
+  inputs.paletteSize = theme.palette.size();
+  inputs.rectStyleCount = theme.rectStyles.size();
+  inputs.textStyleCount = theme.textStyles.size();
+  if (!theme.rectStyles.empty()) {
+    inputs.rect = theme.rectStyles[0];
+    inputs.fillColor = palette_color_or_default(theme, inputs.rect.fill);
+  }
+  if (!theme.textStyles.empty()) {
+    inputs.text = theme.textStyles[0];
+    inputs.textColor = palette_color_or_default(theme, inputs.text.color);
+  }
+  size_t sampleCount = std::min(theme.palette.size(), ReadableThemePaletteSamples);
+  for (size_t i = 0; i < sampleCount; ++i) {
+    inputs.samples[i] = theme.palette[i];
+  }
+  return inputs;
+}
+
+bool theme_inputs_unchanged(ValidatedThemeInputs const& validated, PrimeFrame::Theme const& theme) {
+  if (validated.theme != &theme || validated.paletteSize != theme.palette.size() ||
+      validated.rectStyleCount != theme.rectStyles.size() ||
+      validated.textStyleCount != theme.textStyles.size()) {
+    return false;
+  }
+  if (!theme.rectStyles.empty()) {
+    PrimeFrame::RectStyle const& rect = theme.rectStyles[0];
+    if (rect.fill != validated.rect.fill || rect.opacity != validated.rect.opacity ||
+        !color_equals(palette_color_or_default(theme, rect.fill), validated.fillColor)) {
+      return false;
+    }
+  }
+  if (!theme.textStyles.empty()) {
+    PrimeFrame::TextStyle const& text = theme.textStyles[0];
+    if (text.color != validated.text.color || text.size != validated.text.size ||
+        text.weight != validated.text.weight ||
+        !color_equals(palette_color_or_default(theme, text.color), validated.textColor)) {
+      return false;
+    }
+  }
+  size_t sampleCount = std::min(theme.palette.size(), ReadableThemePaletteSamples);
+  for (size_t i = 0; i < sampleCount; ++i) {
+    if (!color_equals(theme.palette[i], validated.samples[i])) {
+      return false;
+    }
   }
+  return true;
+}
 
+void patch_readable_theme_defaults(PrimeFrame::Theme* theme) {
   if (is_canonical_primeframe_default_theme(*theme)) {
     install_primestage_default_theme(*theme);
     return;
@@ -750,6 +823,16 @@ void ensure_readable_theme_defaults(PrimeFrame::Frame& frame) {
   }
 }
 
+void ensure_readable_theme_defaults(PrimeFrame::Frame& frame) {
+  PrimeFrame::Theme* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
+  if (!theme || theme_inputs_unchanged(validatedTheme, *theme)) {
+    return;
+  }
+  patch_readable_theme_defaults(theme);
+  validatedTheme = capture_theme_inputs(*theme);
+  Internal::invalidateThemeStyles(frame);
+}
+
 PrimeFrame::Color resolve_semantic_focus_color(PrimeFrame::Frame& frame) {
   PrimeFrame::Theme const* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
   if (theme && !theme->palette.empty()) {
@@ -863,8 +946,6 @@ ResolvedFocusStyle resolve_focus_style(PrimeFrame::Frame& frame,
   return resolved;
 }
 
-constexpr float FocusRingThickness = 2.0f;
-
 std::vector<PrimeFrame::PrimitiveId> add_focus_ring_primitives(
     PrimeFrame::Frame& frame,
     PrimeFrame::NodeId nodeId,
@@ -875,30 +956,15 @@ std::vector<PrimeFrame::PrimitiveId> add_focus_ring_primitives(
   if (token == 0) {
     return prims;
   }
-  if (!bounds || bounds->width <= 0.0f || bounds->height <= 0.0f) {
-    prims.push_back(add_rect_primitive_with_rect(frame, nodeId, Rect{}, token, overrideStyle));
-    return prims;
-  }
-  float maxThickness = std::min(bounds->width, bounds->height) * 0.5f;
-  float thickness = std::clamp(FocusRingThickness, 1.0f, maxThickness);
-  Rect top{0.0f, 0.0f, bounds->width, thickness};
-  Rect bottom{0.0f,
-              std::max(0.0f, bounds->height - thickness),
-              bounds->width,
-              thickness};
-  float sideHeight = std::max(0.0f, bounds->height - thickness * 2.0f);
-  Rect left{0.0f, thickness, thickness, sideHeight};
-  Rect right{std::max(0.0f, bounds->width - thickness), thickness, thickness, sideHeight};
-  auto add_if = [&](Rect const& rect) {
-    if (rect.width <= 0.0f || rect.height <= 0.0f) {
-      return;
+  if (bounds) {
+    for (Internal::InternalRect const& edge : Internal::focusRingEdges(bounds->width, bounds->height)) {
+      prims.push_back(add_rect_primitive_with_rect(frame,
+                                                   nodeId,
+                                                   Rect{edge.x, edge.y, edge.width, edge.height},
+                                                   token,
+                                                   overrideStyle));
     }
-    prims.push_back(add_rect_primitive_with_rect(frame, nodeId, rect, token, overrideStyle));
-  };
-  add_if(top);
-  add_if(bottom);
-  add_if(left);
-  add_if(right);
+  }
   if (prims.empty()) {
     prims.push_back(add_rect_primitive_with_rect(frame, nodeId, Rect{}, token, overrideStyle));
   }
@@ -969,60 +1035,21 @@ void attach_focus_callbacks(PrimeFrame::Frame& frame,
     framePtr->addChild(parent, overlayId);
   };
 
-  PrimeFrame::Node* node = frame.getNode(nodeId);
-  if (!node) {
-    return;
-  }
-  if (node->callbacks != PrimeFrame::InvalidCallbackId) {
-    PrimeFrame::Callback* callback = frame.getCallback(node->callbacks);
-    if (!callback) {
-      return;
-    }
-    auto prevFocus = callback->onFocus;
-    auto prevBlur = callback->onBlur;
-    callback->onFocus = [promoteOverlay, applyFocus, prevFocus]() {
-      promoteOverlay();
-      applyFocus(true);
-      if (prevFocus) {
-        prevFocus();
-      }
-    };
-    callback->onBlur = [applyFocus, prevBlur]() {
-      applyFocus(false);
-      if (prevBlur) {
-        prevBlur();
-      }
-    };
-    return;
-  }
-
-  PrimeFrame::Callback callback;
-  callback.onFocus = [promoteOverlay, applyFocus]() {
+  // Focus styling joins the node's flattened handler list; existing focus/blur
+  // handlers keep running in append order.
+  (void)LowLevel::appendNodeOnFocus(frame, nodeId, [promoteOverlay, applyFocus]() {
     promoteOverlay();
     applyFocus(true);
-  };
-  callback.onBlur = [applyFocus]() { applyFocus(false); };
-  node->callbacks = frame.addCallback(std::move(callback));
+  });
+  (void)LowLevel::appendNodeOnBlur(frame, nodeId, [applyFocus]() { applyFocus(false); });
 }
 
 float resolve_line_height(PrimeFrame::Frame& frame, PrimeFrame::TextStyleToken token) {
-  PrimeFrame::Theme const* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
-  if (!theme) {
-    return 0.0f;
-  }
-  PrimeFrame::ResolvedTextStyle resolved = PrimeFrame::resolveTextStyle(*theme, token, {});
-  float lineHeight = resolved.lineHeight > 0.0f ? resolved.lineHeight : resolved.size * 1.2f;
-  return lineHeight;
+  std::optional<ThemeStyleTable::TextEntry> entry = Internal::resolveTextEntry(frame, token);
+  return entry ? entry->lineHeight : 0.0f;
 }
 
-float estimate_text_width(PrimeFrame::Frame& frame,
-                          PrimeFrame::TextStyleToken token,
-                          std::string_view text) {
-  PrimeFrame::Theme const* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
-  if (!theme) {
-    return 0.0f;
-  }
-  PrimeFrame::ResolvedTextStyle resolved = PrimeFrame::resolveTextStyle(*theme, token, {});
+float estimate_text_width(PrimeFrame::ResolvedTextStyle const& resolved, std::string_view text) {
   float advance = resolved.size * 0.6f + resolved.tracking;
   float lineWidth = 0.0f;
   float maxWidth = 0.0f;
@@ -1038,6 +1065,16 @@ float estimate_text_width(PrimeFrame::Frame& frame,
   return maxWidth;
 }
 
+float estimate_text_width(PrimeFrame::Frame& frame,
+                          PrimeFrame::TextStyleToken token,
+                          std::string_view text) {
+  std::optional<ThemeStyleTable::TextEntry> entry = Internal::resolveTextEntry(frame, token);
+  if (!entry) {
+    return 0.0f;
+  }
+  return estimate_text_width(entry->style, text);
+}
+
 } // namespace
 
 std::vector<float> buildCaretPositions(PrimeFrame::Frame& frame,
@@ -1136,43 +1173,59 @@ bool appendNodeOnEvent(WidgetRuntimeContext const& runtime,
   return LowLevel::appendNodeOnEvent(runtimeFrame(runtime), nodeId, std::move(onEvent));
 }
 
-ListSpec normalizeListSpec(ListSpec const& specInput) {
-  ListSpec spec = specInput;
+NormalizedListSpec normalizeListSpec(ListSpec const& specInput) {
+  NormalizedListSpec spec;
+  spec.size = specInput.size;
   sanitize_size_spec(spec.size, "ListSpec.size");
-  spec.rowHeight = clamp_non_negative(spec.rowHeight, "ListSpec", "rowHeight");
-  spec.rowGap = clamp_non_negative(spec.rowGap, "ListSpec", "rowGap");
-  spec.rowPaddingX = clamp_non_negative(spec.rowPaddingX, "ListSpec", "rowPaddingX");
-  spec.selectedIndex = clamp_selected_row_or_none(spec.selectedIndex,
-                                                  static_cast<int>(spec.items.size()),
+  spec.rowHeight = clamp_non_negative(specInput.rowHeight, "ListSpec", "rowHeight");
+  spec.rowGap = clamp_non_negative(specInput.rowGap, "ListSpec", "rowGap");
+  spec.rowPaddingX = clamp_non_negative(specInput.rowPaddingX, "ListSpec", "rowPaddingX");
+  spec.selectedIndex = clamp_selected_row_or_none(specInput.selectedIndex,
+                                                  static_cast<int>(specInput.items.size()),
                                                   "ListSpec",
                                                   "selectedIndex");
-  spec.tabIndex = clamp_tab_index(spec.tabIndex, "ListSpec", "tabIndex");
-  apply_default_accessibility_semantics(spec.accessibility, AccessibilityRole::Table, spec.enabled);
+  spec.tabIndex = clamp_tab_index(specInput.tabIndex, "ListSpec", "tabIndex");
+  spec.accessibility = specInput.accessibility;
+  apply_default_accessibility_semantics(spec.accessibility, AccessibilityRole::Table, specInput.enabled);
   return spec;
 }
 
-TableSpec normalizeTableSpec(TableSpec const& specInput) {
-  TableSpec spec = specInput;
+NormalizedTableSpec normalizeTableSpec(TableSpec const& specInput) {
+  NormalizedTableSpec spec;
+  spec.size = specInput.size;
   sanitize_size_spec(spec.size, "TableSpec.size");
-  spec.headerInset = clamp_non_negative(spec.headerInset, "TableSpec", "headerInset");
-  spec.headerHeight = clamp_non_negative(spec.headerHeight, "TableSpec", "headerHeight");
-  spec.rowHeight = clamp_non_negative(spec.rowHeight, "TableSpec", "rowHeight");
-  spec.rowGap = clamp_non_negative(spec.rowGap, "TableSpec", "rowGap");
-  spec.headerPaddingX = clamp_non_negative(spec.headerPaddingX, "TableSpec", "headerPaddingX");
-  spec.cellPaddingX = clamp_non_negative(spec.cellPaddingX, "TableSpec", "cellPaddingX");
-  spec.selectedRow = clamp_selected_row_or_none(spec.selectedRow,
-                                                 static_cast<int>(spec.rows.size()),
+  spec.headerInset = clamp_non_negative(specInput.headerInset, "TableSpec", "headerInset");
+  spec.headerHeight = clamp_non_negative(specInput.headerHeight, "TableSpec", "headerHeight");
+  spec.rowHeight = clamp_non_negative(specInput.rowHeight, "TableSpec", "rowHeight");
+  spec.rowGap = clamp_non_negative(specInput.rowGap, "TableSpec", "rowGap");
+  spec.headerPaddingX = clamp_non_negative(specInput.headerPaddingX, "TableSpec", "headerPaddingX");
+  spec.cellPaddingX = clamp_non_negative(specInput.cellPaddingX, "TableSpec", "cellPaddingX");
+  spec.scrollOffset = clamp_non_negative(specInput.scrollOffset, "TableSpec", "scrollOffset");
+  TableDataSource const& source = specInput.dataSource;
+  if (source.cell) {
+    spec.rowCount = source.rowCount ? source.rowCount() : 0u;
+  } else {
+    spec.rowCount = specInput.rows.size();
+  }
+  spec.selectedRow = clamp_selected_row_or_none(specInput.selectedRow,
+                                                 static_cast<int>(spec.rowCount),
                                                  "TableSpec",
                                                  "selectedRow");
-  spec.tabIndex = clamp_tab_index(spec.tabIndex, "TableSpec", "tabIndex");
-  apply_default_accessibility_semantics(spec.accessibility, AccessibilityRole::Table, spec.enabled);
+  spec.overscanRows = std::max(specInput.overscanRows, 0);
+  report_validation_int("TableSpec", "overscanRows", specInput.overscanRows, spec.overscanRows);
+  spec.tabIndex = clamp_tab_index(specInput.tabIndex, "TableSpec", "tabIndex");
+  spec.accessibility = specInput.accessibility;
+  apply_default_accessibility_semantics(spec.accessibility, AccessibilityRole::Table, specInput.enabled);
   return spec;
 }
 
-TreeViewSpec normalizeTreeViewSpec(TreeViewSpec const& specInput) {
-  TreeViewSpec spec = specInput;
-  spec.tabIndex = clamp_tab_index(spec.tabIndex, "TreeViewSpec", "tabIndex");
-  apply_default_accessibility_semantics(spec.accessibility, AccessibilityRole::Tree, spec.enabled);
+NormalizedTreeViewSpec normalizeTreeViewSpec(TreeViewSpec const& specInput) {
+  NormalizedTreeViewSpec spec;
+  spec.tabIndex = clamp_tab_index(specInput.tabIndex, "TreeViewSpec", "tabIndex");
+  spec.overscanRows = std::max(specInput.overscanRows, 0);
+  report_validation_int("TreeViewSpec", "overscanRows", specInput.overscanRows, spec.overscanRows);
+  spec.accessibility = specInput.accessibility;
+  apply_default_accessibility_semantics(spec.accessibility, AccessibilityRole::Tree, specInput.enabled);
   return spec;
 }
 
@@ -1516,6 +1569,10 @@ float estimateTextWidth(PrimeFrame::Frame& frame,
   return estimate_text_width(frame, token, text);
 }
 
+float estimateTextWidth(PrimeFrame::ResolvedTextStyle const& style, std::string_view text) {
+  return estimate_text_width(style, text);
+}
+
 float sliderValueFromEvent(PrimeFrame::Event const& event, bool vertical, float thumbSize) {
   return slider_value_from_event(event, vertical, thumbSize);
 }
@@ -1546,6 +1603,22 @@ void attachFocusOverlay(PrimeFrame::Frame& frame,
                         InternalRect const& rect,
                         InternalFocusStyle const& focusStyle,
                         bool visible) {
+  if (FocusRing* ring = activeFocusRing()) {
+    if (focusStyle.token == 0) {
+      return;
+    }
+    FocusRing::Target target;
+    target.node = nodeId;
+    target.x = rect.x;
+    target.y = rect.y;
+    target.width = rect.width;
+    target.height = rect.height;
+    target.token = focusStyle.token;
+    target.overrideStyle = focusStyle.overrideStyle;
+    (void)LowLevel::appendNodeOnFocus(frame, nodeId, [ring, target]() { ring->show(target); });
+    (void)LowLevel::appendNodeOnBlur(frame, nodeId, [ring, nodeId]() { ring->hide(nodeId); });
+    return;
+  }
   auto overlay = add_focus_overlay_node(frame,
                                         nodeId,
                                         Rect{rect.x, rect.y, rect.width, rect.height},
@@ -1666,6 +1739,10 @@ void setScrollBarThumbPixels(ScrollBarSpec& spec,
   spec.thumbProgress = std::clamp(thumbOffset / maxOffset, 0.0f, 1.0f);
 }
 
+void ensureReadableTheme(PrimeFrame::Frame& frame) {
+  ensure_readable_theme_defaults(frame);
+}
+
 UiNode::UiNode(PrimeFrame::Frame& frame, PrimeFrame::NodeId id, bool allowAbsolute)
     : frame_(frame), id_(id), allowAbsolute_(allowAbsolute) {
   ensure_readable_theme_defaults(frame_);
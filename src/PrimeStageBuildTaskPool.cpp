@@ -0,0 +1,149 @@
+#include "PrimeStageBuildTaskPool.h"
+
+#include <utility>
+
+namespace PrimeStage::Internal {
+
+namespace {
+
+// Pool running UiNode::prepareInParallel steps; set between beginBuild and endBuild.
+thread_local BuildTaskPool* activeTaskPool = nullptr;
+
+} // namespace
+
+BuildTaskPool* activeBuildTaskPool() {
+  return activeTaskPool;
+}
+
+BuildTaskPool::BuildTaskPool(size_t workerCount) {
+  resize(workerCount);
+}
+
+BuildTaskPool::~BuildTaskPool() {
+  endBuild();
+  resize(0u);
+}
+
+void BuildTaskPool::resize(size_t workerCount) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread& worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = false;
+  }
+  // New workers start from the current generation so they only pick up batches run after this.
+  uint64_t generation = generation_;
+  workers_.reserve(workerCount);
+  for (size_t index = 0u; index < workerCount; ++index) {
+    workers_.emplace_back([this, generation]() { workerLoop(generation); });
+  }
+}
+
+void BuildTaskPool::beginBuild() {
+  if (!active_) {
+    previousActive_ = activeTaskPool;
+    activeTaskPool = this;
+    active_ = true;
+  }
+}
+
+void BuildTaskPool::endBuild() {
+  if (active_) {
+    if (activeTaskPool == this) {
+      activeTaskPool = previousActive_;
+    }
+    previousActive_ = nullptr;
+    active_ = false;
+  }
+}
+
+void BuildTaskPool::drainBatch() {
+  for (;;) {
+    size_t index = nextTask_.fetch_add(1u, std::memory_order_relaxed);
+    if (index >= taskCount_) {
+      return;
+    }
+    try {
+      (*task_)(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) {
+        error_ = std::current_exception();
+      }
+    }
+  }
+}
+
+void BuildTaskPool::workerLoop(uint64_t seen) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    wake_.wait(lock, [&]() { return stopping_ || generation_ != seen; });
+    if (stopping_) {
+      return;
+    }
+    seen = generation_;
+    lock.unlock();
+    drainBatch();
+    lock.lock();
+    busyWorkers_ -= 1u;
+    if (busyWorkers_ == 0u) {
+      idle_.notify_all();
+    }
+  }
+}
+
+void BuildTaskPool::run(size_t taskCount, std::function<void(size_t)> const& task) {
+  if (taskCount == 0u || !task) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (running_ || workers_.empty() || taskCount == 1u) {
+    lock.unlock();
+    std::exception_ptr error;
+    for (size_t index = 0u; index < taskCount; ++index) {
+      try {
+        task(index);
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+    if (error) {
+      std::rethrow_exception(error);
+    }
+    return;
+  }
+  running_ = true;
+  task_ = &task;
+  taskCount_ = taskCount;
+  nextTask_.store(0u, std::memory_order_relaxed);
+  error_ = nullptr;
+  busyWorkers_ = workers_.size();
+  generation_ += 1u;
+  lock.unlock();
+  wake_.notify_all();
+
+  // The building thread takes tasks too instead of idling until the workers finish.
+  drainBatch();
+
+  lock.lock();
+  idle_.wait(lock, [&]() { return busyWorkers_ == 0u; });
+  std::exception_ptr error = std::exchange(error_, nullptr);
+  task_ = nullptr;
+  taskCount_ = 0u;
+  running_ = false;
+  lock.unlock();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace PrimeStage::Internal
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace PrimeStage::Internal {
+
+// Worker threads for UiNode::prepareInParallel. While a pool is attached to the building thread
+// (beginBuild/endBuild), section prepare steps are spread over its workers and the building thread;
+// without one they run serially. Only prepare steps run here: nodes are still created serially on
+// the building thread, because a PrimeFrame::Frame is not safe to mutate concurrently.
+class BuildTaskPool {
+public:
+  explicit BuildTaskPool(size_t workerCount = 0u);
+  ~BuildTaskPool();
+  BuildTaskPool(BuildTaskPool const&) = delete;
+  BuildTaskPool& operator=(BuildTaskPool const&) = delete;
+
+  // Joins the current workers and starts `workerCount` new ones; must not be called mid-build.
+  void resize(size_t workerCount);
+  [[nodiscard]] size_t workerCount() const { return workers_.size(); }
+  void beginBuild();
+  void endBuild();
+  // Calls task(0) .. task(taskCount - 1) and returns once all have finished. The first exception
+  // a task throws is rethrown after the remaining tasks complete. Calls made while the pool is
+  // already running a batch execute serially on the calling thread.
+  void run(size_t taskCount, std::function<void(size_t)> const& task);
+
+private:
+  void workerLoop(uint64_t seen);
+  void drainBatch();
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::vector<std::thread> workers_;
+  std::function<void(size_t)> const* task_ = nullptr;
+  size_t taskCount_ = 0u;
+  std::atomic<size_t> nextTask_{0u};
+  std::exception_ptr error_{};
+  uint64_t generation_ = 0u;
+  size_t busyWorkers_ = 0u;
+  bool running_ = false;
+  bool stopping_ = false;
+  BuildTaskPool* previousActive_ = nullptr;
+  bool active_ = false;
+};
+
+// Pool attached to the building thread by BuildTaskPool::beginBuild, or null.
+BuildTaskPool* activeBuildTaskPool();
+
+} // namespace PrimeStage::Internal
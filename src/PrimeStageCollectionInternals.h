@@ -3,6 +3,7 @@
 #include "PrimeStage/Ui.h"
 
 #include <functional>
+#include <optional>
 
 namespace PrimeStage::Internal {
 
@@ -47,6 +48,42 @@ struct ExtensionPrimitiveSpec {
   ExtensionPrimitiveCallbacks callbacks{};
 };
 
+// Sanitized scalar overlays for the collection widgets. Items, rows, tree nodes and callbacks
+// stay in the caller's spec and are read in place, so normalizing a large collection never
+// deep-copies its data.
+struct NormalizedListSpec {
+  SizeSpec size{};
+  float rowHeight = 0.0f;
+  float rowGap = 0.0f;
+  float rowPaddingX = 0.0f;
+  int selectedIndex = -1;
+  int tabIndex = -1;
+  AccessibilitySemantics accessibility{};
+};
+
+struct NormalizedTableSpec {
+  SizeSpec size{};
+  float headerInset = 0.0f;
+  float headerHeight = 0.0f;
+  float rowHeight = 0.0f;
+  float rowGap = 0.0f;
+  float headerPaddingX = 0.0f;
+  float cellPaddingX = 0.0f;
+  float scrollOffset = 0.0f;
+  // From the data source when it has one, else `rows`.
+  size_t rowCount = 0;
+  int selectedRow = -1;
+  int overscanRows = 0;
+  int tabIndex = -1;
+  AccessibilitySemantics accessibility{};
+};
+
+struct NormalizedTreeViewSpec {
+  int tabIndex = -1;
+  int overscanRows = 0;
+  AccessibilitySemantics accessibility{};
+};
+
 WidgetRuntimeContext makeWidgetRuntimeContext(PrimeFrame::Frame& frame,
                                               PrimeFrame::NodeId parentId,
                                               bool allowAbsolute,
@@ -62,9 +99,9 @@ bool appendNodeOnEvent(WidgetRuntimeContext const& runtime,
                        PrimeFrame::NodeId nodeId,
                        std::function<bool(PrimeFrame::Event const&)> onEvent);
 
-ListSpec normalizeListSpec(ListSpec const& specInput);
-TableSpec normalizeTableSpec(TableSpec const& specInput);
-TreeViewSpec normalizeTreeViewSpec(TreeViewSpec const& specInput);
+NormalizedListSpec normalizeListSpec(ListSpec const& specInput);
+NormalizedTableSpec normalizeTableSpec(TableSpec const& specInput);
+NormalizedTreeViewSpec normalizeTreeViewSpec(TreeViewSpec const& specInput);
 ProgressBarSpec normalizeProgressBarSpec(ProgressBarSpec const& specInput);
 DropdownSpec normalizeDropdownSpec(DropdownSpec const& specInput);
 TabsSpec normalizeTabsSpec(TabsSpec const& specInput);
@@ -89,6 +126,29 @@ float defaultScrollViewWidth();
 float defaultScrollViewHeight();
 float defaultCollectionWidth();
 float defaultCollectionHeight();
+// Row under `contentY` in a column of rows laid out at `rowHeight + rowGap` from the top, or -1
+// when it falls in a gap or past the last row. Collections hit test their rows node with this
+// instead of giving every row node its own callback.
+int collectionRowAt(float contentY, float rowHeight, float rowGap, int rowCount);
+// Recycled collection rows place themselves at their row index's offset inside an overlay rows
+// node. A pool covers the viewport plus `overscanRows` above and below, and row `i` binds slot
+// `i % poolSize`, so rows that stay inside the window keep their nodes while scrolling.
+int collectionRowPoolSize(float viewportHeight,
+                          float rowHeight,
+                          float rowGap,
+                          int overscanRows,
+                          int rowCount);
+// Rows [first, last) a pool of `poolSize` slots binds at `scrollOffset`.
+struct CollectionRowWindow {
+  int first = 0;
+  int last = 0;
+};
+CollectionRowWindow collectionRowWindow(float scrollOffset,
+                                        float rowHeight,
+                                        float rowGap,
+                                        int overscanRows,
+                                        int poolSize,
+                                        int rowCount);
 bool textFieldStateIsPristine(TextFieldState const& state);
 void seedTextFieldStateFromSpec(TextFieldState& state, TextFieldSpec const& spec);
 uint32_t clampTextIndex(uint32_t value,
@@ -101,8 +161,16 @@ std::vector<float> buildCaretPositionsForText(PrimeFrame::Frame& frame,
 float estimateTextWidth(PrimeFrame::Frame& frame,
                         PrimeFrame::TextStyleToken token,
                         std::string_view text);
+// Same estimate for an already resolved style; touches no frame or style table, so it may run on
+// any thread.
+float estimateTextWidth(PrimeFrame::ResolvedTextStyle const& style, std::string_view text);
 float sliderValueFromEvent(PrimeFrame::Event const& event, bool vertical, float thumbSize);
 float resolveLineHeight(PrimeFrame::Frame& frame, PrimeFrame::TextStyleToken token);
+// Resolved style and line height for `token`, served from the attached ThemeStyleTable when it
+// covers `frame`; nullopt when the frame has no default theme.
+std::optional<ThemeStyleTable::TextEntry> resolveTextEntry(PrimeFrame::Frame& frame,
+                                                           PrimeFrame::TextStyleToken token);
+void invalidateThemeStyles(PrimeFrame::Frame const& frame);
 InternalFocusStyle resolveFocusStyle(PrimeFrame::Frame& frame,
                                      PrimeFrame::RectStyleToken focusStyle,
                                      PrimeFrame::RectStyleOverride const& focusStyleOverride,
@@ -113,6 +181,10 @@ InternalFocusStyle resolveFocusStyle(PrimeFrame::Frame& frame,
                                      PrimeFrame::RectStyleToken fallbackE,
                                      std::optional<PrimeFrame::RectStyleOverride> fallbackOverride =
                                          std::nullopt);
+// Focus ring attached to the building thread, or null when widgets own their focus overlays.
+FocusRing* activeFocusRing();
+// Top, bottom, left and right ring edges inside `width` x `height`; degenerate edges are dropped.
+std::vector<InternalRect> focusRingEdges(float width, float height);
 void attachFocusOverlay(PrimeFrame::Frame& frame,
                         PrimeFrame::NodeId nodeId,
                         InternalRect const& rect,
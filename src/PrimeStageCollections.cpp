@@ -3,54 +3,136 @@
 #include "PrimeStageCollectionInternals.h"
 
 #include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace PrimeStage {
 
+namespace {
+
+// List items packed into one buffer that the list's table reads through its data source, so the
+// caller's strings need not outlive the build.
+struct PackedListItems {
+  std::string text;
+  std::vector<size_t> ends;
+
+  [[nodiscard]] std::string_view item(size_t index) const {
+    if (index >= ends.size()) {
+      return {};
+    }
+    size_t begin = index == 0u ? 0u : ends[index - 1u];
+    return std::string_view(text).substr(begin, ends[index] - begin);
+  }
+};
+
+std::shared_ptr<PackedListItems const> pack_list_items(std::vector<std::string_view> const& items) {
+  auto packed = std::make_shared<PackedListItems>();
+  size_t textSize = 0u;
+  for (std::string_view item : items) {
+    textSize += item.size();
+  }
+  packed->text.reserve(textSize);
+  packed->ends.reserve(items.size());
+  for (std::string_view item : items) {
+    packed->text.append(item);
+    packed->ends.push_back(packed->text.size());
+  }
+  return packed;
+}
+
+} // namespace
+
+namespace Internal {
+
+int collectionRowAt(float contentY, float rowHeight, float rowGap, int rowCount) {
+  if (rowCount <= 0 || contentY < 0.0f) {
+    return -1;
+  }
+  float rowPitch = std::max(1.0f, rowHeight + rowGap);
+  float row = std::floor(contentY / rowPitch);
+  if (row >= static_cast<float>(rowCount) || contentY - row * rowPitch > rowHeight) {
+    return -1;
+  }
+  return static_cast<int>(row);
+}
+
+int collectionRowPoolSize(float viewportHeight,
+                          float rowHeight,
+                          float rowGap,
+                          int overscanRows,
+                          int rowCount) {
+  if (rowCount <= 0) {
+    return 0;
+  }
+  float rowPitch = std::max(1.0f, rowHeight + rowGap);
+  // A partially scrolled viewport straddles one more row than fits in it.
+  int visibleRows = static_cast<int>(std::ceil(std::max(0.0f, viewportHeight) / rowPitch)) + 1;
+  int poolSize = visibleRows + std::max(0, overscanRows) * 2;
+  return std::min(poolSize, rowCount);
+}
+
+CollectionRowWindow collectionRowWindow(float scrollOffset,
+                                        float rowHeight,
+                                        float rowGap,
+                                        int overscanRows,
+                                        int poolSize,
+                                        int rowCount) {
+  int windowSize = std::clamp(poolSize, 0, std::max(0, rowCount));
+  float rowPitch = std::max(1.0f, rowHeight + rowGap);
+  int first = static_cast<int>(std::floor(scrollOffset / rowPitch)) - overscanRows;
+  first = std::clamp(first, 0, std::max(0, rowCount) - windowSize);
+  return CollectionRowWindow{first, first + windowSize};
+}
+
+} // namespace Internal
+
 UiNode UiNode::createList(ListSpec const& specInput) {
-  ListSpec spec = Internal::normalizeListSpec(specInput);
+  Internal::NormalizedListSpec normalized = Internal::normalizeListSpec(specInput);
+  ListSpec const& spec = specInput;
   Internal::WidgetRuntimeContext runtime = Internal::makeWidgetRuntimeContext(frame(),
                                                                               nodeId(),
                                                                               allowAbsolute(),
                                                                               spec.enabled,
                                                                               spec.visible,
-                                                                              spec.tabIndex);
+                                                                              normalized.tabIndex);
 
   TableSpec table;
-  table.accessibility = spec.accessibility;
+  table.accessibility = normalized.accessibility;
   table.visible = spec.visible;
   table.enabled = spec.enabled;
-  table.tabIndex = spec.tabIndex;
-  table.size = spec.size;
+  table.tabIndex = normalized.tabIndex;
+  table.size = normalized.size;
   table.headerInset = 0.0f;
   table.headerHeight = 0.0f;
-  table.rowHeight = spec.rowHeight;
-  table.rowGap = spec.rowGap;
-  table.headerPaddingX = spec.rowPaddingX;
-  table.cellPaddingX = spec.rowPaddingX;
+  table.rowHeight = normalized.rowHeight;
+  table.rowGap = normalized.rowGap;
+  table.headerPaddingX = normalized.rowPaddingX;
+  table.cellPaddingX = normalized.rowPaddingX;
   table.rowStyle = spec.rowStyle;
   table.rowAltStyle = spec.rowAltStyle;
   table.selectionStyle = spec.selectionStyle;
   table.dividerStyle = spec.dividerStyle;
   table.focusStyle = spec.focusStyle;
   table.focusStyleOverride = spec.focusStyleOverride;
-  table.selectedRow = spec.selectedIndex;
+  table.selectedRow = normalized.selectedIndex;
   table.showHeaderDividers = false;
   table.showColumnDividers = false;
   table.clipChildren = spec.clipChildren;
   table.columns.push_back(TableColumn{"", 0.0f, spec.textStyle, spec.textStyle});
-  table.rows.reserve(spec.items.size());
-  for (std::string_view item : spec.items) {
-    table.rows.push_back({item});
-  }
+  std::shared_ptr<PackedListItems const> items = pack_list_items(spec.items);
+  table.dataSource.rowCount = [items]() { return items->ends.size(); };
+  table.dataSource.cell = [items](size_t row, size_t) { return items->item(row); };
   auto onListSelect = spec.callbacks.onSelect ? spec.callbacks.onSelect : spec.callbacks.onSelected;
   if (onListSelect) {
     table.callbacks.onSelect =
-        [callback = std::move(onListSelect)](TableRowInfo const& rowInfo) {
+        [callback = std::move(onListSelect), items](TableRowInfo const& rowInfo) {
           ListRowInfo listInfo;
           listInfo.rowIndex = rowInfo.rowIndex;
-          if (!rowInfo.row.empty()) {
-            listInfo.item = rowInfo.row.front();
+          if (rowInfo.rowIndex >= 0) {
+            listInfo.item = items->item(static_cast<size_t>(rowInfo.rowIndex));
           }
           callback(listInfo);
         };
@@ -0,0 +1,170 @@
+#include "PrimeStage/PrimeStage.h"
+
+#include "PrimeStageCollectionInternals.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace PrimeStage {
+namespace {
+
+constexpr float FocusRingThickness = 2.0f;
+
+// Focus ring receiving focus registrations on this thread; set between beginBuild and endBuild.
+thread_local FocusRing* activeRing = nullptr;
+
+} // namespace
+
+namespace Internal {
+
+FocusRing* activeFocusRing() {
+  return activeRing;
+}
+
+std::vector<InternalRect> focusRingEdges(float width, float height) {
+  std::vector<InternalRect> edges;
+  if (width <= 0.0f || height <= 0.0f) {
+    return edges;
+  }
+  float maxThickness = std::min(width, height) * 0.5f;
+  float thickness = std::clamp(FocusRingThickness, 1.0f, maxThickness);
+  float sideHeight = std::max(0.0f, height - thickness * 2.0f);
+  std::array<InternalRect, 4> candidates{
+      InternalRect{0.0f, 0.0f, width, thickness},
+      InternalRect{0.0f, std::max(0.0f, height - thickness), width, thickness},
+      InternalRect{0.0f, thickness, thickness, sideHeight},
+      InternalRect{std::max(0.0f, width - thickness), thickness, thickness, sideHeight},
+  };
+  for (InternalRect const& rect : candidates) {
+    if (rect.width > 0.0f && rect.height > 0.0f) {
+      edges.push_back(rect);
+    }
+  }
+  return edges;
+}
+
+} // namespace Internal
+
+FocusRing::~FocusRing() {
+  endBuild();
+}
+
+void FocusRing::beginBuild() {
+  if (!active_) {
+    previousActive_ = activeRing;
+    activeRing = this;
+    active_ = true;
+  }
+}
+
+void FocusRing::endBuild() {
+  if (active_) {
+    if (activeRing == this) {
+      activeRing = previousActive_;
+    }
+    previousActive_ = nullptr;
+    active_ = false;
+  }
+}
+
+void FocusRing::hide(PrimeFrame::NodeId node) {
+  if (target_ && target_->node == node) {
+    target_.reset();
+  }
+}
+
+void FocusRing::appendDrawCommands(PrimeFrame::Frame& frame,
+                                   PrimeFrame::LayoutOutput const& layout,
+                                   PrimeFrame::NodeId focusedNode,
+                                   std::vector<PrimeFrame::DrawCommand>& out) const {
+  if (!target_ || target_->node != focusedNode) {
+    return;
+  }
+  PrimeFrame::LayoutOut const* nodeOut = layout.get(target_->node);
+  if (!nodeOut) {
+    return;
+  }
+
+  // The overlay nodes this replaces were children of the focused node, so they inherited its
+  // visibility and every clipping ancestor, the node itself included.
+  bool clipped = false;
+  float clipX0 = 0.0f;
+  float clipY0 = 0.0f;
+  float clipX1 = 0.0f;
+  float clipY1 = 0.0f;
+  for (PrimeFrame::NodeId id = target_->node; id.isValid();) {
+    PrimeFrame::Node const* node = frame.getNode(id);
+    if (!node) {
+      break;
+    }
+    if (!node->visible) {
+      return;
+    }
+    if (node->clipChildren) {
+      if (PrimeFrame::LayoutOut const* clipOut = layout.get(id)) {
+        float x0 = clipOut->absX;
+        float y0 = clipOut->absY;
+        float x1 = clipOut->absX + clipOut->absW;
+        float y1 = clipOut->absY + clipOut->absH;
+        if (clipped) {
+          x0 = std::max(x0, clipX0);
+          y0 = std::max(y0, clipY0);
+          x1 = std::min(x1, clipX1);
+          y1 = std::min(y1, clipY1);
+        }
+        clipX0 = x0;
+        clipY0 = y0;
+        clipX1 = x1;
+        clipY1 = y1;
+        clipped = true;
+      }
+    }
+    id = node->parent;
+  }
+  if (clipped && (clipX1 <= clipX0 || clipY1 <= clipY0)) {
+    return;
+  }
+
+  PrimeFrame::Color fill{};
+  float opacity = 1.0f;
+  if (PrimeFrame::Theme const* theme = frame.getTheme(PrimeFrame::DefaultThemeId)) {
+    size_t styleIndex = static_cast<size_t>(target_->token);
+    if (styleIndex < theme->rectStyles.size()) {
+      PrimeFrame::RectStyle const& style = theme->rectStyles[styleIndex];
+      if (static_cast<size_t>(style.fill) < theme->palette.size()) {
+        fill = theme->palette[style.fill];
+      }
+      opacity = style.opacity;
+    }
+  }
+  if (target_->overrideStyle.fill.has_value()) {
+    fill = *target_->overrideStyle.fill;
+  }
+  if (target_->overrideStyle.opacity.has_value()) {
+    opacity = *target_->overrideStyle.opacity;
+  }
+
+  float originX = nodeOut->absX + target_->x;
+  float originY = nodeOut->absY + target_->y;
+  for (Internal::InternalRect const& edge : Internal::focusRingEdges(target_->width, target_->height)) {
+    PrimeFrame::DrawCommand command;
+    command.type = PrimeFrame::CommandType::Rect;
+    command.x0 = static_cast<int>(std::lround(originX + edge.x));
+    command.y0 = static_cast<int>(std::lround(originY + edge.y));
+    command.x1 = static_cast<int>(std::lround(originX + edge.x + edge.width));
+    command.y1 = static_cast<int>(std::lround(originY + edge.y + edge.height));
+    command.rectStyle.fill = fill;
+    command.rectStyle.opacity = opacity;
+    if (clipped) {
+      command.clipEnabled = true;
+      command.clip.x0 = static_cast<int>(std::lround(clipX0));
+      command.clip.y0 = static_cast<int>(std::lround(clipY0));
+      command.clip.x1 = static_cast<int>(std::lround(clipX1));
+      command.clip.y1 = static_cast<int>(std::lround(clipY1));
+    }
+    out.push_back(command);
+  }
+}
+
+} // namespace PrimeStage
@@ -1,32 +1,38 @@
 #include "PrimeStage/PrimeStage.h"
+#include "PrimeStageBuildTaskPool.h"
+#include "PrimeStageCollectionInternals.h"
 #include "PrimeFrame/Focus.h"
 
 #include <cstdio>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace PrimeStage {
 
 struct CallbackReentryScope {
-  explicit CallbackReentryScope(std::shared_ptr<bool> state)
-      : state_(std::move(state)) {
-    if (!state_ || *state_) {
+  explicit CallbackReentryScope(bool& state)
+      : state_(state) {
+    if (state_) {
       return;
     }
-    *state_ = true;
+    state_ = true;
     entered_ = true;
   }
 
   ~CallbackReentryScope() {
-    if (entered_ && state_) {
-      *state_ = false;
+    if (entered_) {
+      state_ = false;
     }
   }
 
+  CallbackReentryScope(CallbackReentryScope const&) = delete;
+  CallbackReentryScope& operator=(CallbackReentryScope const&) = delete;
+
   bool entered() const { return entered_; }
 
 private:
-  std::shared_ptr<bool> state_;
+  bool& state_;
   bool entered_ = false;
 };
 
@@ -40,6 +46,137 @@ void report_callback_reentry(char const* callbackName) {
 #endif
 }
 
+// Flattened per-node handler storage. Each callback slot keeps its handlers in
+// append order plus a single reentry flag, so dispatch is one loop instead of a
+// chain of nested std::function wrappers. Handlers appended to a slot while it
+// is dispatching are staged and merged once the outermost dispatch returns.
+template <typename Fn>
+struct NodeHandlerSlot {
+  std::vector<Fn> handlers;
+  std::vector<Fn> pending;
+  bool dispatching = false;
+
+  void append(Fn handler) {
+    if (dispatching) {
+      pending.push_back(std::move(handler));
+      return;
+    }
+    handlers.push_back(std::move(handler));
+  }
+
+  void mergePending() {
+    if (pending.empty()) {
+      return;
+    }
+    for (Fn& handler : pending) {
+      handlers.push_back(std::move(handler));
+    }
+    pending.clear();
+  }
+
+  void clear() {
+    handlers.clear();
+    pending.clear();
+  }
+};
+
+struct NodeHandlerList {
+  NodeHandlerSlot<std::function<bool(PrimeFrame::Event const&)>> onEvent;
+  NodeHandlerSlot<std::function<void()>> onFocus;
+  NodeHandlerSlot<std::function<void()>> onBlur;
+};
+
+// Slot dispatchers are distinct functor types so an installed slot can be
+// recognized through std::function::target and appended to in place.
+struct NodeEventDispatcher {
+  std::shared_ptr<NodeHandlerList> list;
+
+  bool operator()(PrimeFrame::Event const& event) const {
+    auto& slot = list->onEvent;
+    bool handled = false;
+    {
+      CallbackReentryScope reentryGuard(slot.dispatching);
+      if (!reentryGuard.entered()) {
+        report_callback_reentry("onEvent");
+        return false;
+      }
+      // Newest handler runs first; the first handler that consumes the event wins.
+      for (size_t index = slot.handlers.size(); index > 0u; --index) {
+        auto const& handler = slot.handlers[index - 1u];
+        if (handler && handler(event)) {
+          handled = true;
+          break;
+        }
+      }
+    }
+    slot.mergePending();
+    return handled;
+  }
+};
+
+struct NodeFocusDispatcher {
+  std::shared_ptr<NodeHandlerList> list;
+
+  void operator()() const {
+    auto& slot = list->onFocus;
+    {
+      CallbackReentryScope reentryGuard(slot.dispatching);
+      if (!reentryGuard.entered()) {
+        report_callback_reentry("onFocus");
+        return;
+      }
+      for (auto const& handler : slot.handlers) {
+        if (handler) {
+          handler();
+        }
+      }
+    }
+    slot.mergePending();
+  }
+};
+
+struct NodeBlurDispatcher {
+  std::shared_ptr<NodeHandlerList> list;
+
+  void operator()() const {
+    auto& slot = list->onBlur;
+    {
+      CallbackReentryScope reentryGuard(slot.dispatching);
+      if (!reentryGuard.entered()) {
+        report_callback_reentry("onBlur");
+        return;
+      }
+      for (auto const& handler : slot.handlers) {
+        if (handler) {
+          handler();
+        }
+      }
+    }
+    slot.mergePending();
+  }
+};
+
+static std::shared_ptr<NodeHandlerList> findNodeHandlerList(PrimeFrame::Callback const& callback) {
+  if (auto const* dispatcher = callback.onEvent.target<NodeEventDispatcher>()) {
+    return dispatcher->list;
+  }
+  if (auto const* dispatcher = callback.onFocus.target<NodeFocusDispatcher>()) {
+    return dispatcher->list;
+  }
+  if (auto const* dispatcher = callback.onBlur.target<NodeBlurDispatcher>()) {
+    return dispatcher->list;
+  }
+  return {};
+}
+
+static std::shared_ptr<NodeHandlerList> ensureNodeHandlerList(PrimeFrame::Callback& callback) {
+  std::shared_ptr<NodeHandlerList> list = findNodeHandlerList(callback);
+  if (!list) {
+    list = std::make_shared<NodeHandlerList>();
+  }
+  return list;
+}
+
 LowLevel::NodeCallbackHandle::NodeCallbackHandle(PrimeFrame::Frame& frame,
                                                  PrimeFrame::NodeId nodeId,
                                                  LowLevel::NodeCallbackTable callbackTable) {
@@ -87,10 +224,22 @@ bool LowLevel::NodeCallbackHandle::bind(PrimeFrame::Frame& frame,
     return false;
   }
   previousCallbackId_ = node->callbacks;
+  // The scoped table is installed as a fresh handler list so helpers appended
+  // while the handle is active flatten into it and drop with it on reset().
+  std::shared_ptr<NodeHandlerList> list = std::make_shared<NodeHandlerList>();
   PrimeFrame::Callback callback;
-  callback.onEvent = std::move(callbackTable.onEvent);
-  callback.onFocus = std::move(callbackTable.onFocus);
-  callback.onBlur = std::move(callbackTable.onBlur);
+  if (callbackTable.onEvent) {
+    list->onEvent.append(std::move(callbackTable.onEvent));
+    callback.onEvent = NodeEventDispatcher{list};
+  }
+  if (callbackTable.onFocus) {
+    list->onFocus.append(std::move(callbackTable.onFocus));
+    callback.onFocus = NodeFocusDispatcher{list};
+  }
+  if (callbackTable.onBlur) {
+    list->onBlur.append(std::move(callbackTable.onBlur));
+    callback.onBlur = NodeBlurDispatcher{list};
+  }
   node->callbacks = frame.addCallback(std::move(callback));
   frame_ = &frame;
   nodeId_ = nodeId;
@@ -143,25 +292,16 @@ bool LowLevel::appendNodeOnEvent(PrimeFrame::Frame& frame,
   if (!callback) {
     return false;
   }
-  auto previous = callback->onEvent;
-  std::shared_ptr<bool> reentryState = std::make_shared<bool>(false);
-  callback->onEvent = [handler = std::move(onEvent),
-                       previous = std::move(previous),
-                       reentryState = std::move(reentryState)](
-                          PrimeFrame::Event const& event) -> bool {
-    CallbackReentryScope reentryGuard(reentryState);
-    if (!reentryGuard.entered()) {
-      report_callback_reentry("onEvent");
-      return false;
+  std::shared_ptr<NodeHandlerList> list = ensureNodeHandlerList(*callback);
+  if (!callback->onEvent.target<NodeEventDispatcher>()) {
+    // Adopt a directly assigned handler as the oldest entry of the slot.
+    list->onEvent.clear();
+    if (callback->onEvent) {
+      list->onEvent.append(std::move(callback->onEvent));
     }
-    if (handler && handler(event)) {
-      return true;
-    }
-    if (previous) {
-      return previous(event);
-    }
-    return false;
-  };
+    callback->onEvent = NodeEventDispatcher{list};
+  }
+  list->onEvent.append(std::move(onEvent));
   return true;
 }
 
@@ -175,23 +315,15 @@ bool LowLevel::appendNodeOnFocus(PrimeFrame::Frame& frame,
   if (!callback) {
     return false;
   }
-  auto previous = callback->onFocus;
-  std::shared_ptr<bool> reentryState = std::make_shared<bool>(false);
-  callback->onFocus = [handler = std::move(onFocus),
-                       previous = std::move(previous),
-                       reentryState = std::move(reentryState)]() {
-    CallbackReentryScope reentryGuard(reentryState);
-    if (!reentryGuard.entered()) {
-      report_callback_reentry("onFocus");
-      return;
-    }
-    if (previous) {
-      previous();
+  std::shared_ptr<NodeHandlerList> list = ensureNodeHandlerList(*callback);
+  if (!callback->onFocus.target<NodeFocusDispatcher>()) {
+    list->onFocus.clear();
+    if (callback->onFocus) {
+      list->onFocus.append(std::move(callback->onFocus));
     }
-    if (handler) {
-      handler();
-    }
-  };
+    callback->onFocus = NodeFocusDispatcher{list};
+  }
+  list->onFocus.append(std::move(onFocus));
   return true;
 }
 
@@ -205,23 +337,15 @@ bool LowLevel::appendNodeOnBlur(PrimeFrame::Frame& frame,
   if (!callback) {
     return false;
   }
-  auto previous = callback->onBlur;
-  std::shared_ptr<bool> reentryState = std::make_shared<bool>(false);
-  callback->onBlur = [handler = std::move(onBlur),
-                      previous = std::move(previous),
-                      reentryState = std::move(reentryState)]() {
-    CallbackReentryScope reentryGuard(reentryState);
-    if (!reentryGuard.entered()) {
-      report_callback_reentry("onBlur");
-      return;
-    }
-    if (previous) {
-      previous();
-    }
-    if (handler) {
-      handler();
+  std::shared_ptr<NodeHandlerList> list = ensureNodeHandlerList(*callback);
+  if (!callback->onBlur.target<NodeBlurDispatcher>()) {
+    list->onBlur.clear();
+    if (callback->onBlur) {
+      list->onBlur.append(std::move(callback->onBlur));
     }
-  };
+    callback->onBlur = NodeBlurDispatcher{list};
+  }
+  list->onBlur.append(std::move(onBlur));
   return true;
 }
 
@@ -316,5 +440,391 @@ bool WidgetIdentityReconciler::restoreFocus(PrimeFrame::FocusManager& focus,
   return focus.setFocus(frame, layout, nodeId);
 }
 
+namespace {
+
+// Memo cache receiving UiNode::memo calls on this thread; set between beginRebuild and endRebuild.
+thread_local UiMemoCache* activeMemoCache = nullptr;
+// Queue receiving UiNode::deferred calls on this thread; set while a progressive build collects.
+thread_local ProgressiveBuildQueue* activeBuildQueue = nullptr;
+// Style table serving text lookups on this thread; set between beginBuild and endBuild.
+thread_local ThemeStyleTable* activeStyleTable = nullptr;
+
+bool memo_nodes_valid(PrimeFrame::Frame& frame, std::vector<PrimeFrame::NodeId> const& nodes) {
+  for (PrimeFrame::NodeId nodeId : nodes) {
+    if (!frame.getNode(nodeId)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+UiMemoCache::~UiMemoCache() {
+  if (active_ && activeMemoCache == this) {
+    activeMemoCache = previousActive_;
+  }
+}
+
+void UiMemoCache::beginRebuild(PrimeFrame::Frame& frame, PrimeFrame::NodeId rootId) {
+  if (frame_ != &frame) {
+    entries_.clear();
+  }
+  frame_ = &frame;
+  reusedCount_ = 0u;
+  buildStack_.clear();
+  for (auto& [key, entry] : entries_) {
+    entry.used = false;
+    // Nested entries stay inside their enclosing subtree; only top-level ones float.
+    if (entry.parentKey == InvalidWidgetIdentityId) {
+      detach(entry);
+    }
+  }
+  if (PrimeFrame::Node* root = frame.getNode(rootId)) {
+    std::vector<PrimeFrame::NodeId> children = root->children;
+    for (PrimeFrame::NodeId child : children) {
+      frame.removeChild(rootId, child);
+      (void)frame.destroyNode(child);
+    }
+  }
+  if (!active_) {
+    previousActive_ = activeMemoCache;
+    activeMemoCache = this;
+    active_ = true;
+  }
+}
+
+void UiMemoCache::endRebuild() {
+  if (active_) {
+    if (activeMemoCache == this) {
+      activeMemoCache = previousActive_;
+    }
+    previousActive_ = nullptr;
+    active_ = false;
+  }
+  buildStack_.clear();
+  if (!frame_) {
+    return;
+  }
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (it->second.used) {
+      ++it;
+      continue;
+    }
+    destroy(it->second);
+    it = entries_.erase(it);
+  }
+}
+
+void UiMemoCache::clear() {
+  entries_.clear();
+  buildStack_.clear();
+  reusedCount_ = 0u;
+  frame_ = nullptr;
+}
+
+void UiMemoCache::detach(Entry const& entry) {
+  for (PrimeFrame::NodeId nodeId : entry.nodes) {
+    PrimeFrame::Node* node = frame_->getNode(nodeId);
+    if (node && node->parent.isValid()) {
+      frame_->removeChild(node->parent, nodeId);
+    }
+  }
+}
+
+void UiMemoCache::destroy(Entry const& entry) {
+  detach(entry);
+  for (PrimeFrame::NodeId nodeId : entry.nodes) {
+    if (frame_->getNode(nodeId)) {
+      (void)frame_->destroyNode(nodeId);
+    }
+  }
+}
+
+void UiMemoCache::release(WidgetIdentityId key) {
+  // Nested sections of a stale subtree float free so they can still be reused by this build.
+  for (auto& [childKey, child] : entries_) {
+    if (child.parentKey == key) {
+      detach(child);
+      child.parentKey = InvalidWidgetIdentityId;
+    }
+  }
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return;
+  }
+  destroy(it->second);
+  entries_.erase(it);
+}
+
+void UiMemoCache::markNestedUsed(WidgetIdentityId key) {
+  for (auto& [childKey, child] : entries_) {
+    if (child.parentKey == key && !child.used) {
+      child.used = true;
+      markNestedUsed(childKey);
+    }
+  }
+}
+
+void UiMemoCache::memo(UiNode& parent,
+                       WidgetIdentityId key,
+                       uint64_t dependencyHash,
+                       std::function<void(UiNode&)> const& builder) {
+  PrimeFrame::Frame& frame = *frame_;
+  WidgetIdentityId enclosing = buildStack_.empty() ? InvalidWidgetIdentityId : buildStack_.back();
+  auto it = entries_.find(key);
+  if (it != entries_.end() && it->second.used) {
+#if !defined(NDEBUG)
+    std::fprintf(stderr, "PrimeStage memo: duplicate key in one rebuild; section built uncached\n");
+#endif
+    builder(parent);
+    return;
+  }
+  if (it != entries_.end() && it->second.dependencyHash == dependencyHash &&
+      memo_nodes_valid(frame, it->second.nodes)) {
+    Entry& entry = it->second;
+    detach(entry);
+    for (PrimeFrame::NodeId nodeId : entry.nodes) {
+      frame.addChild(parent.nodeId(), nodeId);
+    }
+    entry.parentKey = enclosing;
+    entry.used = true;
+    markNestedUsed(key);
+    reusedCount_ += 1u;
+    return;
+  }
+  if (it != entries_.end()) {
+    release(key);
+  }
+
+  PrimeFrame::Node const* parentNode = frame.getNode(parent.nodeId());
+  size_t firstChild = parentNode ? parentNode->children.size() : 0u;
+  buildStack_.push_back(key);
+  try {
+    builder(parent);
+  } catch (...) {
+    buildStack_.pop_back();
+    throw;
+  }
+  buildStack_.pop_back();
+
+  Entry entry;
+  entry.dependencyHash = dependencyHash;
+  entry.parentKey = enclosing;
+  entry.used = true;
+  parentNode = frame.getNode(parent.nodeId());
+  if (parentNode) {
+    for (size_t index = firstChild; index < parentNode->children.size(); ++index) {
+      entry.nodes.push_back(parentNode->children[index]);
+    }
+  }
+  entries_[key] = std::move(entry);
+}
+
+UiNode& UiNode::memo(std::string_view key,
+                     uint64_t dependencyHash,
+                     std::function<void(UiNode&)> const& builder) {
+  if (!builder) {
+    return *this;
+  }
+  WidgetIdentityId keyId = widgetIdentityId(key);
+  UiMemoCache* cache = activeMemoCache;
+  if (!cache || cache->frame_ != &frame() || keyId == InvalidWidgetIdentityId) {
+    builder(*this);
+    return *this;
+  }
+  cache->memo(*this, keyId, dependencyHash, builder);
+  return *this;
+}
+
+ThemeStyleTable::~ThemeStyleTable() {
+  endBuild();
+}
+
+void ThemeStyleTable::beginBuild(PrimeFrame::Frame& frame) {
+  frame_ = &frame;
+  compiled_ = false;
+  if (!active_) {
+    previousActive_ = activeStyleTable;
+    activeStyleTable = this;
+    active_ = true;
+  }
+}
+
+void ThemeStyleTable::endBuild() {
+  if (active_) {
+    if (activeStyleTable == this) {
+      activeStyleTable = previousActive_;
+    }
+    previousActive_ = nullptr;
+    active_ = false;
+  }
+}
+
+void ThemeStyleTable::compile(PrimeFrame::Theme const& theme) {
+  text_.clear();
+  text_.reserve(theme.textStyles.size());
+  for (size_t index = 0u; index < theme.textStyles.size(); ++index) {
+    TextEntry entry;
+    entry.style = PrimeFrame::resolveTextStyle(
+        theme, static_cast<PrimeFrame::TextStyleToken>(index), {});
+    entry.lineHeight = entry.style.lineHeight > 0.0f ? entry.style.lineHeight : entry.style.size * 1.2f;
+    text_.push_back(entry);
+  }
+  theme_ = &theme;
+  textStyles_ = theme.textStyles.data();
+  textStyleCount_ = theme.textStyles.size();
+  compiled_ = true;
+  compileCount_ += 1u;
+}
+
+ThemeStyleTable::TextEntry const* ThemeStyleTable::text(PrimeFrame::TextStyleToken token) {
+  if (!frame_) {
+    return nullptr;
+  }
+  PrimeFrame::Theme const* theme = frame_->getTheme(PrimeFrame::DefaultThemeId);
+  if (!theme) {
+    return nullptr;
+  }
+  // Replaced style vectors recompile without an explicit invalidate().
+  if (!compiled_ || theme != theme_ || theme->textStyles.data() != textStyles_ ||
+      theme->textStyles.size() != textStyleCount_) {
+    compile(*theme);
+  }
+  size_t index = static_cast<size_t>(token);
+  return index < text_.size() ? &text_[index] : nullptr;
+}
+
+namespace Internal {
+
+std::optional<ThemeStyleTable::TextEntry> resolveTextEntry(PrimeFrame::Frame& frame,
+                                                           PrimeFrame::TextStyleToken token) {
+  ThemeStyleTable* table = activeStyleTable;
+  if (table && table->frame() == &frame) {
+    if (ThemeStyleTable::TextEntry const* entry = table->text(token)) {
+      return *entry;
+    }
+  }
+  PrimeFrame::Theme const* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
+  if (!theme) {
+    return std::nullopt;
+  }
+  ThemeStyleTable::TextEntry entry;
+  entry.style = PrimeFrame::resolveTextStyle(*theme, token, {});
+  entry.lineHeight = entry.style.lineHeight > 0.0f ? entry.style.lineHeight : entry.style.size * 1.2f;
+  return entry;
+}
+
+void invalidateThemeStyles(PrimeFrame::Frame const& frame) {
+  ThemeStyleTable* table = activeStyleTable;
+  if (table && table->frame() == &frame) {
+    table->invalidate();
+  }
+}
+
+} // namespace Internal
+
+ProgressiveBuildQueue::~ProgressiveBuildQueue() {
+  deactivate();
+}
+
+void ProgressiveBuildQueue::activate() {
+  if (!active_) {
+    previousActive_ = activeBuildQueue;
+    activeBuildQueue = this;
+    active_ = true;
+  }
+}
+
+void ProgressiveBuildQueue::deactivate() {
+  if (active_) {
+    if (activeBuildQueue == this) {
+      activeBuildQueue = previousActive_;
+    }
+    previousActive_ = nullptr;
+    active_ = false;
+  }
+}
+
+void ProgressiveBuildQueue::begin(PrimeFrame::Frame& frame) {
+  jobs_.clear();
+  frame_ = &frame;
+  activate();
+}
+
+void ProgressiveBuildQueue::end() {
+  deactivate();
+}
+
+size_t ProgressiveBuildQueue::run(Clock::duration budget) {
+  if (!frame_ || jobs_.empty()) {
+    return 0u;
+  }
+  bool wasActive = active_;
+  activate();
+  Clock::time_point deadline = Clock::now() + budget;
+  size_t ran = 0u;
+  try {
+    do {
+      Job job = std::move(jobs_.front());
+      jobs_.pop_front();
+      // Sections whose placeholder was removed since they were queued are dropped.
+      if (frame_->getNode(job.section)) {
+        UiNode section(*frame_, job.section, job.allowAbsolute);
+        job.builder(section);
+      }
+      ran += 1u;
+    } while (!jobs_.empty() && Clock::now() < deadline);
+  } catch (...) {
+    if (!wasActive) {
+      deactivate();
+    }
+    throw;
+  }
+  if (!wasActive) {
+    deactivate();
+  }
+  return ran;
+}
+
+void ProgressiveBuildQueue::clear() {
+  jobs_.clear();
+  frame_ = nullptr;
+}
+
+UiNode UiNode::deferred(StackSpec const& placeholder, std::function<void(UiNode&)> builder) {
+  UiNode section = createVerticalStack(placeholder);
+  if (!builder) {
+    return section;
+  }
+  ProgressiveBuildQueue* queue = activeBuildQueue;
+  if (!queue || queue->frame_ != &frame()) {
+    builder(section);
+    return section;
+  }
+  queue->jobs_.push_back({section.nodeId(), section.allowAbsolute(), std::move(builder)});
+  return section;
+}
+
+UiNode& UiNode::prepareInParallel(std::span<ParallelSection const> sections) {
+  auto prepare = [sections](size_t index) {
+    if (sections[index].prepare) {
+      sections[index].prepare();
+    }
+  };
+  if (Internal::BuildTaskPool* pool = Internal::activeBuildTaskPool()) {
+    pool->run(sections.size(), prepare);
+  } else {
+    for (size_t index = 0u; index < sections.size(); ++index) {
+      prepare(index);
+    }
+  }
+  for (ParallelSection const& section : sections) {
+    if (section.build) {
+      section.build(*this);
+    }
+  }
+  return *this;
+}
 
 } // namespace PrimeStage
@@ -1,10 +1,12 @@
 #include "PrimeStage/PrimeStage.h"
 
-#include "PrimeStageCollectionInternals.h"
+#include "PrimeStageTableInternals.h"
 #include "PrimeFrame/Events.h"
 
 #include <algorithm>
 #include <memory>
+#include <optional>
+#include <span>
 #include <utility>
 
 namespace PrimeStage {
@@ -16,65 +18,87 @@ constexpr int TableKeyHome = keyCodeInt(KeyCode::Home);
 constexpr int TableKeyEnd = keyCodeInt(KeyCode::End);
 
 UiNode UiNode::createTable(TableSpec const& specInput) {
-  TableSpec spec = Internal::normalizeTableSpec(specInput);
+  Internal::NormalizedTableSpec normalized = Internal::normalizeTableSpec(specInput);
+  TableSpec const& spec = specInput;
   bool enabled = spec.enabled;
   Internal::WidgetRuntimeContext runtime = Internal::makeWidgetRuntimeContext(frame(),
                                                                               nodeId(),
                                                                               allowAbsolute(),
                                                                               enabled,
                                                                               spec.visible,
-                                                                              spec.tabIndex);
+                                                                              normalized.tabIndex);
   PrimeFrame::Frame& runtimeFrame = Internal::runtimeFrame(runtime);
 
-  Internal::InternalRect tableBounds = Internal::resolveRect(spec.size);
-  size_t rowCount = spec.rows.size();
+  auto interaction = std::make_shared<Internal::TableInteractionState>();
+  interaction->columnCount = spec.columns.size();
+  if (spec.dataSource.cell) {
+    interaction->source = spec.dataSource;
+  } else {
+    Internal::copyTableRows(*interaction, spec.rows);
+  }
+
+  Internal::InternalRect tableBounds = Internal::resolveRect(normalized.size);
+  size_t rowCount = normalized.rowCount;
+  // Widest text per auto-sized column, measured at most once per build.
+  TableColumnWidthCache localWidthCache;
+  TableColumnWidthCache& widthCache = spec.widthCache ? *spec.widthCache : localWidthCache;
+  std::optional<std::span<float const>> autoTextWidths;
+  auto auto_text_widths = [&]() {
+    if (!autoTextWidths) {
+      Internal::TableInteractionState const* rows = interaction.get();
+      autoTextWidths = widthCache.measure(frame(),
+                                          spec.columns,
+                                          spec.autoWidth,
+                                          spec.modelRevision,
+                                          rowCount,
+                                          [rows](size_t row, size_t column) {
+                                            return rows->cell(row, column);
+                                          });
+    }
+    return *autoTextWidths;
+  };
   float rowsHeight = 0.0f;
   if (rowCount > 0) {
-    rowsHeight = static_cast<float>(rowCount) * spec.rowHeight +
-                 static_cast<float>(rowCount - 1) * spec.rowGap;
+    rowsHeight = static_cast<float>(rowCount) * normalized.rowHeight +
+                 static_cast<float>(rowCount - 1) * normalized.rowGap;
   }
-  float headerBlock = spec.headerHeight > 0.0f ? spec.headerInset + spec.headerHeight : 0.0f;
-  if (tableBounds.height <= 0.0f && !spec.size.preferredHeight.has_value() && spec.size.stretchY <= 0.0f) {
+  float headerBlock =
+      normalized.headerHeight > 0.0f ? normalized.headerInset + normalized.headerHeight : 0.0f;
+  // A virtualized table falls back to the default height instead of growing to fit its rows.
+  if (tableBounds.height <= 0.0f &&
+      !normalized.size.preferredHeight.has_value() &&
+      normalized.size.stretchY <= 0.0f &&
+      !spec.virtualized) {
     tableBounds.height = headerBlock + rowsHeight;
   }
   if (tableBounds.width <= 0.0f &&
-      !spec.size.preferredWidth.has_value() &&
-      spec.size.stretchX <= 0.0f &&
+      !normalized.size.preferredWidth.has_value() &&
+      normalized.size.stretchX <= 0.0f &&
       !spec.columns.empty()) {
     float inferredWidth = 0.0f;
-    float paddingX = std::max(spec.headerPaddingX, spec.cellPaddingX);
+    float paddingX = std::max(normalized.headerPaddingX, normalized.cellPaddingX);
     for (size_t colIndex = 0; colIndex < spec.columns.size(); ++colIndex) {
       TableColumn const& col = spec.columns[colIndex];
       if (col.width > 0.0f) {
         inferredWidth += col.width;
         continue;
       }
-      float maxText = Internal::estimateTextWidth(frame(), col.headerStyle, col.label);
-      for (auto const& row : spec.rows) {
-        if (colIndex < row.size()) {
-          std::string_view cell = row[colIndex];
-          float cellWidth = Internal::estimateTextWidth(frame(), col.cellStyle, cell);
-          if (cellWidth > maxText) {
-            maxText = cellWidth;
-          }
-        }
-      }
-      inferredWidth += maxText + paddingX;
+      inferredWidth += auto_text_widths()[colIndex] + paddingX;
     }
     tableBounds.width = inferredWidth;
   }
   if (tableBounds.width <= 0.0f &&
-      !spec.size.preferredWidth.has_value() &&
-      spec.size.stretchX <= 0.0f) {
+      !normalized.size.preferredWidth.has_value() &&
+      normalized.size.stretchX <= 0.0f) {
     tableBounds.width = Internal::defaultCollectionWidth();
   }
   if (tableBounds.height <= 0.0f &&
-      !spec.size.preferredHeight.has_value() &&
-      spec.size.stretchY <= 0.0f) {
+      !normalized.size.preferredHeight.has_value() &&
+      normalized.size.stretchY <= 0.0f) {
     tableBounds.height = Internal::defaultCollectionHeight();
   }
 
-  SizeSpec tableSize = spec.size;
+  SizeSpec tableSize = normalized.size;
   if (!tableSize.preferredWidth.has_value() && tableBounds.width > 0.0f) {
     tableSize.preferredWidth = tableBounds.width;
   }
@@ -104,21 +128,6 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
   size_t dividerCount = spec.columns.size() > 1 ? spec.columns.size() - 1 : 0;
   float dividerTotal = dividerWidth * static_cast<float>(dividerCount);
 
-  auto compute_auto_width = [&](size_t colIndex, TableColumn const& col) {
-    float paddingX = std::max(spec.headerPaddingX, spec.cellPaddingX);
-    float maxText = Internal::estimateTextWidth(frame(), col.headerStyle, col.label);
-    for (auto const& row : spec.rows) {
-      if (colIndex < row.size()) {
-        std::string_view cell = row[colIndex];
-        float cellWidth = Internal::estimateTextWidth(frame(), col.cellStyle, cell);
-        if (cellWidth > maxText) {
-          maxText = cellWidth;
-        }
-      }
-    }
-    return maxText + paddingX;
-  };
-
   std::vector<float> columnWidths;
   columnWidths.reserve(spec.columns.size());
   float fixedWidth = 0.0f;
@@ -146,7 +155,8 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
   if (autoCount > 0 && (availableWidth <= fixedWidth || tableWidth <= 0.0f)) {
     for (size_t colIndex = 0; colIndex < columnWidths.size(); ++colIndex) {
       if (columnWidths[colIndex] <= 0.0f) {
-        columnWidths[colIndex] = compute_auto_width(colIndex, spec.columns[colIndex]);
+        float paddingX = std::max(normalized.headerPaddingX, normalized.cellPaddingX);
+        columnWidths[colIndex] = auto_text_widths()[colIndex] + paddingX;
       }
     }
   }
@@ -155,44 +165,12 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
     columnWidths.back() = std::max(0.0f, columnWidths.back() - overflow);
   }
 
-  auto create_cell = [&](UiNode const& rowNode,
-                         float width,
-                         float height,
-                         float paddingX,
-                         std::string_view text,
-                         PrimeFrame::TextStyleToken role) {
-    SizeSpec cellSize;
-    if (width > 0.0f) {
-      cellSize.preferredWidth = width;
-    }
-    if (height > 0.0f) {
-      cellSize.preferredHeight = height;
-    }
-    PrimeFrame::Insets padding{};
-    padding.left = paddingX;
-    padding.right = paddingX;
-    PrimeFrame::NodeId cellId = Internal::createNode(frame(),
-                                                     rowNode.nodeId(),
-                                                     Internal::InternalRect{},
-                                                     &cellSize,
-                                                     PrimeFrame::LayoutType::Overlay,
-                                                     padding,
-                                                     0.0f,
-                                                     false,
-                                                     spec.visible);
-    UiNode cell(frame(), cellId, rowNode.allowAbsolute());
-    SizeSpec textSize;
-    textSize.stretchX = 1.0f;
-    if (height > 0.0f) {
-      textSize.preferredHeight = height;
-    }
-    TextLineSpec textSpec;
-    textSpec.text = text;
-    textSpec.textStyle = role;
-    textSpec.size = textSize;
-    textSpec.visible = spec.visible;
-    cell.createTextLine(textSpec);
-  };
+  Internal::TableRowGeometry geometry;
+  geometry.columnWidths = std::move(columnWidths);
+  geometry.rowHeight = normalized.rowHeight;
+  geometry.rowGap = normalized.rowGap;
+  geometry.cellPaddingX = normalized.cellPaddingX;
+  geometry.dividerWidth = dividerWidth;
 
   if (spec.showHeaderDividers) {
     DividerSpec divider;
@@ -203,39 +181,34 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
     tableNode.createDivider(divider);
   }
 
-  if (spec.headerInset > 0.0f) {
+  if (normalized.headerInset > 0.0f) {
     SizeSpec headerInset;
-    headerInset.preferredHeight = spec.headerInset;
+    headerInset.preferredHeight = normalized.headerInset;
     tableNode.createSpacer(headerInset);
   }
 
-  if (spec.headerHeight > 0.0f && !spec.columns.empty()) {
+  bool hasHeaderRow = normalized.headerHeight > 0.0f && !spec.columns.empty();
+  if (hasHeaderRow) {
     PanelSpec headerPanel;
     headerPanel.rectStyle = spec.headerStyle;
-    headerPanel.layout = PrimeFrame::LayoutType::HorizontalStack;
-    headerPanel.size.preferredHeight = spec.headerHeight;
+    headerPanel.size.preferredHeight = normalized.headerHeight;
     headerPanel.size.stretchX = 1.0f;
     headerPanel.visible = spec.visible;
     UiNode headerRow = tableNode.createPanel(headerPanel);
-
-    for (size_t colIndex = 0; colIndex < spec.columns.size(); ++colIndex) {
-      TableColumn const& col = spec.columns[colIndex];
-      float colWidth = colIndex < columnWidths.size() ? columnWidths[colIndex] : 0.0f;
-      create_cell(headerRow,
-                  colWidth,
-                  spec.headerHeight,
-                  spec.headerPaddingX,
-                  col.label,
-                  col.headerStyle);
-      if (spec.showColumnDividers && colIndex + 1 < spec.columns.size()) {
-        DividerSpec divider;
-        divider.rectStyle = spec.dividerStyle;
-        divider.visible = spec.visible;
-        divider.size.preferredWidth = dividerWidth;
-        divider.size.preferredHeight = spec.headerHeight;
-        headerRow.createDivider(divider);
-      }
+    std::vector<std::string_view> labels;
+    labels.reserve(spec.columns.size());
+    for (TableColumn const& col : spec.columns) {
+      labels.push_back(col.label);
     }
+    Internal::addTableCellPrimitives(runtimeFrame,
+                                     headerRow.nodeId(),
+                                     spec,
+                                     geometry,
+                                     normalized.headerHeight,
+                                     normalized.headerPaddingX,
+                                     true,
+                                     labels,
+                                     nullptr);
   }
 
   if (spec.showHeaderDividers) {
@@ -249,133 +222,141 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
 
   StackSpec rowsSpec;
   rowsSpec.size.stretchX = 1.0f;
-  rowsSpec.size.stretchY = spec.size.stretchY;
-  rowsSpec.gap = spec.rowGap;
+  rowsSpec.size.stretchY = normalized.size.stretchY;
+  rowsSpec.gap = normalized.rowGap;
   rowsSpec.clipChildren = spec.clipChildren;
   rowsSpec.visible = spec.visible;
-  UiNode rowsNode = tableNode.createVerticalStack(rowsSpec);
-  if (PrimeFrame::Node* rowsNodePtr = runtimeFrame.getNode(rowsNode.nodeId())) {
-    rowsNodePtr->hitTestVisible = enabled;
+  float viewportHeight = 0.0f;
+  if (spec.virtualized) {
+    // The pool is sized for the height known now; a stretched table without a preferred height
+    // is pooled for the default collection height.
+    float tableHeight =
+        tableBounds.height > 0.0f ? tableBounds.height : Internal::defaultCollectionHeight();
+    float chromeHeight = normalized.headerInset + (hasHeaderRow ? normalized.headerHeight : 0.0f) +
+                         (spec.showHeaderDividers ? 2.0f : 0.0f);
+    viewportHeight = std::max(0.0f, tableHeight - chromeHeight);
+    rowsSpec.size.preferredHeight = viewportHeight;
   }
+  UiNode rowsNode = spec.virtualized ? tableNode.createOverlay(rowsSpec)
+                                     : tableNode.createVerticalStack(rowsSpec);
 
-  struct TableInteractionState {
-    PrimeFrame::Frame* frame = nullptr;
-    std::vector<PrimeFrame::PrimitiveId> backgrounds;
-    std::vector<PrimeFrame::RectStyleToken> baseStyles;
-    PrimeFrame::RectStyleToken selectionStyle = 0;
-    TableCallbacks callbacks{};
-    std::vector<std::vector<std::string>> ownedRows;
-    std::vector<std::string_view> rowViewScratch;
-    int selectedRow = -1;
-    float rowHeight = 0.0f;
-    float rowGap = 0.0f;
-  };
-
-  auto interaction = std::make_shared<TableInteractionState>();
   interaction->frame = &runtimeFrame;
+  interaction->geometry = geometry;
+  interaction->rowStyle = spec.rowStyle;
+  interaction->rowAltStyle = spec.rowAltStyle;
   interaction->selectionStyle = spec.selectionStyle;
   interaction->callbacks = spec.callbacks;
-  interaction->ownedRows.reserve(spec.rows.size());
-  for (auto const& sourceRow : spec.rows) {
-    std::vector<std::string> ownedRow;
-    ownedRow.reserve(sourceRow.size());
-    for (std::string_view cell : sourceRow) {
-      ownedRow.emplace_back(cell);
+  interaction->viewportNode = rowsNode.nodeId();
+  interaction->rowCount = static_cast<int>(rowCount);
+  interaction->selectedRow = normalized.selectedRow;
+  interaction->overscanRows = normalized.overscanRows;
+  interaction->viewportHeight = viewportHeight;
+  interaction->contentHeight = rowsHeight;
+  interaction->visible = spec.visible;
+  if (spec.virtualized) {
+    interaction->maxScroll = std::max(0.0f, rowsHeight - viewportHeight);
+    interaction->scrollOffset = std::min(normalized.scrollOffset, interaction->maxScroll);
+  }
+  if (PrimeFrame::Node* rowsNodePtr = runtimeFrame.getNode(rowsNode.nodeId())) {
+    rowsNodePtr->hitTestVisible = enabled;
+    if (spec.virtualized) {
+      rowsNodePtr->isViewport = true;
+      rowsNodePtr->scrollY = interaction->scrollOffset;
     }
-    interaction->ownedRows.push_back(std::move(ownedRow));
   }
-  interaction->selectedRow = spec.selectedRow;
-  interaction->rowHeight = spec.rowHeight;
-  interaction->rowGap = spec.rowGap;
-  interaction->backgrounds.reserve(rowCount);
-  interaction->baseStyles.reserve(rowCount);
-  std::vector<PrimeFrame::NodeId> rowNodeIds;
-  rowNodeIds.reserve(rowCount);
-
-  for (size_t rowIndex = 0; rowIndex < rowCount; ++rowIndex) {
-    PrimeFrame::RectStyleToken rowRole = (rowIndex % 2 == 0) ? spec.rowAltStyle : spec.rowStyle;
-    if (spec.selectionStyle != 0 && static_cast<int>(rowIndex) == spec.selectedRow) {
-      rowRole = spec.selectionStyle;
+
+  auto applyScroll = [interaction](float offset) {
+    float clamped = std::clamp(offset, 0.0f, interaction->maxScroll);
+    if (clamped == interaction->scrollOffset) {
+      return;
     }
-    PanelSpec rowPanel;
-    rowPanel.rectStyle = rowRole;
-    rowPanel.layout = PrimeFrame::LayoutType::HorizontalStack;
-    rowPanel.size.preferredHeight = spec.rowHeight;
-    rowPanel.size.stretchX = 1.0f;
-    rowPanel.visible = spec.visible;
-    UiNode rowNode = rowsNode.createPanel(rowPanel);
-    rowNodeIds.push_back(rowNode.nodeId());
-    if (PrimeFrame::Node* rowNodePtr = runtimeFrame.getNode(rowNode.nodeId())) {
-      if (!rowNodePtr->primitives.empty()) {
-        interaction->backgrounds.push_back(rowNodePtr->primitives.front());
-      } else {
-        interaction->backgrounds.push_back(0);
-      }
-    } else {
-      interaction->backgrounds.push_back(0);
+    interaction->scrollOffset = clamped;
+    if (PrimeFrame::Node* viewport = interaction->frame->getNode(interaction->viewportNode)) {
+      viewport->scrollY = clamped;
+    }
+    LayoutRequestScope::request();
+    Internal::syncTableRowWindow(*interaction);
+    if (interaction->callbacks.onScrollChanged) {
+      TableScrollInfo info;
+      info.offset = clamped;
+      info.maxOffset = interaction->maxScroll;
+      info.progress = interaction->maxScroll > 0.0f ? clamped / interaction->maxScroll : 0.0f;
+      info.viewportHeight = interaction->viewportHeight;
+      info.contentHeight = interaction->contentHeight;
+      interaction->callbacks.onScrollChanged(info);
     }
-    interaction->baseStyles.push_back((rowIndex % 2 == 0) ? spec.rowAltStyle : spec.rowStyle);
+  };
 
-    for (size_t colIndex = 0; colIndex < spec.columns.size(); ++colIndex) {
-      TableColumn const& col = spec.columns[colIndex];
-      float colWidth = colIndex < columnWidths.size() ? columnWidths[colIndex] : 0.0f;
-      std::string_view cellText;
-      if (rowIndex < spec.rows.size() && colIndex < spec.rows[rowIndex].size()) {
-        cellText = spec.rows[rowIndex][colIndex];
-      }
-      create_cell(rowNode,
-                  colWidth,
-                  spec.rowHeight,
-                  spec.cellPaddingX,
-                  cellText,
-                  col.cellStyle);
-      if (spec.showColumnDividers && colIndex + 1 < spec.columns.size()) {
-        DividerSpec divider;
-        divider.rectStyle = spec.dividerStyle;
-        divider.visible = spec.visible;
-        divider.size.preferredWidth = dividerWidth;
-        divider.size.preferredHeight = spec.rowHeight;
-        rowNode.createDivider(divider);
-      }
+  auto ensureRowVisible = [interaction, applyScroll](int rowIndex) {
+    if (interaction->maxScroll <= 0.0f) {
+      return;
+    }
+    Internal::TableRowGeometry const& rowGeometry = interaction->geometry;
+    float rowTop = std::max(1.0f, rowGeometry.rowHeight + rowGeometry.rowGap) *
+                   static_cast<float>(rowIndex);
+    float rowBottom = rowTop + rowGeometry.rowHeight;
+    if (rowTop < interaction->scrollOffset) {
+      applyScroll(rowTop);
+    } else if (rowBottom > interaction->scrollOffset + interaction->viewportHeight) {
+      applyScroll(rowBottom - interaction->viewportHeight);
+    }
+  };
+
+  if (spec.virtualized) {
+    int poolSize = Internal::collectionRowPoolSize(viewportHeight,
+                                                   geometry.rowHeight,
+                                                   geometry.rowGap,
+                                                   normalized.overscanRows,
+                                                   static_cast<int>(rowCount));
+    interaction->slots.reserve(static_cast<size_t>(poolSize));
+    for (int slotIndex = 0; slotIndex < poolSize; ++slotIndex) {
+      interaction->slots.push_back(
+          Internal::createTableRowSlot(runtimeFrame, rowsNode, spec, geometry));
+    }
+    Internal::syncTableRowWindow(*interaction);
+  } else {
+    interaction->slots.reserve(rowCount);
+    for (size_t rowIndex = 0; rowIndex < rowCount; ++rowIndex) {
+      int row = static_cast<int>(rowIndex);
+      interaction->rowCells(rowIndex, interaction->bindScratch);
+      interaction->slots.push_back(Internal::createTableRow(runtimeFrame,
+                                                            rowsNode,
+                                                            spec,
+                                                            geometry,
+                                                            row,
+                                                            interaction->rowRole(row),
+                                                            interaction->bindScratch.views));
     }
   }
 
   bool hasRowSelectCallback = static_cast<bool>(interaction->callbacks.onSelect) ||
                               static_cast<bool>(interaction->callbacks.onRowClicked);
   if (enabled && spec.visible && (hasRowSelectCallback || spec.selectionStyle != 0)) {
-    auto updateRowStyle = [interaction](int rowIndex, bool selected) {
-      if (rowIndex < 0 || rowIndex >= static_cast<int>(interaction->backgrounds.size())) {
-        return;
-      }
-      PrimeFrame::PrimitiveId primId = interaction->backgrounds[static_cast<size_t>(rowIndex)];
-      if (primId == 0) {
+    auto updateRowStyle = [interaction](int rowIndex) {
+      Internal::TableRowSlot* slot = interaction->slotForRow(rowIndex);
+      if (!slot || slot->background == 0) {
         return;
       }
-      PrimeFrame::Primitive* prim = interaction->frame->getPrimitive(primId);
+      PrimeFrame::Primitive* prim = interaction->frame->getPrimitive(slot->background);
       if (!prim || prim->type != PrimeFrame::PrimitiveType::Rect) {
         return;
       }
-      if (selected && interaction->selectionStyle != 0) {
-        prim->rect.token = interaction->selectionStyle;
-      } else if (rowIndex >= 0 && rowIndex < static_cast<int>(interaction->baseStyles.size())) {
-        prim->rect.token = interaction->baseStyles[static_cast<size_t>(rowIndex)];
-      }
+      prim->rect.token = interaction->rowRole(rowIndex);
     };
 
     auto notifyRowSelect = [interaction](int index) {
       if (!interaction->callbacks.onSelect && !interaction->callbacks.onRowClicked) {
         return;
       }
+      // Only the selected row's cells are gathered, when the callback fires.
       TableRowInfo info;
       info.rowIndex = index;
-      if (index >= 0 && index < static_cast<int>(interaction->ownedRows.size())) {
-        auto const& row = interaction->ownedRows[static_cast<size_t>(index)];
-        interaction->rowViewScratch.clear();
-        interaction->rowViewScratch.reserve(row.size());
-        for (std::string const& cell : row) {
-          interaction->rowViewScratch.push_back(cell);
+      if (index >= 0 && index < interaction->rowCount) {
+        interaction->rowCells(static_cast<size_t>(index), interaction->rowViewScratch);
+        info.row = std::span<const std::string_view>(interaction->rowViewScratch.views);
+        if (interaction->source.rowKey) {
+          info.key = interaction->source.rowKey(static_cast<size_t>(index));
         }
-        info.row = std::span<const std::string_view>(interaction->rowViewScratch);
       }
       if (interaction->callbacks.onSelect) {
         interaction->callbacks.onSelect(info);
@@ -384,16 +365,18 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
       }
     };
 
-    auto selectRow = [interaction, updateRowStyle, notifyRowSelect](int index,
-                                                                     bool notifyWhenUnchanged) {
-      if (index < 0 || index >= static_cast<int>(interaction->backgrounds.size())) {
+    auto selectRow = [interaction, updateRowStyle, notifyRowSelect, ensureRowVisible](
+                         int index,
+                         bool notifyWhenUnchanged) {
+      if (index < 0 || index >= interaction->rowCount) {
         return false;
       }
       if (interaction->selectedRow != index) {
         int previous = interaction->selectedRow;
         interaction->selectedRow = index;
-        updateRowStyle(previous, false);
-        updateRowStyle(index, true);
+        updateRowStyle(previous);
+        updateRowStyle(index);
+        ensureRowVisible(index);
         notifyRowSelect(index);
         return true;
       }
@@ -404,18 +387,23 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
       return false;
     };
 
-    for (size_t rowIndex = 0; rowIndex < rowNodeIds.size(); ++rowIndex) {
-      PrimeFrame::Callback rowCallback;
-      rowCallback.onEvent = [selectRow, rowIndex](PrimeFrame::Event const& event) -> bool {
-        if (event.type != PrimeFrame::EventType::PointerDown) {
-          return false;
-        }
-        return selectRow(static_cast<int>(rowIndex), true);
-      };
-      if (PrimeFrame::Node* rowNodePtr = runtimeFrame.getNode(rowNodeIds[rowIndex])) {
-        rowNodePtr->callbacks = runtimeFrame.addCallback(std::move(rowCallback));
-      }
-    }
+    // One handler on the rows node maps the pointer to a row by arithmetic, so no row node
+    // carries a callback and recycled slots need no rebinding.
+    (void)Internal::appendNodeOnEvent(runtime,
+                                      rowsNode.nodeId(),
+                                      [interaction, selectRow](PrimeFrame::Event const& event) {
+                                        if (event.type != PrimeFrame::EventType::PointerDown) {
+                                          return false;
+                                        }
+                                        Internal::TableRowGeometry const& rows =
+                                            interaction->geometry;
+                                        int rowIndex = Internal::collectionRowAt(
+                                            event.localY + interaction->scrollOffset,
+                                            rows.rowHeight,
+                                            rows.rowGap,
+                                            interaction->rowCount);
+                                        return selectRow(rowIndex, true);
+                                      });
 
     (void)Internal::appendNodeOnEvent(runtime,
                                       tableRoot.nodeId(),
@@ -423,10 +411,10 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
                               if (event.type != PrimeFrame::EventType::KeyDown) {
                                 return false;
                               }
-                              if (interaction->backgrounds.empty()) {
+                              if (interaction->rowCount <= 0) {
                                 return false;
                               }
-                              int lastIndex = static_cast<int>(interaction->backgrounds.size()) - 1;
+                              int lastIndex = interaction->rowCount - 1;
                               int current = interaction->selectedRow;
                               if (current < 0) {
                                 current = 0;
@@ -450,6 +438,20 @@ UiNode UiNode::createTable(TableSpec const& specInput) {
                             });
   }
 
+  if (enabled && spec.visible && spec.virtualized) {
+    (void)Internal::appendNodeOnEvent(runtime,
+                                      tableRoot.nodeId(),
+                                      [interaction, applyScroll](PrimeFrame::Event const& event) {
+                                        if (event.type != PrimeFrame::EventType::PointerScroll ||
+                                            event.scrollY == 0.0f ||
+                                            interaction->maxScroll <= 0.0f) {
+                                          return false;
+                                        }
+                                        applyScroll(interaction->scrollOffset + event.scrollY);
+                                        return true;
+                                      });
+  }
+
   if (spec.visible && enabled) {
     Internal::InternalFocusStyle focusStyle = Internal::resolveFocusStyle(
         frame(),
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "PrimeStageCollectionInternals.h"
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PrimeStage::Internal {
+
+// Resolved column layout shared by the header, eagerly built rows and recycled rows.
+struct TableRowGeometry {
+  std::vector<float> columnWidths;
+  float rowHeight = 0.0f;
+  float rowGap = 0.0f;
+  float cellPaddingX = 0.0f;
+  float dividerWidth = 0.0f;
+};
+
+// One table row: a single node whose background, cell text and column dividers are primitives
+// placed from the resolved column widths, so layout does no per-cell work. An eager table keeps
+// one per row; a virtualized table recycles a viewport-sized pool of them, rebinding the background
+// style and cell text as rows scroll in.
+struct TableRowSlot {
+  PrimeFrame::NodeId row{};
+  PrimeFrame::PrimitiveId background = 0;
+  std::vector<PrimeFrame::PrimitiveId> cellText;
+  int rowIndex = -1;
+};
+
+// Cells of one row. A data source only keeps a view valid until its next call, so its cells are
+// copied into `text` as they are read; owned rows are viewed in place.
+struct TableRowCells {
+  std::vector<std::string_view> views;
+  std::string text;
+  std::vector<size_t> ends;
+};
+
+// Shared by the row, key and scroll callbacks of one table.
+struct TableInteractionState {
+  PrimeFrame::Frame* frame = nullptr;
+  // One slot per row, or for a virtualized table a pool holding row `i` in slot
+  // `i % slots.size()` while it is inside the scroll window.
+  std::vector<TableRowSlot> slots;
+  TableRowGeometry geometry;
+  PrimeFrame::RectStyleToken rowStyle = 0;
+  PrimeFrame::RectStyleToken rowAltStyle = 0;
+  PrimeFrame::RectStyleToken selectionStyle = 0;
+  TableCallbacks callbacks{};
+  // Rows are read through `source` when it has a cell accessor. Otherwise they are copies of
+  // TableSpec::rows packed into one buffer: row `r` owns the cells
+  // [ownedRowStarts[r], ownedRowStarts[r + 1]) of ownedCellEnds, which index ownedText.
+  TableDataSource source;
+  std::string ownedText;
+  std::vector<size_t> ownedCellEnds;
+  std::vector<size_t> ownedRowStarts;
+  size_t columnCount = 0;
+  // Cells of the row being bound, and of the row in the last callback payload.
+  TableRowCells bindScratch;
+  TableRowCells rowViewScratch;
+  PrimeFrame::NodeId viewportNode{};
+  int rowCount = 0;
+  int selectedRow = -1;
+  int overscanRows = 0;
+  float scrollOffset = 0.0f;
+  float maxScroll = 0.0f;
+  float viewportHeight = 0.0f;
+  float contentHeight = 0.0f;
+  bool visible = true;
+
+  [[nodiscard]] PrimeFrame::RectStyleToken rowRole(int rowIndex) const {
+    if (rowIndex == selectedRow && selectionStyle != 0) {
+      return selectionStyle;
+    }
+    return (rowIndex % 2 == 0) ? rowAltStyle : rowStyle;
+  }
+
+  [[nodiscard]] std::string_view cell(size_t row, size_t column) const;
+  // Gathers the cells of `row` into `out`, which is overwritten.
+  void rowCells(size_t row, TableRowCells& out) const;
+
+  // Slot currently showing `rowIndex`, or null while the row is outside the scroll window.
+  [[nodiscard]] TableRowSlot* slotForRow(int rowIndex) {
+    if (rowIndex < 0 || slots.empty()) {
+      return nullptr;
+    }
+    TableRowSlot& slot = slots[static_cast<size_t>(rowIndex) % slots.size()];
+    return slot.rowIndex == rowIndex ? &slot : nullptr;
+  }
+};
+
+// Packs owned copies of `rows` into `state`.
+void copyTableRows(TableInteractionState& state,
+                   std::vector<std::vector<std::string_view>> const& rows);
+
+// Adds each column's text and the dividers between columns to `rowId` as primitives, vertically
+// centered in `height` and inset by `paddingX`. The text primitives are appended to `cellText` when
+// it is set.
+void addTableCellPrimitives(PrimeFrame::Frame& frame,
+                            PrimeFrame::NodeId rowId,
+                            TableSpec const& spec,
+                            TableRowGeometry const& geometry,
+                            float height,
+                            float paddingX,
+                            bool header,
+                            std::span<std::string_view const> cells,
+                            std::vector<PrimeFrame::PrimitiveId>* cellText);
+
+TableRowSlot createTableRow(PrimeFrame::Frame& frame,
+                            UiNode& rowsNode,
+                            TableSpec const& spec,
+                            TableRowGeometry const& geometry,
+                            int rowIndex,
+                            PrimeFrame::RectStyleToken rowRole,
+                            std::span<std::string_view const> cells);
+
+// An unbound row for the recycled pool; its cell text is placed up front so binding only swaps
+// text.
+TableRowSlot createTableRowSlot(PrimeFrame::Frame& frame,
+                                UiNode& rowsNode,
+                                TableSpec const& spec,
+                                TableRowGeometry const& geometry);
+
+void bindTableRowSlot(PrimeFrame::Frame& frame,
+                      TableRowSlot& slot,
+                      int rowIndex,
+                      std::span<std::string_view const> cells,
+                      PrimeFrame::RectStyleToken rowRole,
+                      TableRowGeometry const& geometry,
+                      bool visible);
+
+// Binds the rows in the scroll window (plus overscan) to the recycled slots. Slots are assigned by
+// row index modulo the pool size, so rows that stay inside the window keep their nodes.
+void syncTableRowWindow(TableInteractionState& state);
+
+} // namespace PrimeStage::Internal
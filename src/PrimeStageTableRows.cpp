@@ -0,0 +1,285 @@
+#include "PrimeStage/PrimeStage.h"
+
+#include "PrimeStageTableInternals.h"
+
+#include <algorithm>
+
+namespace PrimeStage::Internal {
+
+namespace {
+
+PrimeFrame::PrimitiveId add_rect_primitive(PrimeFrame::Frame& frame,
+                                           PrimeFrame::NodeId nodeId,
+                                           InternalRect const& rect,
+                                           PrimeFrame::RectStyleToken token) {
+  PrimeFrame::Primitive prim;
+  prim.type = PrimeFrame::PrimitiveType::Rect;
+  prim.offsetX = rect.x;
+  prim.offsetY = rect.y;
+  prim.width = rect.width;
+  prim.height = rect.height;
+  prim.rect.token = token;
+  PrimeFrame::PrimitiveId pid = frame.addPrimitive(prim);
+  if (PrimeFrame::Node* node = frame.getNode(nodeId)) {
+    node->primitives.push_back(pid);
+  }
+  return pid;
+}
+
+PrimeFrame::PrimitiveId add_text_primitive(PrimeFrame::Frame& frame,
+                                           PrimeFrame::NodeId nodeId,
+                                           InternalRect const& rect,
+                                           std::string_view text,
+                                           PrimeFrame::TextStyleToken token) {
+  PrimeFrame::Primitive prim;
+  prim.type = PrimeFrame::PrimitiveType::Text;
+  prim.offsetX = rect.x;
+  prim.offsetY = rect.y;
+  prim.width = rect.width;
+  prim.height = rect.height;
+  prim.textBlock.text = std::string(text);
+  prim.textBlock.align = PrimeFrame::TextAlign::Start;
+  prim.textBlock.wrap = PrimeFrame::WrapMode::None;
+  prim.textBlock.maxWidth = rect.width;
+  prim.textStyle.token = token;
+  PrimeFrame::PrimitiveId pid = frame.addPrimitive(prim);
+  if (PrimeFrame::Node* node = frame.getNode(nodeId)) {
+    node->primitives.push_back(pid);
+  }
+  return pid;
+}
+
+UiNode create_row_panel(UiNode& rowsNode,
+                        TableSpec const& spec,
+                        TableRowGeometry const& geometry,
+                        PrimeFrame::RectStyleToken rowRole) {
+  PanelSpec rowPanel;
+  rowPanel.rectStyle = rowRole;
+  rowPanel.size.preferredHeight = geometry.rowHeight;
+  rowPanel.size.stretchX = 1.0f;
+  rowPanel.visible = spec.visible;
+  UiNode rowNode = rowsNode.createPanel(rowPanel);
+  // Pointer events land on the rows node, which resolves the row from the hit position.
+  rowNode.setHitTestVisible(false);
+  return rowNode;
+}
+
+PrimeFrame::PrimitiveId first_primitive(PrimeFrame::Frame& frame, PrimeFrame::NodeId nodeId) {
+  PrimeFrame::Node const* node = frame.getNode(nodeId);
+  if (!node || node->primitives.empty()) {
+    return 0;
+  }
+  return node->primitives.front();
+}
+
+float column_width(TableRowGeometry const& geometry, size_t colIndex) {
+  return colIndex < geometry.columnWidths.size() ? geometry.columnWidths[colIndex] : 0.0f;
+}
+
+} // namespace
+
+std::string_view TableInteractionState::cell(size_t row, size_t column) const {
+  if (source.cell) {
+    return column < columnCount ? source.cell(row, column) : std::string_view{};
+  }
+  if (row + 1u >= ownedRowStarts.size()) {
+    return {};
+  }
+  size_t index = ownedRowStarts[row] + column;
+  if (index >= ownedRowStarts[row + 1u]) {
+    return {};
+  }
+  size_t begin = index == 0u ? 0u : ownedCellEnds[index - 1u];
+  return std::string_view(ownedText).substr(begin, ownedCellEnds[index] - begin);
+}
+
+void TableInteractionState::rowCells(size_t row, TableRowCells& out) const {
+  out.views.clear();
+  if (!source.cell) {
+    size_t count = row + 1u < ownedRowStarts.size()
+                       ? ownedRowStarts[row + 1u] - ownedRowStarts[row]
+                       : columnCount;
+    out.views.reserve(count);
+    for (size_t column = 0; column < count; ++column) {
+      out.views.push_back(cell(row, column));
+    }
+    return;
+  }
+  out.text.clear();
+  out.ends.clear();
+  for (size_t column = 0; column < columnCount; ++column) {
+    out.text.append(source.cell(row, column));
+    out.ends.push_back(out.text.size());
+  }
+  // Viewed only once every cell is copied, since appending may move the text.
+  out.views.reserve(columnCount);
+  size_t begin = 0u;
+  for (size_t end : out.ends) {
+    out.views.push_back(std::string_view(out.text).substr(begin, end - begin));
+    begin = end;
+  }
+}
+
+void copyTableRows(TableInteractionState& state,
+                   std::vector<std::vector<std::string_view>> const& rows) {
+  size_t cellCount = 0u;
+  size_t textSize = 0u;
+  for (auto const& row : rows) {
+    cellCount += row.size();
+    for (std::string_view cell : row) {
+      textSize += cell.size();
+    }
+  }
+  state.ownedText.reserve(textSize);
+  state.ownedCellEnds.reserve(cellCount);
+  state.ownedRowStarts.reserve(rows.size() + 1u);
+  for (auto const& row : rows) {
+    state.ownedRowStarts.push_back(state.ownedCellEnds.size());
+    for (std::string_view cell : row) {
+      state.ownedText.append(cell);
+      state.ownedCellEnds.push_back(state.ownedText.size());
+    }
+  }
+  state.ownedRowStarts.push_back(state.ownedCellEnds.size());
+}
+
+void addTableCellPrimitives(PrimeFrame::Frame& frame,
+                            PrimeFrame::NodeId rowId,
+                            TableSpec const& spec,
+                            TableRowGeometry const& geometry,
+                            float height,
+                            float paddingX,
+                            bool header,
+                            std::span<std::string_view const> cells,
+                            std::vector<PrimeFrame::PrimitiveId>* cellText) {
+  float cellX = 0.0f;
+  for (size_t colIndex = 0; colIndex < spec.columns.size(); ++colIndex) {
+    TableColumn const& col = spec.columns[colIndex];
+    PrimeFrame::TextStyleToken token = header ? col.headerStyle : col.cellStyle;
+    float width = column_width(geometry, colIndex);
+    float lineHeight = resolveLineHeight(frame, token);
+    float textWidth = std::max(0.0f, width - paddingX * 2.0f);
+    PrimeFrame::PrimitiveId textId = add_text_primitive(
+        frame,
+        rowId,
+        InternalRect{cellX + paddingX, (height - lineHeight) * 0.5f, textWidth, lineHeight},
+        colIndex < cells.size() ? cells[colIndex] : std::string_view{},
+        token);
+    if (cellText) {
+      cellText->push_back(textId);
+    }
+    cellX += width;
+    if (spec.showColumnDividers && colIndex + 1 < spec.columns.size()) {
+      add_rect_primitive(frame,
+                         rowId,
+                         InternalRect{cellX, 0.0f, geometry.dividerWidth, height},
+                         spec.dividerStyle);
+      cellX += geometry.dividerWidth;
+    }
+  }
+}
+
+TableRowSlot createTableRow(PrimeFrame::Frame& frame,
+                            UiNode& rowsNode,
+                            TableSpec const& spec,
+                            TableRowGeometry const& geometry,
+                            int rowIndex,
+                            PrimeFrame::RectStyleToken rowRole,
+                            std::span<std::string_view const> cells) {
+  TableRowSlot slot;
+  UiNode rowNode = create_row_panel(rowsNode, spec, geometry, rowRole);
+  slot.row = rowNode.nodeId();
+  slot.background = first_primitive(frame, slot.row);
+  slot.rowIndex = rowIndex;
+  addTableCellPrimitives(frame,
+                         slot.row,
+                         spec,
+                         geometry,
+                         geometry.rowHeight,
+                         geometry.cellPaddingX,
+                         false,
+                         cells,
+                         nullptr);
+  return slot;
+}
+
+TableRowSlot createTableRowSlot(PrimeFrame::Frame& frame,
+                                UiNode& rowsNode,
+                                TableSpec const& spec,
+                                TableRowGeometry const& geometry) {
+  TableRowSlot slot;
+  UiNode rowNode = create_row_panel(rowsNode, spec, geometry, spec.rowStyle);
+  slot.row = rowNode.nodeId();
+  slot.background = first_primitive(frame, slot.row);
+  slot.cellText.reserve(spec.columns.size());
+  addTableCellPrimitives(frame,
+                         slot.row,
+                         spec,
+                         geometry,
+                         geometry.rowHeight,
+                         geometry.cellPaddingX,
+                         false,
+                         {},
+                         &slot.cellText);
+  return slot;
+}
+
+void bindTableRowSlot(PrimeFrame::Frame& frame,
+                      TableRowSlot& slot,
+                      int rowIndex,
+                      std::span<std::string_view const> cells,
+                      PrimeFrame::RectStyleToken rowRole,
+                      TableRowGeometry const& geometry,
+                      bool visible) {
+  slot.rowIndex = rowIndex;
+  float rowPitch = std::max(1.0f, geometry.rowHeight + geometry.rowGap);
+  if (PrimeFrame::Node* rowNode = frame.getNode(slot.row)) {
+    rowNode->localY = rowPitch * static_cast<float>(rowIndex);
+    rowNode->visible = visible;
+  }
+  LayoutRequestScope::request();
+  PrimeFrame::Primitive* background = frame.getPrimitive(slot.background);
+  if (background && background->type == PrimeFrame::PrimitiveType::Rect) {
+    background->rect.token = rowRole;
+  }
+  for (size_t colIndex = 0; colIndex < slot.cellText.size(); ++colIndex) {
+    PrimeFrame::Primitive* prim = frame.getPrimitive(slot.cellText[colIndex]);
+    if (!prim || prim->type != PrimeFrame::PrimitiveType::Text) {
+      continue;
+    }
+    if (colIndex < cells.size()) {
+      prim->textBlock.text.assign(cells[colIndex]);
+    } else {
+      prim->textBlock.text.clear();
+    }
+  }
+}
+
+void syncTableRowWindow(TableInteractionState& state) {
+  if (state.slots.empty()) {
+    return;
+  }
+  int poolSize = static_cast<int>(state.slots.size());
+  CollectionRowWindow rows = collectionRowWindow(state.scrollOffset,
+                                                 state.geometry.rowHeight,
+                                                 state.geometry.rowGap,
+                                                 state.overscanRows,
+                                                 poolSize,
+                                                 state.rowCount);
+  for (int rowIndex = rows.first; rowIndex < rows.last; ++rowIndex) {
+    TableRowSlot& slot = state.slots[static_cast<size_t>(rowIndex % poolSize)];
+    if (slot.rowIndex == rowIndex) {
+      continue;
+    }
+    state.rowCells(static_cast<size_t>(rowIndex), state.bindScratch);
+    bindTableRowSlot(*state.frame,
+                     slot,
+                     rowIndex,
+                     state.bindScratch.views,
+                     state.rowRole(rowIndex),
+                     state.geometry,
+                     state.visible);
+  }
+}
+
+} // namespace PrimeStage::Internal
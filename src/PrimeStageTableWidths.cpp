@@ -0,0 +1,273 @@
+#include "PrimeStage/PrimeStage.h"
+
+#include "PrimeStageBuildTaskPool.h"
+#include "PrimeStageCollectionInternals.h"
+
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+namespace PrimeStage {
+
+namespace {
+
+constexpr size_t NoRow = static_cast<size_t>(-1);
+
+struct WidestCell {
+  float width = 0.0f;
+  size_t row = NoRow;
+};
+
+using CellReader = std::function<std::string_view(size_t, size_t)>;
+
+void keep_widest(WidestCell& widest, WidestCell const& other) {
+  if (other.row == NoRow) {
+    return;
+  }
+  if (widest.row == NoRow || other.width > widest.width ||
+      (other.width == widest.width && other.row < widest.row)) {
+    widest = other;
+  }
+}
+
+// Number of chunks [0, count) is split into: one unless `parallel` is set and the building thread
+// has a pool with workers attached.
+size_t chunk_count(size_t count, bool parallel) {
+  Internal::BuildTaskPool* pool = parallel ? Internal::activeBuildTaskPool() : nullptr;
+  if (!pool || pool->workerCount() == 0u || count < 2u) {
+    return 1u;
+  }
+  return std::min(count, (pool->workerCount() + 1u) * 4u);
+}
+
+// Calls task(begin, end, chunk) for `chunkCount` even slices of [0, count), on the attached pool
+// when there is more than one.
+template <typename Task>
+void for_each_chunk(size_t count, size_t chunkCount, Task&& task) {
+  if (chunkCount <= 1u) {
+    task(size_t{0u}, count, size_t{0u});
+    return;
+  }
+  Internal::activeBuildTaskPool()->run(chunkCount, [&](size_t chunk) {
+    task(count * chunk / chunkCount, count * (chunk + 1u) / chunkCount, chunk);
+  });
+}
+
+WidestCell measure_rows(PrimeFrame::ResolvedTextStyle const& style,
+                        CellReader const& cell,
+                        size_t column,
+                        size_t begin,
+                        size_t end,
+                        bool parallel) {
+  size_t chunkCount = chunk_count(end - begin, parallel);
+  std::vector<WidestCell> chunks(chunkCount);
+  for_each_chunk(end - begin, chunkCount, [&](size_t first, size_t last, size_t chunk) {
+    WidestCell widest;
+    for (size_t row = begin + first; row < begin + last; ++row) {
+      keep_widest(widest, {Internal::estimateTextWidth(style, cell(row, column)), row});
+    }
+    chunks[chunk] = widest;
+  });
+  WidestCell widest;
+  for (WidestCell const& chunk : chunks) {
+    keep_widest(widest, chunk);
+  }
+  return widest;
+}
+
+// Rows in [begin, end) holding the `count` cells with the most bytes, ties going to earlier rows.
+std::vector<size_t> longest_rows(CellReader const& cell,
+                                 size_t column,
+                                 size_t begin,
+                                 size_t end,
+                                 size_t count,
+                                 bool parallel) {
+  using Candidate = std::pair<size_t, size_t>;
+  auto longer = [](Candidate const& lhs, Candidate const& rhs) {
+    return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+  };
+  size_t chunkCount = chunk_count(end - begin, parallel);
+  std::vector<std::vector<Candidate>> chunks(chunkCount);
+  for_each_chunk(end - begin, chunkCount, [&](size_t first, size_t last, size_t chunk) {
+    std::vector<Candidate>& best = chunks[chunk];
+    best.reserve(count + 1u);
+    for (size_t row = begin + first; row < begin + last; ++row) {
+      Candidate candidate{cell(row, column).size(), row};
+      if (best.size() == count && !longer(candidate, best.front())) {
+        continue;
+      }
+      best.push_back(candidate);
+      std::push_heap(best.begin(), best.end(), longer);
+      if (best.size() > count) {
+        std::pop_heap(best.begin(), best.end(), longer);
+        best.pop_back();
+      }
+    }
+  });
+  std::vector<Candidate> merged;
+  for (std::vector<Candidate> const& best : chunks) {
+    merged.insert(merged.end(), best.begin(), best.end());
+  }
+  std::sort(merged.begin(), merged.end(), longer);
+  merged.resize(std::min(merged.size(), count));
+  std::vector<size_t> rows;
+  rows.reserve(merged.size());
+  for (Candidate const& candidate : merged) {
+    rows.push_back(candidate.second);
+  }
+  return rows;
+}
+
+size_t shift_removed(size_t row, size_t first, size_t count) {
+  if (row < first) {
+    return row;
+  }
+  return row < first + count ? first : row - count;
+}
+
+} // namespace
+
+void TableColumnWidthCache::rowsInserted(size_t first, size_t count) {
+  if (count == 0u) {
+    return;
+  }
+  reported_ = true;
+  for (RowRange& range : pending_) {
+    if (range.begin >= first) {
+      range.begin += count;
+    }
+    if (range.end > first) {
+      range.end += count;
+    }
+  }
+  for (Column& column : columns_) {
+    if (column.widestRow != NoRow && column.widestRow >= first) {
+      column.widestRow += count;
+    }
+  }
+  pending_.push_back({first, first + count});
+  rowCount_ += count;
+}
+
+void TableColumnWidthCache::rowsUpdated(size_t first, size_t count) {
+  if (count == 0u) {
+    return;
+  }
+  reported_ = true;
+  for (Column& column : columns_) {
+    // The widest cell may have shrunk, so nothing short of a full pass finds the new one.
+    size_t widest = column.widestRow;
+    if (widest != NoRow && widest >= first && widest < first + count) {
+      column.dirty = true;
+    }
+  }
+  pending_.push_back({first, first + count});
+}
+
+void TableColumnWidthCache::rowsRemoved(size_t first, size_t count) {
+  if (count == 0u) {
+    return;
+  }
+  reported_ = true;
+  for (RowRange& range : pending_) {
+    range.begin = shift_removed(range.begin, first, count);
+    range.end = shift_removed(range.end, first, count);
+  }
+  std::erase_if(pending_, [](RowRange const& range) { return range.begin >= range.end; });
+  for (Column& column : columns_) {
+    if (column.widestRow == NoRow || column.widestRow < first) {
+      continue;
+    }
+    if (column.widestRow < first + count) {
+      column.dirty = true;
+      column.widestRow = NoRow;
+    } else {
+      column.widestRow -= count;
+    }
+  }
+  rowCount_ -= std::min(rowCount_, count);
+}
+
+void TableColumnWidthCache::invalidate() {
+  valid_ = false;
+}
+
+std::span<float const> TableColumnWidthCache::measure(PrimeFrame::Frame& frame,
+                                                      std::span<TableColumn const> columns,
+                                                      TableAutoWidthPolicy const& policy,
+                                                      uint64_t revision,
+                                                      size_t rowCount,
+                                                      CellReader const& cell) {
+  bool samePolicy = policy.sampleRows == policy_.sampleRows &&
+                    policy.longestCells == policy_.longestCells;
+  bool remeasureAll = !valid_ || !samePolicy || rowCount != rowCount_ ||
+                      (revision != revision_ && !reported_) || columns_.size() != columns.size();
+  columns_.resize(columns.size());
+  widths_.assign(columns.size(), 0.0f);
+  measuredCellCount_ = 0u;
+  bool parallel = policy.parallel && rowCount >= std::max<size_t>(1u, policy.parallelThreshold);
+
+  for (size_t colIndex = 0u; colIndex < columns.size(); ++colIndex) {
+    TableColumn const& spec = columns[colIndex];
+    Column& cached = columns_[colIndex];
+    if (spec.width > 0.0f) {
+      // Not tracked while fixed; measured from scratch if it turns auto-sized again.
+      cached.dirty = true;
+      continue;
+    }
+    if (remeasureAll || cached.cellStyle != spec.cellStyle) {
+      cached.dirty = true;
+    }
+    if (cached.dirty || cached.headerStyle != spec.headerStyle || cached.label != spec.label) {
+      cached.label.assign(spec.label);
+      cached.headerStyle = spec.headerStyle;
+      cached.headerWidth = Internal::estimateTextWidth(frame, spec.headerStyle, spec.label);
+    }
+    cached.cellStyle = spec.cellStyle;
+    std::optional<ThemeStyleTable::TextEntry> entry =
+        Internal::resolveTextEntry(frame, spec.cellStyle);
+    if (!entry || !cell) {
+      cached.cellWidth = 0.0f;
+      cached.widestRow = NoRow;
+    } else if (cached.dirty) {
+      WidestCell widest;
+      bool sampled = policy.sampleRows > 0u && rowCount > policy.sampleRows + policy.longestCells;
+      size_t headRows = sampled ? policy.sampleRows : rowCount;
+      keep_widest(widest, measure_rows(entry->style, cell, colIndex, 0u, headRows, parallel));
+      measuredCellCount_ += headRows;
+      if (sampled) {
+        for (size_t row :
+             longest_rows(cell, colIndex, headRows, rowCount, policy.longestCells, parallel)) {
+          float width = Internal::estimateTextWidth(entry->style, cell(row, colIndex));
+          keep_widest(widest, {width, row});
+          ++measuredCellCount_;
+        }
+      }
+      cached.cellWidth = widest.width;
+      cached.widestRow = widest.row;
+    } else {
+      WidestCell widest{cached.cellWidth, cached.widestRow};
+      for (RowRange const& range : pending_) {
+        size_t end = std::min(range.end, rowCount);
+        if (range.begin < end) {
+          keep_widest(widest, measure_rows(entry->style, cell, colIndex, range.begin, end, false));
+          measuredCellCount_ += end - range.begin;
+        }
+      }
+      cached.cellWidth = widest.width;
+      cached.widestRow = widest.row;
+    }
+    cached.dirty = false;
+    widths_[colIndex] = std::max(cached.headerWidth, cached.cellWidth);
+  }
+
+  pending_.clear();
+  policy_ = policy;
+  revision_ = revision;
+  rowCount_ = rowCount;
+  valid_ = true;
+  reported_ = false;
+  return widths_;
+}
+
+} // namespace PrimeStage
@@ -1,5 +1,6 @@
 #include "PrimeStage/PrimeStage.h"
 
+#include "PrimeStage/AppRuntime.h"
 #include "PrimeStage/TextSelection.h"
 #include "PrimeStageCollectionInternals.h"
 #include "PrimeFrame/Events.h"
@@ -10,6 +11,80 @@
 
 namespace PrimeStage {
 
+namespace {
+
+// Drives cursor blink from a TimerScheduler while the field is focused. The driver is owned by the
+// field's frame callbacks; pending timers only hold a weak reference and the driver cancels its
+// timer when the frame (and therefore the field) is torn down.
+struct TextFieldBlinkDriver {
+  TimerScheduler* scheduler = nullptr;
+  TimerId timer = InvalidTimerId;
+  TextFieldState* state = nullptr;
+  std::chrono::milliseconds interval{};
+  std::function<void()> patch;
+
+  ~TextFieldBlinkDriver() { stop(); }
+
+  void stop() {
+    if (scheduler && timer != InvalidTimerId) {
+      scheduler->cancel(timer);
+    }
+    timer = InvalidTimerId;
+  }
+};
+
+void schedule_text_field_blink(std::shared_ptr<TextFieldBlinkDriver> const& driver,
+                               std::chrono::steady_clock::time_point deadline) {
+  if (!driver || !driver->scheduler || driver->interval.count() <= 0) {
+    return;
+  }
+  driver->stop();
+  std::weak_ptr<TextFieldBlinkDriver> weakDriver = driver;
+  driver->timer = driver->scheduler->schedule(deadline, [weakDriver, deadline]() {
+    std::shared_ptr<TextFieldBlinkDriver> locked = weakDriver.lock();
+    if (!locked || !locked->state) {
+      return;
+    }
+    locked->timer = InvalidTimerId;
+    TextFieldState& state = *locked->state;
+    if (!state.focused) {
+      return;
+    }
+    state.cursorVisible = !state.cursorVisible;
+    state.nextBlink = deadline + locked->interval;
+    if (locked->patch) {
+      locked->patch();
+    }
+    schedule_text_field_blink(locked, state.nextBlink);
+  });
+}
+
+std::shared_ptr<TextFieldBlinkDriver> make_text_field_blink_driver(TextFieldState* state,
+                                                                   TextFieldSpec const& spec,
+                                                                   std::function<void()> patch) {
+  if (!state || !spec.timers || spec.cursorBlinkInterval.count() <= 0) {
+    return nullptr;
+  }
+  auto driver = std::make_shared<TextFieldBlinkDriver>();
+  driver->scheduler = spec.timers;
+  driver->state = state;
+  driver->interval = spec.cursorBlinkInterval;
+  driver->patch = std::move(patch);
+  if (state->focused) {
+    // Rebuilt while focused: keep the current blink phase.
+    auto deadline = state->nextBlink;
+    if (deadline.time_since_epoch().count() == 0) {
+      state->cursorVisible = true;
+      deadline = std::chrono::steady_clock::now() + spec.cursorBlinkInterval;
+      state->nextBlink = deadline;
+    }
+    schedule_text_field_blink(driver, deadline);
+  }
+  return driver;
+}
+
+} // namespace
+
 UiNode UiNode::createTextField(TextFieldSpec const& specInput) {
   TextFieldSpec spec = Internal::normalizeTextFieldSpec(specInput);
   bool enabled = spec.enabled;
@@ -395,6 +470,9 @@ UiNode UiNode::createTextField(TextFieldSpec const& specInput) {
 
   patchTextFieldVisuals();
 
+  std::shared_ptr<TextFieldBlinkDriver> blinkDriver =
+      make_text_field_blink_driver(state, spec, patchTextFieldVisuals);
+
   if (state) {
     PrimeFrame::Node* node = runtimeFrame.getNode(field.nodeId());
     if (node) {
@@ -409,6 +487,7 @@ UiNode UiNode::createTextField(TextFieldSpec const& specInput) {
                           readOnly,
                           handleClipboardShortcuts = spec.handleClipboardShortcuts,
                           cursorBlinkInterval = spec.cursorBlinkInterval,
+                          blinkDriver,
                           patchTextFieldVisuals](PrimeFrame::Event const& event) -> bool {
         if (!state) {
           return false;
@@ -433,6 +512,7 @@ UiNode UiNode::createTextField(TextFieldSpec const& specInput) {
         auto reset_blink = [&](std::chrono::steady_clock::time_point now) {
           state->cursorVisible = true;
           state->nextBlink = now + cursorBlinkInterval;
+          schedule_text_field_blink(blinkDriver, state->nextBlink);
         };
         auto notify_state = [&]() {
           patchTextFieldVisuals();
@@ -793,6 +873,7 @@ UiNode UiNode::createTextField(TextFieldSpec const& specInput) {
                           callbacks = spec.callbacks,
                           cursorBlinkInterval = spec.cursorBlinkInterval,
                           setCursorToEndOnFocus = spec.setCursorToEndOnFocus,
+                          blinkDriver,
                           patchTextFieldVisuals]() {
         if (!state) {
           return;
@@ -810,6 +891,7 @@ UiNode UiNode::createTextField(TextFieldSpec const& specInput) {
         clearTextFieldSelection(*state, state->cursor);
         state->cursorVisible = true;
         state->nextBlink = std::chrono::steady_clock::now() + cursorBlinkInterval;
+        schedule_text_field_blink(blinkDriver, state->nextBlink);
         patchTextFieldVisuals();
         if (focusChanged && callbacks.onFocusChanged) {
           callbacks.onFocusChanged(true);
@@ -819,7 +901,7 @@ UiNode UiNode::createTextField(TextFieldSpec const& specInput) {
         }
       };
 
-      callback.onBlur = [state, callbacks = spec.callbacks, patchTextFieldVisuals]() {
+      callback.onBlur = [state, callbacks = spec.callbacks, blinkDriver, patchTextFieldVisuals]() {
         if (!state) {
           return;
         }
@@ -830,6 +912,9 @@ UiNode UiNode::createTextField(TextFieldSpec const& specInput) {
         state->focused = false;
         state->cursorVisible = false;
         state->nextBlink = {};
+        if (blinkDriver) {
+          blinkDriver->stop();
+        }
         state->selecting = false;
         state->pointerId = -1;
         uint32_t size = static_cast<uint32_t>(state->text.size());
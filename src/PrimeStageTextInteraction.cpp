@@ -1,5 +1,6 @@
 #include "PrimeStage/PrimeStage.h"
 #include "PrimeStage/TextSelection.h"
+#include "PrimeStageCollectionInternals.h"
 
 #include <algorithm>
 #include <chrono>
@@ -21,26 +22,17 @@ bool is_utf8_continuation(uint8_t value) {
 }
 
 float resolve_line_height(PrimeFrame::Frame& frame, PrimeFrame::TextStyleToken token) {
-  PrimeFrame::Theme const* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
-  if (!theme) {
-    return 0.0f;
-  }
-  PrimeFrame::ResolvedTextStyle resolved = PrimeFrame::resolveTextStyle(*theme, token, {});
-  float lineHeight = resolved.lineHeight > 0.0f ? resolved.lineHeight : resolved.size * 1.2f;
-  return lineHeight;
+  std::optional<ThemeStyleTable::TextEntry> entry = Internal::resolveTextEntry(frame, token);
+  return entry ? entry->lineHeight : 0.0f;
 }
 
 #if defined(PRIMESTAGE_HAS_PRIMEMANIFEST)
-PrimeManifest::Typography make_typography(PrimeFrame::Frame& frame, PrimeFrame::TextStyleToken token) {
+PrimeManifest::Typography make_typography(ThemeStyleTable::TextEntry const& entry) {
   PrimeManifest::Typography typography;
-  PrimeFrame::Theme const* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
-  if (!theme) {
-    return typography;
-  }
-  PrimeFrame::ResolvedTextStyle resolved = PrimeFrame::resolveTextStyle(*theme, token, {});
+  PrimeFrame::ResolvedTextStyle const& resolved = entry.style;
   typography.size = resolved.size;
   typography.weight = static_cast<int>(std::lround(resolved.weight));
-  typography.lineHeight = resolved.lineHeight > 0.0f ? resolved.lineHeight : resolved.size * 1.2f;
+  typography.lineHeight = entry.lineHeight;
   typography.letterSpacing = resolved.tracking;
   if (resolved.slant != 0.0f) {
     typography.slant = PrimeManifest::FontSlant::Italic;
@@ -53,6 +45,11 @@ PrimeManifest::Typography make_typography(PrimeFrame::Frame& frame, PrimeFrame::
   return typography;
 }
 
+PrimeManifest::Typography make_typography(PrimeFrame::Frame& frame, PrimeFrame::TextStyleToken token) {
+  std::optional<ThemeStyleTable::TextEntry> entry = Internal::resolveTextEntry(frame, token);
+  return entry ? make_typography(*entry) : PrimeManifest::Typography{};
+}
+
 void ensure_text_fonts_loaded() {
   static bool fontsLoaded = false;
   if (fontsLoaded) {
@@ -76,19 +73,18 @@ float measureTextWidth(PrimeFrame::Frame& frame,
   if (text.empty()) {
     return 0.0f;
   }
-  PrimeFrame::Theme const* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
-  if (!theme) {
+  std::optional<ThemeStyleTable::TextEntry> entry = Internal::resolveTextEntry(frame, token);
+  if (!entry) {
     return 0.0f;
   }
-  PrimeFrame::ResolvedTextStyle resolved = PrimeFrame::resolveTextStyle(*theme, token, {});
 #if defined(PRIMESTAGE_HAS_PRIMEMANIFEST)
   ensure_text_fonts_loaded();
   auto& registry = PrimeManifest::GetFontRegistry();
-  PrimeManifest::Typography typography = make_typography(frame, token);
-  typography.lineHeight = resolved.lineHeight > 0.0f ? resolved.lineHeight : typography.lineHeight;
+  PrimeManifest::Typography typography = make_typography(*entry);
   auto measured = registry.measureText(text, typography);
   return static_cast<float>(measured.first);
 #else
+  PrimeFrame::ResolvedTextStyle const& resolved = entry->style;
   float advance = resolved.size * 0.6f + resolved.tracking;
   float lineWidth = 0.0f;
   float maxWidth = 0.0f;
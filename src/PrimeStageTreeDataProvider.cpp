@@ -0,0 +1,132 @@
+#include "PrimeStage/PrimeStage.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace PrimeStage {
+
+TreeDataProvider::PinScope::PinScope(TreeDataProvider& provider) : provider_(provider) {
+  if (provider_.pinDepth_++ == 0u) {
+    ++provider_.pinEpoch_;
+    provider_.pinnedCount_ = 0u;
+  }
+}
+
+TreeDataProvider::PinScope::~PinScope() {
+  if (--provider_.pinDepth_ == 0u) {
+    provider_.retainedCount_ = provider_.pinnedCount_;
+    provider_.trim(std::max(provider_.branchCapacity_, provider_.retainedCount_));
+  }
+}
+
+TreeDataProvider::TreeDataProvider(TreeDataSource source, size_t branchCapacity)
+    : source_(std::move(source)), branchCapacity_(std::max<size_t>(1u, branchCapacity)) {}
+
+void TreeDataProvider::touch(Branch& branch) {
+  useOrder_.splice(useOrder_.begin(), useOrder_, branch.use);
+  if (pinDepth_ > 0u && branch.pinEpoch != pinEpoch_) {
+    branch.pinEpoch = pinEpoch_;
+    ++pinnedCount_;
+  }
+}
+
+void TreeDataProvider::trim(size_t limit) {
+  while (branches_.size() > limit && !useOrder_.empty()) {
+    branches_.erase(useOrder_.back());
+    useOrder_.pop_back();
+  }
+}
+
+TreeDataProvider::Branch* TreeDataProvider::branch(WidgetIdentityId parent) {
+  auto it = branches_.find(parent);
+  if (it != branches_.end()) {
+    touch(it->second);
+    return &it->second;
+  }
+  if (source_.childrenReady && !source_.childrenReady(parent)) {
+    return nullptr;
+  }
+  if (pinDepth_ == 0u) {
+    // Keep room for the branches the last flatten walked, so re-flattening reloads none of them.
+    trim(std::max(branchCapacity_, retainedCount_) - 1u);
+  }
+  size_t count = source_.childCount ? source_.childCount(parent) : 0u;
+  Branch& loaded = branches_[parent];
+  loaded.keys.reserve(count);
+  for (size_t index = 0; index < count; ++index) {
+    loaded.keys.push_back(source_.childKey ? source_.childKey(parent, index)
+                                           : InvalidWidgetIdentityId);
+  }
+  loaded.labels.resize(count);
+  loaded.hasChildren.assign(count, int8_t{-1});
+  loaded.use = useOrder_.insert(useOrder_.begin(), parent);
+  touch(loaded);
+  ++loadCount_;
+  return &loaded;
+}
+
+std::optional<size_t> TreeDataProvider::childCount(WidgetIdentityId parent) {
+  Branch* loaded = branch(parent);
+  if (!loaded) {
+    return std::nullopt;
+  }
+  return loaded->keys.size();
+}
+
+WidgetIdentityId TreeDataProvider::childKey(WidgetIdentityId parent, size_t index) {
+  Branch* loaded = branch(parent);
+  if (!loaded || index >= loaded->keys.size()) {
+    return InvalidWidgetIdentityId;
+  }
+  return loaded->keys[index];
+}
+
+std::string_view TreeDataProvider::childLabel(WidgetIdentityId parent, size_t index) {
+  Branch* loaded = branch(parent);
+  if (!loaded || index >= loaded->keys.size()) {
+    return {};
+  }
+  std::optional<std::string>& label = loaded->labels[index];
+  if (!label.has_value()) {
+    label = source_.label ? source_.label(loaded->keys[index]) : std::string{};
+  }
+  return label.value();
+}
+
+bool TreeDataProvider::childHasChildren(WidgetIdentityId parent, size_t index) {
+  Branch* loaded = branch(parent);
+  if (!loaded || index >= loaded->keys.size()) {
+    return false;
+  }
+  WidgetIdentityId key = loaded->keys[index];
+  // A loaded branch answers without asking the source.
+  auto children = branches_.find(key);
+  if (children != branches_.end()) {
+    return !children->second.keys.empty();
+  }
+  if (!source_.hasChildren) {
+    return true;
+  }
+  int8_t& known = loaded->hasChildren[index];
+  if (known < 0) {
+    known = source_.hasChildren(key) ? int8_t{1} : int8_t{0};
+  }
+  return known != 0;
+}
+
+void TreeDataProvider::invalidate(WidgetIdentityId parent) {
+  auto it = branches_.find(parent);
+  if (it == branches_.end()) {
+    return;
+  }
+  useOrder_.erase(it->second.use);
+  branches_.erase(it);
+}
+
+void TreeDataProvider::clear() {
+  branches_.clear();
+  useOrder_.clear();
+  retainedCount_ = 0u;
+}
+
+} // namespace PrimeStage
@@ -1,11 +1,13 @@
 #include "PrimeStage/PrimeStage.h"
+#include "PrimeStage/AppRuntime.h"
 
-#include "PrimeStageCollectionInternals.h"
+#include "PrimeStageTreeViewInternals.h"
 #include "PrimeFrame/Events.h"
 
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <limits>
 #include <optional>
 #include <utility>
 
@@ -20,16 +22,7 @@ struct Rect {
   float height = 0.0f;
 };
 
-struct FlatTreeRow {
-  std::string_view label;
-  int depth = 0;
-  int parentIndex = -1;
-  bool hasChildren = false;
-  bool expanded = true;
-  bool selected = false;
-  std::vector<int> ancestors;
-  std::vector<uint32_t> path;
-};
+using Internal::FlatTreeRow;
 
 struct ResolvedFocusStyle {
   PrimeFrame::RectStyleToken token = 0;
@@ -69,65 +62,6 @@ PrimeFrame::NodeId create_rect_node(PrimeFrame::Frame& frame,
                                   visible);
 }
 
-PrimeFrame::NodeId create_text_node(PrimeFrame::Frame& frame,
-                                    PrimeFrame::NodeId parent,
-                                    Rect const& rect,
-                                    std::string_view text,
-                                    PrimeFrame::TextStyleToken textStyle,
-                                    PrimeFrame::TextStyleOverride const& overrideStyle,
-                                    PrimeFrame::TextAlign align,
-                                    PrimeFrame::WrapMode wrap,
-                                    float maxWidth,
-                                    bool visible) {
-  return Internal::createTextNode(frame,
-                                  parent,
-                                  Internal::InternalRect{rect.x, rect.y, rect.width, rect.height},
-                                  text,
-                                  textStyle,
-                                  overrideStyle,
-                                  align,
-                                  wrap,
-                                  maxWidth,
-                                  visible);
-}
-
-void flatten_tree(std::vector<TreeNode> const& nodes,
-                  int depth,
-                  std::vector<int>& depthStack,
-                  std::vector<uint32_t>& pathStack,
-                  std::vector<FlatTreeRow>& out) {
-  for (size_t i = 0; i < nodes.size(); ++i) {
-    TreeNode const& node = nodes[i];
-    int parentIndex = depth > 0 && depth - 1 < static_cast<int>(depthStack.size())
-                          ? depthStack[static_cast<size_t>(depth - 1)]
-                          : -1;
-    FlatTreeRow row;
-    row.label = node.label;
-    row.depth = depth;
-    row.parentIndex = parentIndex;
-    row.hasChildren = !node.children.empty();
-    row.expanded = node.expanded;
-    row.selected = node.selected;
-    if (depth > 0 && depth <= static_cast<int>(depthStack.size())) {
-      row.ancestors.assign(depthStack.begin(), depthStack.begin() + depth);
-    }
-    pathStack.push_back(static_cast<uint32_t>(i));
-    row.path = pathStack;
-    int index = static_cast<int>(out.size());
-    out.push_back(std::move(row));
-
-    if (depth >= static_cast<int>(depthStack.size())) {
-      depthStack.resize(static_cast<size_t>(depth) + 1, -1);
-    }
-    depthStack[static_cast<size_t>(depth)] = index;
-
-    if (node.expanded && !node.children.empty()) {
-      flatten_tree(node.children, depth + 1, depthStack, pathStack, out);
-    }
-    pathStack.pop_back();
-  }
-}
-
 void add_divider_rect(PrimeFrame::Frame& frame,
                       PrimeFrame::NodeId nodeId,
                       Rect const& bounds,
@@ -200,51 +134,148 @@ void add_state_scrim_overlay(Internal::WidgetRuntimeContext const& runtime,
                                     Internal::InternalRect{rect.x, rect.y, rect.width, rect.height});
 }
 
+float scroll_thumb_height(ScrollBarSpec const& scrollBar,
+                          float trackH,
+                          float viewportHeight,
+                          float contentHeight) {
+  float thumbFraction = scrollBar.thumbFraction;
+  if (scrollBar.autoThumb) {
+    if (contentHeight > 0.0f && viewportHeight > 0.0f) {
+      thumbFraction = std::clamp(viewportHeight / contentHeight, 0.0f, 1.0f);
+    } else {
+      thumbFraction = 1.0f;
+    }
+  }
+  float thumbH = trackH * thumbFraction;
+  thumbH = std::max(thumbH, scrollBar.minThumbHeight);
+  if (thumbH > trackH) {
+    thumbH = trackH;
+  }
+  return thumbH;
+}
+
+// Flattened rows, shared with the recycled row window and the event callbacks.
+struct TreeViewRowWindow {
+  Internal::FlatTree tree;
+  // Set when the tree view owns expansion; toggles splice rows instead of waiting for a rebuild.
+  TreeViewState* state = nullptr;
+  // First row whose slot must be rebound even if it already shows that row index.
+  int dirtyRow = -1;
+  std::vector<Internal::TreeRowSlot> slots;
+  std::vector<Internal::InternalRect> connectorRects;
+  Internal::TreeRowGeometry geometry;
+  int overscanRows = 0;
+  bool showConnectors = false;
+  bool visible = true;
+};
+
+struct TreeViewRowVisual {
+  PrimeFrame::PrimitiveId background = 0;
+  PrimeFrame::PrimitiveId accent = 0;
+  PrimeFrame::PrimitiveId mask = 0;
+  PrimeFrame::PrimitiveId label = 0;
+  bool hasAccent = false;
+  bool hasMask = false;
+};
+
+struct TreeViewInteractionState {
+  PrimeFrame::Frame* frame = nullptr;
+  // Eagerly built rows only; windowed rows read their primitives from the bound slot.
+  std::vector<TreeViewRowVisual> rows;
+  PrimeFrame::RectStyleToken rowStyle = 0;
+  PrimeFrame::RectStyleToken rowAltStyle = 0;
+  PrimeFrame::RectStyleToken hoverStyle = 0;
+  PrimeFrame::RectStyleToken selectionStyle = 0;
+  PrimeFrame::TextStyleToken textStyle = 0;
+  PrimeFrame::TextStyleToken selectedTextStyle = 0;
+  // Backs TreeViewRowInfo::path for the duration of one callback.
+  std::vector<uint32_t> pathScratch;
+  TreeViewCallbacks callbacks;
+  int hoveredRow = -1;
+  // Pointer offset into the rows node while the pointer is over it; the rows node does not scroll,
+  // so this re-hit-tests the hovered row after rows move underneath a stationary pointer.
+  std::optional<float> hoverPointerY;
+  int selectedRow = -1;
+  int lastClickRow = -1;
+  std::chrono::steady_clock::time_point lastClickTime{};
+  std::chrono::duration<double, std::milli> doubleClickThreshold{0.0};
+  TimerScheduler* timers = nullptr;
+  TimerId clickExpiryTimer = InvalidTimerId;
+  PrimeFrame::NodeId viewportNode{};
+  PrimeFrame::NodeId scrollTrackNode{};
+  PrimeFrame::PrimitiveId scrollTrackPrim = 0;
+  PrimeFrame::NodeId scrollThumbNode{};
+  PrimeFrame::PrimitiveId scrollThumbPrim = 0;
+  float viewportHeight = 0.0f;
+  float contentHeight = 0.0f;
+  float maxScroll = 0.0f;
+  float scrollOffset = 0.0f;
+  float trackY = 0.0f;
+  float trackH = 0.0f;
+  float thumbH = 0.0f;
+  bool scrollEnabled = false;
+  bool scrollDragging = false;
+  int scrollPointerId = -1;
+  float scrollDragStartY = 0.0f;
+  float scrollDragStartOffset = 0.0f;
+  int scrollHoverCount = 0;
+  PrimeFrame::RectStyleOverride scrollTrackBaseOverride{};
+  PrimeFrame::RectStyleOverride scrollThumbBaseOverride{};
+  ScrollBarSpec scrollBar{};
+  std::optional<float> scrollTrackHoverOpacity;
+  std::optional<float> scrollTrackPressedOpacity;
+  std::optional<float> scrollThumbHoverOpacity;
+  std::optional<float> scrollThumbPressedOpacity;
+
+  ~TreeViewInteractionState() {
+    if (timers && clickExpiryTimer != InvalidTimerId) {
+      timers->cancel(clickExpiryTimer);
+    }
+  }
+};
+
 } // namespace
 
 constexpr float DisabledScrimOpacity = 0.38f;
 UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
-  TreeViewSpec normalized = Internal::normalizeTreeViewSpec(spec);
-  bool enabled = normalized.enabled;
+  Internal::NormalizedTreeViewSpec normalized = Internal::normalizeTreeViewSpec(spec);
+  bool enabled = spec.enabled;
   Internal::WidgetRuntimeContext runtime = Internal::makeWidgetRuntimeContext(frame(),
                                                                               nodeId(),
                                                                               allowAbsolute(),
                                                                               enabled,
-                                                                              normalized.visible,
+                                                                              spec.visible,
                                                                               normalized.tabIndex);
   PrimeFrame::Frame& runtimeFrame = Internal::runtimeFrame(runtime);
 
-  std::vector<FlatTreeRow> rows;
-  std::vector<int> depthStack;
-  std::vector<uint32_t> pathStack;
-  flatten_tree(normalized.nodes, 0, depthStack, pathStack, rows);
-
-  float rowsHeight = rows.empty()
-                         ? normalized.rowHeight
-                         : static_cast<float>(rows.size()) * spec.rowHeight +
-                               static_cast<float>(rows.size() - 1) * spec.rowGap;
-
-  std::vector<int> firstChild(rows.size(), -1);
-  std::vector<int> lastChild(rows.size(), -1);
-  for (size_t i = 0; i < rows.size(); ++i) {
-    if (rows[i].parentIndex >= 0) {
-      size_t parent = static_cast<size_t>(rows[i].parentIndex);
-      if (firstChild[parent] < 0) {
-        firstChild[parent] = static_cast<int>(i);
-      }
-      lastChild[parent] = static_cast<int>(i);
-    }
+  auto window = std::make_shared<TreeViewRowWindow>();
+  window->state = spec.state;
+  Internal::FlatTree& tree = window->tree;
+  if (spec.provider && spec.state) {
+    Internal::flattenTree(*spec.provider, *spec.state, tree);
+  } else {
+    Internal::flattenTree(spec.nodes, spec.state, tree);
   }
+  bool windowed = spec.virtualized || spec.state != nullptr;
+
+  float rowsHeight = tree.empty()
+                         ? spec.rowHeight
+                         : static_cast<float>(tree.size()) * spec.rowHeight +
+                               static_cast<float>(tree.size() - 1) * spec.rowGap;
 
-  Rect bounds = resolve_rect(normalized.size);
+  Rect bounds = resolve_rect(spec.size);
   if (bounds.width <= 0.0f || bounds.height <= 0.0f) {
     float maxLabelWidth = 0.0f;
-    for (FlatTreeRow const& row : rows) {
-      PrimeFrame::TextStyleToken role = row.selected ? normalized.selectedTextStyle
-                                                     : normalized.textStyle;
-      float textWidth = estimate_text_width(runtimeFrame, role, row.label);
-      float indent = row.depth > 0 ? spec.indent * static_cast<float>(row.depth) : 0.0f;
-      float contentWidth = normalized.rowWidthInset + 20.0f + indent + textWidth;
+    // Measuring would fetch every provider label, so a provider-backed tree falls back to the
+    // default width.
+    size_t measuredRows = tree.provider ? 0u : tree.size();
+    for (size_t i = 0; i < measuredRows; ++i) {
+      PrimeFrame::TextStyleToken role = tree.selected(i) ? spec.selectedTextStyle
+                                                         : spec.textStyle;
+      float textWidth = estimate_text_width(runtimeFrame, role, tree.label(i));
+      int depth = tree.depth(i);
+      float indent = depth > 0 ? spec.indent * static_cast<float>(depth) : 0.0f;
+      float contentWidth = spec.rowWidthInset + 20.0f + indent + textWidth;
       if (contentWidth > maxLabelWidth) {
         maxLabelWidth = contentWidth;
       }
@@ -253,17 +284,19 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
       bounds.width = maxLabelWidth;
     }
     if (bounds.height <= 0.0f) {
-      bounds.height = normalized.rowStartY + rowsHeight;
+      // Growing a windowed tree to fit every row would pool one slot per row.
+      bounds.height = windowed ? Internal::defaultCollectionHeight()
+                               : spec.rowStartY + rowsHeight;
     }
   }
   if (bounds.width <= 0.0f &&
-      !normalized.size.preferredWidth.has_value() &&
-      normalized.size.stretchX <= 0.0f) {
+      !spec.size.preferredWidth.has_value() &&
+      spec.size.stretchX <= 0.0f) {
     bounds.width = Internal::defaultCollectionWidth();
   }
   if (bounds.height <= 0.0f &&
-      !normalized.size.preferredHeight.has_value() &&
-      normalized.size.stretchY <= 0.0f) {
+      !spec.size.preferredHeight.has_value() &&
+      spec.size.stretchY <= 0.0f) {
     bounds.height = Internal::defaultCollectionHeight();
   }
 
@@ -271,7 +304,7 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     return UiNode(runtimeFrame, runtime.parentId, runtime.allowAbsolute);
   }
 
-  SizeSpec treeSize = normalized.size;
+  SizeSpec treeSize = spec.size;
   if (!treeSize.preferredWidth.has_value() && bounds.width > 0.0f && treeSize.stretchX <= 0.0f) {
     treeSize.preferredWidth = bounds.width;
   }
@@ -282,112 +315,89 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
   StackSpec treeSpec;
   treeSpec.size = treeSize;
   treeSpec.gap = 0.0f;
-  treeSpec.clipChildren = normalized.clipChildren;
+  treeSpec.clipChildren = spec.clipChildren;
   treeSpec.padding.left = 0.0f;
-  treeSpec.padding.top = normalized.rowStartY;
+  treeSpec.padding.top = spec.rowStartY;
   treeSpec.padding.right = 0.0f;
-  treeSpec.visible = normalized.visible;
+  treeSpec.visible = spec.visible;
   UiNode parentNode = Internal::makeParentNode(runtime);
   UiNode treeNode = parentNode.createOverlay(treeSpec);
 
   float rowWidth = std::max(0.0f, bounds.width);
-  float rowTextHeight = resolve_line_height(runtimeFrame, normalized.textStyle);
-  float selectedTextHeight = resolve_line_height(runtimeFrame, normalized.selectedTextStyle);
-  float caretBaseX = std::max(0.0f, normalized.caretBaseX);
-  float viewportHeight = std::max(0.0f, bounds.height - normalized.rowStartY);
+  float rowTextHeight = resolve_line_height(runtimeFrame, spec.textStyle);
+  float selectedTextHeight = resolve_line_height(runtimeFrame, spec.selectedTextStyle);
+  float caretBaseX = std::max(0.0f, spec.caretBaseX);
+  float viewportHeight = std::max(0.0f, bounds.height - spec.rowStartY);
+
+  Internal::TreeRowGeometry& geometry = window->geometry;
+  geometry.rowHeight = spec.rowHeight;
+  geometry.rowGap = spec.rowGap;
+  geometry.rowWidth = rowWidth;
+  geometry.rowStartX = spec.rowStartX;
+  geometry.rowWidthInset = spec.rowWidthInset;
+  geometry.indent = spec.indent;
+  geometry.caretBaseX = caretBaseX;
+  geometry.caretSize = spec.caretSize;
+  geometry.caretInset = spec.caretInset;
+  geometry.caretThickness = spec.caretThickness;
+  geometry.caretMaskPad = spec.caretMaskPad;
+  geometry.connectorThickness = spec.connectorThickness;
+  geometry.rowTextHeight = rowTextHeight;
+  geometry.selectedTextHeight = selectedTextHeight;
+  window->overscanRows = normalized.overscanRows;
+  window->showConnectors = spec.showConnectors && spec.visible;
+  window->visible = spec.visible;
 
   StackSpec rowsSpec;
   rowsSpec.size.stretchX = 1.0f;
-  rowsSpec.size.stretchY = normalized.size.stretchY;
+  rowsSpec.size.stretchY = spec.size.stretchY;
   rowsSpec.size.preferredWidth = rowWidth;
   rowsSpec.size.preferredHeight = viewportHeight;
   rowsSpec.gap = spec.rowGap;
-  rowsSpec.clipChildren = normalized.clipChildren;
-  rowsSpec.visible = normalized.visible;
+  rowsSpec.clipChildren = spec.clipChildren;
+  rowsSpec.visible = spec.visible;
 
-  if (normalized.showHeaderDivider && normalized.visible) {
-    float dividerY = normalized.headerDividerY;
+  if (spec.showHeaderDivider && spec.visible) {
+    float dividerY = spec.headerDividerY;
     add_divider_rect(runtimeFrame, treeNode.nodeId(),
-                     Rect{0.0f, dividerY, rowWidth, normalized.connectorThickness},
-                     normalized.connectorStyle);
+                     Rect{0.0f, dividerY, rowWidth, spec.connectorThickness},
+                     spec.connectorStyle);
   }
 
-  struct TreeViewRowVisual {
-    PrimeFrame::PrimitiveId background = 0;
-    PrimeFrame::PrimitiveId accent = 0;
-    PrimeFrame::PrimitiveId mask = 0;
-    PrimeFrame::PrimitiveId label = 0;
-    PrimeFrame::RectStyleToken baseStyle = 0;
-    PrimeFrame::RectStyleToken hoverStyle = 0;
-    PrimeFrame::RectStyleToken selectionStyle = 0;
-    PrimeFrame::TextStyleToken textStyle = 0;
-    PrimeFrame::TextStyleToken selectedTextStyle = 0;
-    bool hasAccent = false;
-    bool hasMask = false;
-    bool hasChildren = false;
-    bool expanded = false;
-    int depth = 0;
-    int parentIndex = -1;
-    std::vector<uint32_t> path;
-  };
-
-  struct TreeViewInteractionState {
-    PrimeFrame::Frame* frame = nullptr;
-    std::vector<TreeViewRowVisual> rows;
-    TreeViewCallbacks callbacks;
-    int hoveredRow = -1;
-    int selectedRow = -1;
-    int lastClickRow = -1;
-    std::chrono::steady_clock::time_point lastClickTime{};
-    std::chrono::duration<double, std::milli> doubleClickThreshold{0.0};
-    PrimeFrame::NodeId viewportNode{};
-    PrimeFrame::PrimitiveId scrollTrackPrim = 0;
-    PrimeFrame::NodeId scrollThumbNode{};
-    PrimeFrame::PrimitiveId scrollThumbPrim = 0;
-    float viewportHeight = 0.0f;
-    float contentHeight = 0.0f;
-    float maxScroll = 0.0f;
-    float scrollOffset = 0.0f;
-    float trackY = 0.0f;
-    float trackH = 0.0f;
-    float thumbH = 0.0f;
-    bool scrollEnabled = false;
-    bool scrollDragging = false;
-    int scrollPointerId = -1;
-    float scrollDragStartY = 0.0f;
-    float scrollDragStartOffset = 0.0f;
-    int scrollHoverCount = 0;
-    PrimeFrame::RectStyleOverride scrollTrackBaseOverride{};
-    PrimeFrame::RectStyleOverride scrollThumbBaseOverride{};
-    std::optional<float> scrollTrackHoverOpacity;
-    std::optional<float> scrollTrackPressedOpacity;
-    std::optional<float> scrollThumbHoverOpacity;
-    std::optional<float> scrollThumbPressedOpacity;
-  };
-
   auto interaction = std::make_shared<TreeViewInteractionState>();
   interaction->frame = &runtimeFrame;
-  interaction->callbacks = normalized.callbacks;
+  interaction->callbacks = spec.callbacks;
   interaction->doubleClickThreshold =
-      std::chrono::duration<double, std::milli>(std::max(0.0f, normalized.doubleClickMs));
-  interaction->rows.reserve(rows.size());
+      std::chrono::duration<double, std::milli>(std::max(0.0f, spec.doubleClickMs));
+  interaction->timers = spec.timers;
+  interaction->rowStyle = spec.rowStyle;
+  interaction->rowAltStyle = spec.rowAltStyle;
+  interaction->hoverStyle = spec.hoverStyle;
+  interaction->selectionStyle = spec.selectionStyle;
+  interaction->textStyle = spec.textStyle;
+  interaction->selectedTextStyle = spec.selectedTextStyle;
+  if (!windowed) {
+    interaction->rows.reserve(tree.size());
+  }
   interaction->viewportHeight = viewportHeight;
   interaction->contentHeight = rowsHeight;
   interaction->maxScroll = std::max(0.0f, rowsHeight - viewportHeight);
   interaction->scrollEnabled = interaction->maxScroll > 0.0f;
-  float initialProgress = std::clamp(normalized.scrollBar.thumbProgress, 0.0f, 1.0f);
+  float initialProgress = std::clamp(spec.scrollBar.thumbProgress, 0.0f, 1.0f);
   if (!interaction->scrollEnabled) {
     initialProgress = 0.0f;
   }
   interaction->scrollOffset = initialProgress * interaction->maxScroll;
-  interaction->scrollTrackBaseOverride = normalized.scrollBar.trackStyleOverride;
-  interaction->scrollThumbBaseOverride = normalized.scrollBar.thumbStyleOverride;
-  interaction->scrollTrackHoverOpacity = normalized.scrollBar.trackHoverOpacity;
-  interaction->scrollTrackPressedOpacity = normalized.scrollBar.trackPressedOpacity;
-  interaction->scrollThumbHoverOpacity = normalized.scrollBar.thumbHoverOpacity;
-  interaction->scrollThumbPressedOpacity = normalized.scrollBar.thumbPressedOpacity;
-
-  UiNode rowsNode = treeNode.createVerticalStack(rowsSpec);
+  interaction->scrollTrackBaseOverride = spec.scrollBar.trackStyleOverride;
+  interaction->scrollThumbBaseOverride = spec.scrollBar.thumbStyleOverride;
+  interaction->scrollBar = spec.scrollBar;
+  interaction->scrollTrackHoverOpacity = spec.scrollBar.trackHoverOpacity;
+  interaction->scrollTrackPressedOpacity = spec.scrollBar.trackPressedOpacity;
+  interaction->scrollThumbHoverOpacity = spec.scrollBar.thumbHoverOpacity;
+  interaction->scrollThumbPressedOpacity = spec.scrollBar.thumbPressedOpacity;
+
+  UiNode rowsNode = windowed ? treeNode.createOverlay(rowsSpec)
+                             : treeNode.createVerticalStack(rowsSpec);
   interaction->viewportNode = rowsNode.nodeId();
   if (PrimeFrame::Node* rowsNodePtr = runtimeFrame.getNode(rowsNode.nodeId())) {
     rowsNodePtr->isViewport = true;
@@ -395,30 +405,51 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     rowsNodePtr->hitTestVisible = enabled;
   }
 
-  auto makeRowInfo = [interaction](int rowIndex) {
+  auto makeRowInfo = [interaction, window](int rowIndex) {
     TreeViewRowInfo info;
     info.rowIndex = rowIndex;
-    if (rowIndex >= 0 && rowIndex < static_cast<int>(interaction->rows.size())) {
-      const auto& row = interaction->rows[static_cast<size_t>(rowIndex)];
-      info.path = row.path;
-      info.hasChildren = row.hasChildren;
-      info.expanded = row.expanded;
+    Internal::FlatTree const& rowTree = window->tree;
+    if (rowIndex >= 0 && rowIndex < static_cast<int>(rowTree.size())) {
+      size_t index = static_cast<size_t>(rowIndex);
+      rowTree.path(index, interaction->pathScratch);
+      info.path = interaction->pathScratch;
+      info.hasChildren = rowTree.hasChildren(index);
+      info.expanded = rowTree.expanded(index);
     }
     return info;
   };
 
-  auto updateRowVisual = [interaction](int rowIndex) {
-    if (rowIndex < 0 || rowIndex >= static_cast<int>(interaction->rows.size())) {
-      return;
+  auto updateRowVisual = [interaction, window](int rowIndex) {
+    TreeViewRowVisual row;
+    if (!window->slots.empty()) {
+      if (rowIndex < 0 || rowIndex >= static_cast<int>(window->tree.size())) {
+        return;
+      }
+      size_t slotIndex = static_cast<size_t>(rowIndex) % window->slots.size();
+      Internal::TreeRowSlot const& slot = window->slots[slotIndex];
+      if (slot.rowIndex != rowIndex) {
+        return;
+      }
+      row.background = slot.background;
+      row.mask = slot.mask;
+      row.hasMask = slot.mask != 0 && window->tree.depth(static_cast<size_t>(rowIndex)) > 0;
+      row.label = slot.labelPrim;
+      row.accent = slot.accent;
+      row.hasAccent = slot.accent != 0;
+    } else {
+      if (rowIndex < 0 || rowIndex >= static_cast<int>(interaction->rows.size())) {
+        return;
+      }
+      row = interaction->rows[static_cast<size_t>(rowIndex)];
     }
-    auto& row = interaction->rows[static_cast<size_t>(rowIndex)];
     bool selected = (rowIndex == interaction->selectedRow);
     bool hovered = (rowIndex == interaction->hoveredRow);
-    PrimeFrame::RectStyleToken style = row.baseStyle;
+    PrimeFrame::RectStyleToken style =
+        rowIndex % 2 == 0 ? interaction->rowAltStyle : interaction->rowStyle;
     if (selected) {
-      style = row.selectionStyle;
-    } else if (hovered && row.hoverStyle != 0) {
-      style = row.hoverStyle;
+      style = interaction->selectionStyle;
+    } else if (hovered && interaction->hoverStyle != 0) {
+      style = interaction->hoverStyle;
     }
     if (PrimeFrame::Primitive* prim = interaction->frame->getPrimitive(row.background)) {
       if (prim->type == PrimeFrame::PrimitiveType::Rect) {
@@ -434,7 +465,7 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     }
     if (PrimeFrame::Primitive* prim = interaction->frame->getPrimitive(row.label)) {
       if (prim->type == PrimeFrame::PrimitiveType::Text) {
-        prim->textStyle.token = selected ? row.selectedTextStyle : row.textStyle;
+        prim->textStyle.token = selected ? interaction->selectedTextStyle : interaction->textStyle;
       }
     }
     if (row.hasAccent) {
@@ -467,22 +498,66 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     }
   };
 
-  auto requestToggle = [interaction, makeRowInfo](int rowIndex, bool expanded) {
-    if (rowIndex < 0 || rowIndex >= static_cast<int>(interaction->rows.size())) {
+  auto syncRowWindow = [interaction, window, updateRowVisual]() {
+    if (window->slots.empty()) {
       return;
     }
-    auto& row = interaction->rows[static_cast<size_t>(rowIndex)];
-    if (!row.hasChildren) {
-      return;
+    int rowCount = static_cast<int>(window->tree.size());
+    int poolSize = static_cast<int>(window->slots.size());
+    Internal::CollectionRowWindow rows = Internal::collectionRowWindow(interaction->scrollOffset,
+                                                                       window->geometry.rowHeight,
+                                                                       window->geometry.rowGap,
+                                                                       window->overscanRows,
+                                                                       poolSize,
+                                                                       rowCount);
+    int dirtyRow = window->dirtyRow;
+    window->dirtyRow = -1;
+    for (int rowIndex = rows.first; rowIndex < rows.last; ++rowIndex) {
+      Internal::TreeRowSlot& slot = window->slots[static_cast<size_t>(rowIndex % poolSize)];
+      if (slot.rowIndex == rowIndex && (dirtyRow < 0 || rowIndex < dirtyRow)) {
+        continue;
+      }
+      FlatTreeRow row = window->tree.row(static_cast<size_t>(rowIndex));
+      window->connectorRects.clear();
+      if (window->showConnectors && row.depth > 0) {
+        Internal::collectTreeConnectorRects(window->tree,
+                                            static_cast<size_t>(rowIndex),
+                                            window->geometry,
+                                            window->connectorRects);
+      }
+      Internal::bindTreeRowSlot(*interaction->frame,
+                                slot,
+                                rowIndex,
+                                row,
+                                window->connectorRects,
+                                window->geometry,
+                                window->visible);
+      updateRowVisual(rowIndex);
     }
-    row.expanded = expanded;
-    if (interaction->callbacks.onExpandedChanged) {
-      TreeViewRowInfo info = makeRowInfo(rowIndex);
-      interaction->callbacks.onExpandedChanged(info, expanded);
+    // A tree shorter than the pool, or one that rows were spliced out of, leaves slots unbound.
+    for (Internal::TreeRowSlot& slot : window->slots) {
+      if (slot.rowIndex >= 0 && slot.rowIndex < rowCount) {
+        continue;
+      }
+      Internal::releaseTreeRowSlot(*interaction->frame, slot);
+    }
+  };
+
+  auto refreshHover = [interaction, window, setHovered]() {
+    int rowIndex = -1;
+    if (interaction->hoverPointerY.has_value()) {
+      Internal::TreeRowGeometry const& rowGeometry = window->geometry;
+      rowIndex = Internal::collectionRowAt(*interaction->hoverPointerY + interaction->scrollOffset,
+                                           rowGeometry.rowHeight,
+                                           rowGeometry.rowGap,
+                                           static_cast<int>(window->tree.size()));
     }
+    setHovered(rowIndex);
   };
 
-  auto applyScroll = [interaction](float offset, bool notify, bool force = false) {
+  auto applyScroll = [interaction, syncRowWindow, refreshHover](float offset,
+                                                                bool notify,
+                                                                bool force = false) {
     float clamped = offset;
     if (interaction->maxScroll <= 0.0f) {
       clamped = 0.0f;
@@ -496,6 +571,9 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     if (PrimeFrame::Node* viewport = interaction->frame->getNode(interaction->viewportNode)) {
       viewport->scrollY = clamped;
     }
+    LayoutRequestScope::request();
+    syncRowWindow();
+    refreshHover();
     if (interaction->scrollThumbNode.isValid() && interaction->trackH > 0.0f) {
       float travel = std::max(0.0f, interaction->trackH - interaction->thumbH);
       float progress = (interaction->maxScroll > 0.0f) ? (clamped / interaction->maxScroll) : 0.0f;
@@ -516,13 +594,14 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
   };
 
   auto ensureRowVisible = [interaction,
+                           window,
                            applyScroll,
-                           rowHeight = normalized.rowHeight,
-                           rowGap = normalized.rowGap](int rowIndex) {
+                           rowHeight = spec.rowHeight,
+                           rowGap = spec.rowGap](int rowIndex) {
     if (!interaction->scrollEnabled) {
       return;
     }
-    if (rowIndex < 0 || rowIndex >= static_cast<int>(interaction->rows.size())) {
+    if (rowIndex < 0 || rowIndex >= static_cast<int>(window->tree.size())) {
       return;
     }
     float rowPitch = std::max(1.0f, rowHeight + rowGap);
@@ -538,8 +617,9 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     }
   };
 
-  auto setSelected = [interaction, updateRowVisual, makeRowInfo, ensureRowVisible](int rowIndex) {
-    if (rowIndex < 0 || rowIndex >= static_cast<int>(interaction->rows.size())) {
+  auto setSelected = [interaction, window, updateRowVisual, makeRowInfo, ensureRowVisible](
+                         int rowIndex) {
+    if (rowIndex < 0 || rowIndex >= static_cast<int>(window->tree.size())) {
       return false;
     }
     if (interaction->selectedRow == rowIndex) {
@@ -570,6 +650,89 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     return true;
   };
 
+  // Re-derives the scroll extents after rows below `rowIndex` were spliced in or out, then
+  // rebinds the slots from that row down. Rows above it keep their nodes untouched.
+  auto applyRowSplice = [interaction, window, applyScroll, setSelected](int rowIndex, int delta) {
+    bool selectionHidden = false;
+    if (interaction->selectedRow > rowIndex) {
+      if (delta < 0 && interaction->selectedRow <= rowIndex - delta) {
+        interaction->selectedRow = -1;
+        selectionHidden = true;
+      } else {
+        interaction->selectedRow += delta;
+      }
+    }
+    if (interaction->lastClickRow > rowIndex) {
+      interaction->lastClickRow = -1;
+    }
+    Internal::TreeRowGeometry const& rowGeometry = window->geometry;
+    size_t rowCount = window->tree.size();
+    interaction->contentHeight =
+        rowCount == 0u ? rowGeometry.rowHeight
+                       : static_cast<float>(rowCount) * rowGeometry.rowHeight +
+                             static_cast<float>(rowCount - 1u) * rowGeometry.rowGap;
+    interaction->maxScroll =
+        std::max(0.0f, interaction->contentHeight - interaction->viewportHeight);
+    interaction->scrollEnabled = interaction->maxScroll > 0.0f;
+    if (interaction->scrollThumbNode.isValid()) {
+      interaction->thumbH = scroll_thumb_height(interaction->scrollBar,
+                                                interaction->trackH,
+                                                interaction->viewportHeight,
+                                                interaction->contentHeight);
+      if (PrimeFrame::Node* thumbNode = interaction->frame->getNode(interaction->scrollThumbNode)) {
+        thumbNode->sizeHint.height.preferred = interaction->thumbH;
+        thumbNode->visible = window->visible && interaction->scrollEnabled;
+      }
+      if (PrimeFrame::Node* trackNode = interaction->frame->getNode(interaction->scrollTrackNode)) {
+        trackNode->visible = window->visible && interaction->scrollEnabled;
+      }
+    }
+    window->dirtyRow = rowIndex;
+    applyScroll(interaction->scrollOffset, true, true);
+    if (selectionHidden) {
+      // The selection was inside the collapsed branch; it moves to the branch itself.
+      setSelected(rowIndex);
+    }
+  };
+
+  auto requestToggle = [interaction, window, makeRowInfo, applyRowSplice](int rowIndex,
+                                                                          bool expanded) {
+    Internal::FlatTree& rowTree = window->tree;
+    if (rowIndex < 0 || rowIndex >= static_cast<int>(rowTree.size())) {
+      return;
+    }
+    size_t row = static_cast<size_t>(rowIndex);
+    if (!rowTree.hasChildren(row)) {
+      return;
+    }
+    if (window->state) {
+      if (rowTree.expanded(row) == expanded) {
+        return;
+      }
+      WidgetIdentityId key = rowTree.keys[rowTree.node(row)];
+      if (key != InvalidWidgetIdentityId) {
+        window->state->expanded[key] = expanded;
+      }
+      int delta = 0;
+      if (TreeDataProvider* provider = rowTree.provider) {
+        // Provider trees hold only visible nodes; reflattening reads cached branches and only
+        // enumerates the one being expanded.
+        size_t previousRows = rowTree.size();
+        Internal::flattenTree(*provider, *window->state, rowTree);
+        delta = static_cast<int>(rowTree.size()) - static_cast<int>(previousRows);
+      } else {
+        delta = rowTree.spliceExpanded(row, expanded);
+      }
+      applyRowSplice(rowIndex, delta);
+    } else {
+      rowTree.setExpanded(row, expanded);
+    }
+    if (interaction->callbacks.onExpandedChanged) {
+      TreeViewRowInfo info = makeRowInfo(rowIndex);
+      interaction->callbacks.onExpandedChanged(info, expanded);
+    }
+  };
+
   auto applyScrollHover = [interaction]() {
     bool hovered = interaction->scrollHoverCount > 0;
     bool pressed = interaction->scrollDragging;
@@ -612,21 +775,124 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
   constexpr int KeyPageUp = keyCodeInt(KeyCode::PageUp);
   constexpr int KeyPageDown = keyCodeInt(KeyCode::PageDown);
 
-  for (size_t i = 0; i < rows.size(); ++i) {
-    FlatTreeRow const& row = rows[i];
+  // `rowX` and `rowY` locate the pointer inside row `rowIndex`, which is -1 between rows.
+  auto handleRowEvent = [interaction,
+                         window,
+                         setHovered,
+                         setSelected,
+                         requestToggle,
+                         makeRowInfo](int rowIndex,
+                                      float rowX,
+                                      float rowY,
+                                      PrimeFrame::Event const& event) -> bool {
+    Internal::FlatTree const& rowTree = window->tree;
+    auto onCaret = [&]() {
+      if (rowIndex < 0 || rowIndex >= static_cast<int>(rowTree.size())) {
+        return false;
+      }
+      size_t index = static_cast<size_t>(rowIndex);
+      if (!rowTree.hasChildren(index)) {
+        return false;
+      }
+      Internal::TreeRowGeometry const& rowGeometry = window->geometry;
+      int depth = rowTree.depth(index);
+      float indent = depth > 0 ? rowGeometry.indent * static_cast<float>(depth) : 0.0f;
+      float glyphX = rowGeometry.caretBaseX + indent;
+      float glyphY = (rowGeometry.rowHeight - rowGeometry.caretSize) * 0.5f;
+      return rowX >= glyphX && rowX <= glyphX + rowGeometry.caretSize &&
+             rowY >= glyphY && rowY <= glyphY + rowGeometry.caretSize;
+    };
+
+    switch (event.type) {
+      case PrimeFrame::EventType::PointerEnter:
+        setHovered(rowIndex);
+        return true;
+      case PrimeFrame::EventType::PointerMove:
+        setHovered(rowIndex);
+        return false;
+      case PrimeFrame::EventType::PointerLeave:
+        setHovered(-1);
+        return true;
+      case PrimeFrame::EventType::PointerDown: {
+        if (rowIndex < 0) {
+          return false;
+        }
+        setSelected(rowIndex);
+        bool toggled = false;
+        if (onCaret()) {
+          requestToggle(rowIndex, !rowTree.expanded(static_cast<size_t>(rowIndex)));
+          toggled = true;
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (!toggled &&
+            interaction->doubleClickThreshold.count() > 0.0 &&
+            interaction->lastClickRow == rowIndex &&
+            interaction->lastClickTime.time_since_epoch().count() != 0) {
+          if (now - interaction->lastClickTime <= interaction->doubleClickThreshold) {
+            size_t index = static_cast<size_t>(rowIndex);
+            if (rowTree.hasChildren(index)) {
+              requestToggle(rowIndex, !rowTree.expanded(index));
+            } else if (interaction->callbacks.onActivate) {
+              TreeViewRowInfo info = makeRowInfo(rowIndex);
+              interaction->callbacks.onActivate(info);
+            } else if (interaction->callbacks.onActivated) {
+              TreeViewRowInfo info = makeRowInfo(rowIndex);
+              interaction->callbacks.onActivated(info);
+            }
+          }
+        }
+        interaction->lastClickRow = rowIndex;
+        interaction->lastClickTime = now;
+        if (interaction->timers && interaction->doubleClickThreshold.count() > 0.0) {
+          // Expire the pending click so stale double-click state never outlives its window.
+          if (interaction->clickExpiryTimer != InvalidTimerId) {
+            interaction->timers->cancel(interaction->clickExpiryTimer);
+          }
+          std::weak_ptr<TreeViewInteractionState> weakInteraction = interaction;
+          auto deadline = now + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    interaction->doubleClickThreshold);
+          interaction->clickExpiryTimer =
+              interaction->timers->schedule(deadline, [weakInteraction]() {
+                std::shared_ptr<TreeViewInteractionState> locked = weakInteraction.lock();
+                if (!locked) {
+                  return;
+                }
+                locked->clickExpiryTimer = InvalidTimerId;
+                locked->lastClickRow = -1;
+                locked->lastClickTime = {};
+              }, TimerEffect::StateOnly);
+        }
+        return true;
+      }
+      default:
+        break;
+    }
+    return false;
+  };
+
+  for (size_t i = 0; i < tree.size(); ++i) {
+    if (tree.selected(i) && interaction->selectedRow < 0) {
+      interaction->selectedRow = static_cast<int>(i);
+    }
+    if (windowed) {
+      // Nodes come from the recycled row window.
+      continue;
+    }
+    FlatTreeRow row = tree.row(i);
     PrimeFrame::RectStyleToken baseRole =
-        (i % 2 == 0 ? normalized.rowAltStyle : normalized.rowStyle);
-    PrimeFrame::RectStyleToken rowRole = row.selected ? normalized.selectionStyle : baseRole;
+        (i % 2 == 0 ? spec.rowAltStyle : spec.rowStyle);
+    PrimeFrame::RectStyleToken rowRole = row.selected ? spec.selectionStyle : baseRole;
 
     PanelSpec rowPanel;
     rowPanel.rectStyle = rowRole;
     rowPanel.layout = PrimeFrame::LayoutType::Overlay;
-    rowPanel.size.preferredHeight = normalized.rowHeight;
+    rowPanel.size.preferredHeight = spec.rowHeight;
     rowPanel.size.preferredWidth = rowWidth;
     rowPanel.size.stretchX = 1.0f;
     rowPanel.clipChildren = false;
-    rowPanel.visible = normalized.visible;
+    rowPanel.visible = spec.visible;
     UiNode rowNode = rowsNode.createPanel(rowPanel);
+    rowNode.setHitTestVisible(false);
     PrimeFrame::NodeId rowId = rowNode.nodeId();
     PrimeFrame::PrimitiveId backgroundPrim = 0;
     if (PrimeFrame::Node* rowNodePtr = runtimeFrame.getNode(rowId)) {
@@ -635,310 +901,73 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
       }
     }
 
-    if (normalized.showConnectors && row.depth > 0 && normalized.visible) {
-      float halfThickness = normalized.connectorThickness * 0.5f;
-      float rowCenterY = normalized.rowHeight * 0.5f;
-      float rowTop = -normalized.rowGap * 0.5f;
-      float rowBottom = normalized.rowHeight + normalized.rowGap * 0.5f;
-
-      auto draw_trunk_segment = [&](size_t depthIndex, int ancestorIndex) {
-        if (ancestorIndex < 0) {
-          return;
-        }
-        FlatTreeRow const& ancestor = rows[static_cast<size_t>(ancestorIndex)];
-        if (!ancestor.hasChildren || !ancestor.expanded) {
-          return;
-        }
-        int first = firstChild[static_cast<size_t>(ancestorIndex)];
-        int last = lastChild[static_cast<size_t>(ancestorIndex)];
-        if (first < 0) {
-          return;
-        }
-        if (static_cast<int>(i) != ancestorIndex &&
-            (static_cast<int>(i) < first || static_cast<int>(i) > last)) {
-          return;
-        }
-        float trunkX = caretBaseX + static_cast<float>(depthIndex) * normalized.indent +
-                       normalized.caretSize * 0.5f;
-        float segmentTop = rowTop;
-        float segmentBottom = rowBottom;
-        if (static_cast<int>(i) == ancestorIndex) {
-          segmentTop = rowCenterY;
-        }
-        if (static_cast<int>(i) == last) {
-          segmentBottom = rowCenterY;
-        }
-        if (segmentBottom > segmentTop + 0.5f) {
-          add_divider_rect(runtimeFrame, rowNode.nodeId(),
-                           Rect{trunkX - halfThickness,
-                                segmentTop - halfThickness,
-                                normalized.connectorThickness,
-                                (segmentBottom - segmentTop) + normalized.connectorThickness},
-                           normalized.connectorStyle);
-        }
-      };
-
-      for (size_t depthIndex = 0; depthIndex < row.ancestors.size(); ++depthIndex) {
-        draw_trunk_segment(depthIndex, row.ancestors[depthIndex]);
-      }
-      if (row.hasChildren && row.expanded) {
-        draw_trunk_segment(static_cast<size_t>(row.depth), static_cast<int>(i));
-      }
-
-      int parentIndex = row.parentIndex;
-      if (parentIndex >= 0) {
-        float trunkX = caretBaseX + static_cast<float>(row.depth - 1) * normalized.indent +
-                       normalized.caretSize * 0.5f;
-        float childTrunkX = caretBaseX + static_cast<float>(row.depth) * normalized.indent +
-                            normalized.caretSize * 0.5f;
-        float linkStartX = trunkX - halfThickness;
-        float linkEndX = childTrunkX + halfThickness;
-        float linkW = linkEndX - linkStartX;
-        if (linkW > 0.5f) {
-          add_divider_rect(runtimeFrame, rowNode.nodeId(),
-                           Rect{linkStartX,
-                                rowCenterY - halfThickness,
-                                linkW,
-                                normalized.connectorThickness},
-                           normalized.connectorStyle);
-        }
-      }
-    }
-
-    float indent = (row.depth > 0) ? normalized.indent * static_cast<float>(row.depth) : 0.0f;
-    float glyphX = caretBaseX + indent;
-    float glyphY = (normalized.rowHeight - normalized.caretSize) * 0.5f;
-
-    PrimeFrame::PrimitiveId maskPrim = 0;
-    bool hasMask = false;
-    if (normalized.showCaretMasks && row.depth > 0 && normalized.visible) {
-      float maskPad = normalized.caretMaskPad;
-      PrimeFrame::NodeId maskId = create_rect_node(runtimeFrame,
-                                                   rowId,
-                                                   Rect{glyphX - maskPad,
-                                                        glyphY - maskPad,
-                                                        normalized.caretSize + maskPad * 2.0f,
-                                                        normalized.caretSize + maskPad * 2.0f},
-                                                   rowRole,
-                                                   {},
-                                                   false,
-                                                   normalized.visible);
-      if (PrimeFrame::Node* maskNode = runtimeFrame.getNode(maskId)) {
-        if (!maskNode->primitives.empty()) {
-          maskPrim = maskNode->primitives.front();
-          hasMask = true;
-        }
-      }
+    window->connectorRects.clear();
+    if (window->showConnectors && row.depth > 0) {
+      Internal::collectTreeConnectorRects(tree, i, geometry, window->connectorRects);
     }
+    Internal::TreeRowParts parts = Internal::createTreeRowParts(
+        runtimeFrame, rowId, row, window->connectorRects, rowRole, spec, geometry);
 
-    if (row.hasChildren) {
-      create_rect_node(runtimeFrame,
-                       rowId,
-                       Rect{glyphX, glyphY, normalized.caretSize, normalized.caretSize},
-                       normalized.caretBackgroundStyle,
-                       {},
-                       false,
-                       normalized.visible);
-
-      create_rect_node(runtimeFrame,
-                       rowId,
-                       Rect{glyphX + normalized.caretInset,
-                            glyphY + normalized.caretSize * 0.5f - normalized.caretThickness * 0.5f,
-                            normalized.caretSize - normalized.caretInset * 2.0f,
-                            normalized.caretThickness},
-                       normalized.caretLineStyle,
-                       {},
-                       false,
-                       normalized.visible);
-      if (!row.expanded) {
-        create_rect_node(runtimeFrame,
-                         rowId,
-                         Rect{glyphX + normalized.caretSize * 0.5f -
-                                  normalized.caretThickness * 0.5f,
-                              glyphY + normalized.caretInset,
-                              normalized.caretThickness,
-                              normalized.caretSize - normalized.caretInset * 2.0f},
-                         normalized.caretLineStyle,
-                         {},
-                         false,
-                         normalized.visible);
-      }
-    } else {
-      create_rect_node(runtimeFrame,
-                       rowId,
-                       Rect{glyphX, glyphY, normalized.caretSize, normalized.caretSize},
-                       normalized.caretBackgroundStyle,
-                       {},
-                       false,
-                       normalized.visible);
-
-      float dot = std::max(2.0f, normalized.caretThickness);
-      create_rect_node(runtimeFrame,
-                       rowId,
-                       Rect{glyphX + normalized.caretSize * 0.5f - dot * 0.5f,
-                            glyphY + normalized.caretSize * 0.5f - dot * 0.5f,
-                            dot,
-                            dot},
-                       normalized.caretLineStyle,
-                       {},
-                       false,
-                       normalized.visible);
-    }
+    TreeViewRowVisual visual;
+    visual.background = backgroundPrim;
+    visual.accent = parts.accent;
+    visual.mask = parts.mask;
+    visual.label = parts.label;
+    visual.hasAccent = parts.hasAccent;
+    visual.hasMask = parts.hasMask;
 
-    float textX = normalized.rowStartX + 20.0f + indent;
-    PrimeFrame::TextStyleToken textRole =
-        row.selected ? normalized.selectedTextStyle : normalized.textStyle;
-    float lineHeight = row.selected ? selectedTextHeight : rowTextHeight;
-    float textY = (normalized.rowHeight - lineHeight) * 0.5f;
-    float labelWidth = std::max(0.0f, rowWidth - normalized.rowWidthInset - textX);
-    PrimeFrame::NodeId labelId = create_text_node(runtimeFrame,
-                                                  rowId,
-                                                  Rect{textX, textY, labelWidth, lineHeight},
-                                                  row.label,
-                                                  textRole,
-                                                  {},
-                                                  PrimeFrame::TextAlign::Start,
-                                                  PrimeFrame::WrapMode::None,
-                                                  labelWidth,
-                                                  normalized.visible);
-    PrimeFrame::PrimitiveId labelPrim = 0;
-    if (PrimeFrame::Node* labelNode = runtimeFrame.getNode(labelId)) {
-      if (!labelNode->primitives.empty()) {
-        labelPrim = labelNode->primitives.front();
-      }
-    }
+    interaction->rows.push_back(visual);
+  }
 
-    PrimeFrame::PrimitiveId accentPrim = 0;
-    bool hasAccent = false;
-    if (normalized.selectionAccentWidth > 0.0f &&
-        normalized.selectionAccentStyle != 0 &&
-        normalized.visible) {
-      PrimeFrame::RectStyleOverride accentOverride;
-      if (!row.selected) {
-        accentOverride.opacity = 0.0f;
-      }
-      PrimeFrame::NodeId accentId = create_rect_node(runtimeFrame,
-                                                     rowId,
-                                                     Rect{0.0f,
-                                                          0.0f,
-                                                          normalized.selectionAccentWidth,
-                                                          normalized.rowHeight},
-                                                     normalized.selectionAccentStyle,
-                                                     accentOverride,
-                                                     false,
-                                                     normalized.visible);
-      if (PrimeFrame::Node* accentNode = runtimeFrame.getNode(accentId)) {
-        if (!accentNode->primitives.empty()) {
-          accentPrim = accentNode->primitives.front();
-          hasAccent = true;
-        }
-      }
+  if (windowed) {
+    // Owned expansion can reveal every flattened node, and a provider any number of unloaded
+    // ones, so the pool is not capped by the rows visible right now.
+    size_t poolRows = window->state ? tree.nodeCount() : tree.size();
+    if (tree.provider) {
+      poolRows = static_cast<size_t>(std::numeric_limits<int>::max());
     }
-
-    TreeViewRowVisual visual;
-    visual.background = backgroundPrim;
-    visual.accent = accentPrim;
-    visual.mask = maskPrim;
-    visual.label = labelPrim;
-    visual.baseStyle = baseRole;
-    visual.hoverStyle = normalized.hoverStyle;
-    visual.selectionStyle = normalized.selectionStyle;
-    visual.textStyle = normalized.textStyle;
-    visual.selectedTextStyle = normalized.selectedTextStyle;
-    visual.hasAccent = hasAccent;
-    visual.hasMask = hasMask;
-    visual.hasChildren = row.hasChildren;
-    visual.expanded = row.expanded;
-    visual.depth = row.depth;
-    visual.parentIndex = row.parentIndex;
-    visual.path = row.path;
-
-    int rowIndex = static_cast<int>(interaction->rows.size());
-    interaction->rows.push_back(std::move(visual));
-    if (row.selected && interaction->selectedRow < 0) {
-      interaction->selectedRow = rowIndex;
+    int poolSize = Internal::collectionRowPoolSize(viewportHeight,
+                                                   geometry.rowHeight,
+                                                   geometry.rowGap,
+                                                   window->overscanRows,
+                                                   static_cast<int>(poolRows));
+    window->slots.reserve(static_cast<size_t>(poolSize));
+    for (int slotIndex = 0; slotIndex < poolSize; ++slotIndex) {
+      window->slots.push_back(
+          Internal::createTreeRowSlot(runtimeFrame, rowsNode, spec, geometry));
     }
+    syncRowWindow();
+  }
 
-    if (enabled) {
-      PrimeFrame::Callback rowCallback;
-      rowCallback.onEvent = [interaction,
-                             rowIndex,
-                             glyphX,
-                             glyphY,
-                             caretSize = normalized.caretSize,
-                             updateRowVisual,
-                             setHovered,
-                             setSelected,
-                             requestToggle,
-                             makeRowInfo](PrimeFrame::Event const& event) mutable -> bool {
-      auto onCaret = [&]() {
-        if (rowIndex < 0 || rowIndex >= static_cast<int>(interaction->rows.size())) {
-          return false;
-        }
-        const auto& row = interaction->rows[static_cast<size_t>(rowIndex)];
-        if (!row.hasChildren) {
-          return false;
-        }
-        return event.localX >= glyphX && event.localX <= glyphX + caretSize &&
-               event.localY >= glyphY && event.localY <= glyphY + caretSize;
-      };
-
-      switch (event.type) {
-        case PrimeFrame::EventType::PointerEnter:
-          setHovered(rowIndex);
-          return true;
-        case PrimeFrame::EventType::PointerLeave:
-          if (interaction->hoveredRow == rowIndex) {
-            setHovered(-1);
-          }
-          return true;
-        case PrimeFrame::EventType::PointerDown: {
-          setSelected(rowIndex);
-          bool toggled = false;
-          if (onCaret()) {
-            const auto& row = interaction->rows[static_cast<size_t>(rowIndex)];
-            requestToggle(rowIndex, !row.expanded);
-            toggled = true;
-          }
-          auto now = std::chrono::steady_clock::now();
-          if (!toggled &&
-              interaction->doubleClickThreshold.count() > 0.0 &&
-              interaction->lastClickRow == rowIndex &&
-              interaction->lastClickTime.time_since_epoch().count() != 0) {
-            if (now - interaction->lastClickTime <= interaction->doubleClickThreshold) {
-              const auto& row = interaction->rows[static_cast<size_t>(rowIndex)];
-              if (row.hasChildren) {
-                requestToggle(rowIndex, !row.expanded);
-              } else if (interaction->callbacks.onActivate) {
-                TreeViewRowInfo info = makeRowInfo(rowIndex);
-                interaction->callbacks.onActivate(info);
-              } else if (interaction->callbacks.onActivated) {
-                TreeViewRowInfo info = makeRowInfo(rowIndex);
-                interaction->callbacks.onActivated(info);
-              }
-            }
-          }
-          interaction->lastClickRow = rowIndex;
-          interaction->lastClickTime = now;
-          return true;
-        }
-        default:
-          break;
-      }
-      return false;
-      };
-      PrimeFrame::CallbackId rowCallbackId = runtimeFrame.addCallback(std::move(rowCallback));
-      if (PrimeFrame::Node* rowNodePtr = runtimeFrame.getNode(rowId)) {
-        rowNodePtr->callbacks = rowCallbackId;
+  if (enabled) {
+    // Rows are not hit targets; the rows node resolves the row under the pointer from its offset,
+    // so eager and recycled rows alike need no callback of their own.
+    auto onRowsEvent = [interaction, window, handleRowEvent](PrimeFrame::Event const& event) {
+      Internal::TreeRowGeometry const& rowGeometry = window->geometry;
+      float contentY = event.localY + interaction->scrollOffset;
+      int rowIndex = Internal::collectionRowAt(contentY,
+                                               rowGeometry.rowHeight,
+                                               rowGeometry.rowGap,
+                                               static_cast<int>(window->tree.size()));
+      float rowPitch = std::max(1.0f, rowGeometry.rowHeight + rowGeometry.rowGap);
+      float rowY = contentY - rowPitch * static_cast<float>(std::max(0, rowIndex));
+      if (event.type == PrimeFrame::EventType::PointerLeave) {
+        interaction->hoverPointerY.reset();
+      } else if (event.type == PrimeFrame::EventType::PointerEnter ||
+                 event.type == PrimeFrame::EventType::PointerMove) {
+        interaction->hoverPointerY = event.localY;
       }
-    }
+      return handleRowEvent(rowIndex, event.localX, rowY, event);
+    };
+    (void)Internal::appendNodeOnEvent(runtime, rowsNode.nodeId(), std::move(onRowsEvent));
   }
 
-  bool wantsKeyboard = enabled && normalized.keyboardNavigation && !interaction->rows.empty();
-  bool wantsPointerScroll = enabled && interaction->scrollEnabled;
-  bool wantsScrollBar = wantsPointerScroll && normalized.scrollBar.enabled;
-  bool treeFocusable = enabled && (!interaction->rows.empty() || wantsKeyboard);
-  if (normalized.visible) {
+  bool wantsKeyboard = enabled && spec.keyboardNavigation && !tree.empty();
+  // Splicing rows in can make an owned-expansion tree scrollable later.
+  bool wantsPointerScroll = enabled && (interaction->scrollEnabled || spec.state != nullptr);
+  bool wantsScrollBar = wantsPointerScroll && spec.scrollBar.enabled;
+  bool treeFocusable = enabled && (!tree.empty() || wantsKeyboard);
+  if (spec.visible) {
     PrimeFrame::Node* treeNodePtr = runtimeFrame.getNode(treeNode.nodeId());
     if (treeNodePtr) {
       treeNodePtr->focusable = treeFocusable;
@@ -951,9 +980,9 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
                                requestToggle,
                                makeRowInfo,
                                scrollBy,
-                               lastChild,
-                               rowHeight = normalized.rowHeight,
-                               rowGap = normalized.rowGap,
+                               window,
+                               rowHeight = spec.rowHeight,
+                               rowGap = spec.rowGap,
                                wantsKeyboard,
                                wantsPointerScroll](PrimeFrame::Event const& event) {
         if (wantsPointerScroll && event.type == PrimeFrame::EventType::PointerScroll) {
@@ -965,7 +994,7 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
         if (!wantsKeyboard || event.type != PrimeFrame::EventType::KeyDown) {
           return false;
         }
-        int rowCount = static_cast<int>(interaction->rows.size());
+        int rowCount = static_cast<int>(window->tree.size());
         if (rowCount <= 0) {
           return false;
         }
@@ -1013,30 +1042,30 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
           case KeyRight: {
             int index = interaction->selectedRow;
             if (index >= 0 && index < rowCount) {
-              const auto& row = interaction->rows[static_cast<size_t>(index)];
-              if (row.hasChildren) {
-                bool wasExpanded = row.expanded;
+              Internal::FlatTree const& rowTree = window->tree;
+              size_t rowSlot = static_cast<size_t>(index);
+              int parentIndex = rowTree.parentRow(rowSlot);
+              if (rowTree.hasChildren(rowSlot)) {
+                bool wasExpanded = rowTree.expanded(rowSlot);
                 bool wantExpanded = (event.key == KeyRight);
-                if (row.expanded != wantExpanded) {
+                if (wasExpanded != wantExpanded) {
                   requestToggle(index, wantExpanded);
                 }
                 if (event.key == KeyLeft) {
                   if (wasExpanded) {
                     return true;
                   }
-                  if (row.parentIndex >= 0) {
-                    setSelected(row.parentIndex);
+                  if (parentIndex >= 0) {
+                    setSelected(parentIndex);
                   }
-                } else if (event.key == KeyRight && row.expanded) {
-                  int childIndex = (index >= 0 && index < static_cast<int>(lastChild.size()))
-                                       ? lastChild[static_cast<size_t>(index)]
-                                       : -1;
+                } else if (event.key == KeyRight && rowTree.expanded(rowSlot)) {
+                  int childIndex = rowTree.lastChildRow(rowSlot);
                   if (childIndex >= 0) {
                     setSelected(childIndex);
                   }
                 }
-              } else if (event.key == KeyLeft && row.parentIndex >= 0) {
-                setSelected(row.parentIndex);
+              } else if (event.key == KeyLeft && parentIndex >= 0) {
+                setSelected(parentIndex);
               }
             }
             return true;
@@ -1044,9 +1073,9 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
           case KeyEnter: {
             int index = interaction->selectedRow;
             if (index >= 0 && index < rowCount) {
-              const auto& row = interaction->rows[static_cast<size_t>(index)];
-              if (row.hasChildren) {
-                requestToggle(index, !row.expanded);
+              size_t rowSlot = static_cast<size_t>(index);
+              if (window->tree.hasChildren(rowSlot)) {
+                requestToggle(index, !window->tree.expanded(rowSlot));
               } else if (interaction->callbacks.onActivate) {
                 TreeViewRowInfo info = makeRowInfo(index);
                 interaction->callbacks.onActivate(info);
@@ -1068,18 +1097,19 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     }
   }
 
-  if (normalized.showScrollBar && wantsScrollBar && normalized.visible) {
-    float trackX = bounds.width - normalized.scrollBar.inset;
-    float trackY = normalized.scrollBar.padding;
-    float trackH = std::max(0.0f, bounds.height - normalized.scrollBar.padding * 2.0f);
-    float trackW = normalized.scrollBar.width;
+  if (spec.showScrollBar && wantsScrollBar && spec.visible) {
+    float trackX = bounds.width - spec.scrollBar.inset;
+    float trackY = spec.scrollBar.padding;
+    float trackH = std::max(0.0f, bounds.height - spec.scrollBar.padding * 2.0f);
+    float trackW = spec.scrollBar.width;
     PrimeFrame::NodeId trackId = create_rect_node(runtimeFrame,
                                                   treeNode.nodeId(),
                                                   Rect{trackX, trackY, trackW, trackH},
-                                                  normalized.scrollBar.trackStyle,
-                                                  normalized.scrollBar.trackStyleOverride,
+                                                  spec.scrollBar.trackStyle,
+                                                  spec.scrollBar.trackStyleOverride,
                                                   false,
-                                                  normalized.visible);
+                                                  interaction->scrollEnabled);
+    interaction->scrollTrackNode = trackId;
     if (PrimeFrame::Node* trackNode = runtimeFrame.getNode(trackId)) {
       trackNode->hitTestVisible = true;
       if (!trackNode->primitives.empty()) {
@@ -1087,20 +1117,8 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
       }
     }
 
-    float thumbFraction = normalized.scrollBar.thumbFraction;
-    if (normalized.scrollBar.autoThumb) {
-      if (interaction->contentHeight > 0.0f && viewportHeight > 0.0f) {
-        thumbFraction = std::clamp(viewportHeight / interaction->contentHeight, 0.0f, 1.0f);
-      } else {
-        thumbFraction = 1.0f;
-      }
-    }
-
-    float thumbH = trackH * thumbFraction;
-    thumbH = std::max(thumbH, normalized.scrollBar.minThumbHeight);
-    if (thumbH > trackH) {
-      thumbH = trackH;
-    }
+    float thumbH =
+        scroll_thumb_height(spec.scrollBar, trackH, viewportHeight, interaction->contentHeight);
     float maxOffset = std::max(0.0f, trackH - thumbH);
     float progress = (interaction->maxScroll > 0.0f)
                          ? std::clamp(interaction->scrollOffset / interaction->maxScroll, 0.0f, 1.0f)
@@ -1109,10 +1127,10 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
     PrimeFrame::NodeId thumbId = create_rect_node(runtimeFrame,
                                                   treeNode.nodeId(),
                                                   Rect{trackX, thumbY, trackW, thumbH},
-                                                  normalized.scrollBar.thumbStyle,
-                                                  normalized.scrollBar.thumbStyleOverride,
+                                                  spec.scrollBar.thumbStyle,
+                                                  spec.scrollBar.thumbStyleOverride,
                                                   false,
-                                                  normalized.visible);
+                                                  interaction->scrollEnabled);
     if (PrimeFrame::Node* thumbNode = runtimeFrame.getNode(thumbId)) {
       thumbNode->hitTestVisible = true;
       if (!thumbNode->primitives.empty()) {
@@ -1219,16 +1237,16 @@ UiNode UiNode::createTreeView(TreeViewSpec const& spec) {
   }
 
   std::optional<FocusOverlay> focusOverlay;
-  if (normalized.visible && treeFocusable) {
+  if (spec.visible && treeFocusable) {
     ResolvedFocusStyle focusStyle = resolve_focus_style(
         runtimeFrame,
-        normalized.focusStyle,
-        normalized.focusStyleOverride,
-        {normalized.selectionAccentStyle,
-         normalized.selectionStyle,
-         normalized.hoverStyle,
-         normalized.rowStyle,
-         normalized.rowAltStyle});
+        spec.focusStyle,
+        spec.focusStyleOverride,
+        {spec.selectionAccentStyle,
+         spec.selectionStyle,
+         spec.hoverStyle,
+         spec.rowStyle,
+         spec.rowAltStyle});
     Rect overlayRect{0.0f, 0.0f, bounds.width, bounds.height};
     focusOverlay = add_focus_overlay_node(runtime,
                                           treeNode.nodeId(),
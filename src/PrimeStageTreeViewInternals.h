@@ -0,0 +1,163 @@
+#pragma once
+
+#include "PrimeStageCollectionInternals.h"
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace PrimeStage::Internal {
+
+// One visible row, assembled on demand from FlatTree's columns.
+struct FlatTreeRow {
+  std::string_view label;
+  int depth = 0;
+  bool hasChildren = false;
+  bool expanded = true;
+  bool selected = false;
+};
+
+// A TreeNode hierarchy flattened in pre-order and stored column-wise. Node columns are indexed by
+// node; `rows` lists the visible nodes in display order. It stays sorted, so a node's row is a
+// binary search away. Ancestors and index paths are recovered by walking `parents`, so no node
+// owns an allocation. A tree flattened from a provider leaves `labels` empty and asks the provider
+// for a label when a row needs one.
+struct FlatTree {
+  static constexpr uint8_t HasChildren = 1u << 0;
+  static constexpr uint8_t Expanded = 1u << 1;
+  static constexpr uint8_t Selected = 1u << 2;
+  // Placeholder row under a branch whose children are still loading.
+  static constexpr uint8_t Loading = 1u << 3;
+
+  TreeDataProvider* provider = nullptr;
+  std::vector<std::string_view> labels;
+  std::vector<WidgetIdentityId> keys;
+  std::vector<int> parents;
+  std::vector<int> depths;
+  // Position of the node among its siblings in the source hierarchy.
+  std::vector<uint32_t> childIndices;
+  // Last flattened direct child, or -1; the first one always directly follows its parent.
+  std::vector<int> lastChildren;
+  // One past the node's last flattened descendant.
+  std::vector<uint32_t> subtreeEnds;
+  std::vector<uint8_t> flags;
+  std::vector<uint32_t> rows;
+
+  [[nodiscard]] size_t size() const { return rows.size(); }
+  [[nodiscard]] bool empty() const { return rows.empty(); }
+  [[nodiscard]] size_t nodeCount() const { return keys.size(); }
+  [[nodiscard]] size_t node(size_t row) const { return rows[row]; }
+  [[nodiscard]] std::string_view label(size_t row) const { return nodeLabel(rows[row]); }
+  [[nodiscard]] std::string_view nodeLabel(size_t node) const;
+  [[nodiscard]] int depth(size_t row) const { return depths[rows[row]]; }
+  [[nodiscard]] bool hasChildren(size_t row) const { return (flags[rows[row]] & HasChildren) != 0; }
+  [[nodiscard]] bool expanded(size_t row) const { return (flags[rows[row]] & Expanded) != 0; }
+  [[nodiscard]] bool selected(size_t row) const { return (flags[rows[row]] & Selected) != 0; }
+  // Flips the flag only; the app is expected to rebuild with the new expansion.
+  void setExpanded(size_t row, bool value) {
+    uint8_t& nodeFlags = flags[rows[row]];
+    nodeFlags = static_cast<uint8_t>(value ? (nodeFlags | Expanded) : (nodeFlags & ~Expanded));
+  }
+  // Flips the flag and inserts or removes the row's visible descendants right after it. Returns
+  // the number of rows inserted (positive) or removed (negative).
+  int spliceExpanded(size_t row, bool value);
+  // Row showing `node`, or -1 while it is hidden under a collapsed ancestor.
+  [[nodiscard]] int rowOfNode(int node) const;
+  [[nodiscard]] int parentRow(size_t row) const;
+  [[nodiscard]] int lastChildRow(size_t row) const;
+  [[nodiscard]] FlatTreeRow row(size_t row) const;
+  // Child indices from the roots down to `row`.
+  void path(size_t row, std::vector<uint32_t>& out) const;
+};
+
+// Row geometry shared by eagerly built rows and the recycled rows of a virtualized tree.
+struct TreeRowGeometry {
+  float rowHeight = 0.0f;
+  float rowGap = 0.0f;
+  float rowWidth = 0.0f;
+  float rowStartX = 0.0f;
+  float rowWidthInset = 0.0f;
+  float indent = 0.0f;
+  float caretBaseX = 0.0f;
+  float caretSize = 0.0f;
+  float caretInset = 0.0f;
+  float caretThickness = 0.0f;
+  float caretMaskPad = 0.0f;
+  float connectorThickness = 0.0f;
+  float rowTextHeight = 0.0f;
+  float selectedTextHeight = 0.0f;
+};
+
+// One recycled row of a virtualized tree: a row node carrying the connectors, caret, mask and
+// selection accent as primitives, plus a label node. Binding a row moves, retexts and shows or
+// hides the parts instead of creating nodes; connector primitives are added as deeper rows bind.
+struct TreeRowSlot {
+  PrimeFrame::NodeId row{};
+  PrimeFrame::PrimitiveId background = 0;
+  std::vector<PrimeFrame::PrimitiveId> connectors;
+  PrimeFrame::RectStyleToken connectorStyle = 0;
+  PrimeFrame::PrimitiveId mask = 0;
+  PrimeFrame::PrimitiveId caretBackground = 0;
+  PrimeFrame::PrimitiveId caretHorizontal = 0;
+  PrimeFrame::PrimitiveId caretVertical = 0;
+  PrimeFrame::PrimitiveId leafDot = 0;
+  PrimeFrame::NodeId label{};
+  PrimeFrame::PrimitiveId labelPrim = 0;
+  PrimeFrame::PrimitiveId accent = 0;
+  int rowIndex = -1;
+};
+
+// Primitives of an eagerly built row that change with selection and hover.
+struct TreeRowParts {
+  PrimeFrame::PrimitiveId mask = 0;
+  PrimeFrame::PrimitiveId label = 0;
+  PrimeFrame::PrimitiveId accent = 0;
+  bool hasMask = false;
+  bool hasAccent = false;
+};
+
+// Flattens the hierarchy in one iterative pre-order pass, so depth is bounded by memory rather
+// than the call stack. Without `state` only expanded branches are flattened; with it, collapsed
+// branches are kept as hidden nodes and expansion comes from `state` where it has an entry.
+void flattenTree(std::vector<TreeNode> const& nodes, TreeViewState const* state, FlatTree& out);
+
+// Flattens the expanded branches of a provider's hierarchy; every flattened node is visible.
+// Expansion comes from `state` (collapsed by default), and an expanded branch that is still loading
+// gets a single Loading placeholder child.
+void flattenTree(TreeDataProvider& provider, TreeViewState const& state, FlatTree& out);
+
+// Trunk and link segments drawn for row `row`, in row-local coordinates.
+void collectTreeConnectorRects(FlatTree const& tree,
+                               size_t row,
+                               TreeRowGeometry const& geometry,
+                               std::vector<InternalRect>& out);
+
+// Adds the connectors, caret mask, caret glyph and selection accent of an eagerly built row as
+// primitives on the row node, and its label as the row's only child node, so the node count per
+// row does not grow with depth.
+TreeRowParts createTreeRowParts(PrimeFrame::Frame& frame,
+                                PrimeFrame::NodeId rowId,
+                                FlatTreeRow const& row,
+                                std::span<InternalRect const> connectors,
+                                PrimeFrame::RectStyleToken rowRole,
+                                TreeViewSpec const& spec,
+                                TreeRowGeometry const& geometry);
+
+// Hides a slot whose row scrolled out of a shrunken tree.
+void releaseTreeRowSlot(PrimeFrame::Frame& frame, TreeRowSlot& slot);
+
+TreeRowSlot createTreeRowSlot(PrimeFrame::Frame& frame,
+                              UiNode& rowsNode,
+                              TreeViewSpec const& spec,
+                              TreeRowGeometry const& geometry);
+
+void bindTreeRowSlot(PrimeFrame::Frame& frame,
+                     TreeRowSlot& slot,
+                     int rowIndex,
+                     FlatTreeRow const& row,
+                     std::span<InternalRect const> connectors,
+                     TreeRowGeometry const& geometry,
+                     bool visible);
+
+} // namespace PrimeStage::Internal
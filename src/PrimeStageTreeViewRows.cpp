@@ -0,0 +1,651 @@
+#include "PrimeStage/PrimeStage.h"
+
+#include "PrimeStageTreeViewInternals.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+
+namespace PrimeStage::Internal {
+
+namespace {
+
+void place_node(PrimeFrame::Frame& frame,
+                PrimeFrame::NodeId nodeId,
+                InternalRect const& rect,
+                bool visible) {
+  PrimeFrame::Node* node = frame.getNode(nodeId);
+  if (!node) {
+    return;
+  }
+  node->localX = rect.x;
+  node->localY = rect.y;
+  if (rect.width > 0.0f) {
+    node->sizeHint.width.preferred = rect.width;
+  } else {
+    node->sizeHint.width.preferred.reset();
+  }
+  if (rect.height > 0.0f) {
+    node->sizeHint.height.preferred = rect.height;
+  } else {
+    node->sizeHint.height.preferred.reset();
+  }
+  node->visible = visible;
+}
+
+void hide_node(PrimeFrame::Frame& frame, PrimeFrame::NodeId nodeId) {
+  if (PrimeFrame::Node* node = frame.getNode(nodeId)) {
+    node->visible = false;
+  }
+}
+
+PrimeFrame::PrimitiveId add_rect_primitive(
+    PrimeFrame::Frame& frame,
+    PrimeFrame::NodeId nodeId,
+    InternalRect const& rect,
+    PrimeFrame::RectStyleToken token,
+    PrimeFrame::RectStyleOverride const& overrideStyle = {}) {
+  PrimeFrame::Primitive prim;
+  prim.type = PrimeFrame::PrimitiveType::Rect;
+  prim.offsetX = rect.x;
+  prim.offsetY = rect.y;
+  prim.width = rect.width;
+  prim.height = rect.height;
+  prim.rect.token = token;
+  prim.rect.overrideStyle = overrideStyle;
+  PrimeFrame::PrimitiveId pid = frame.addPrimitive(prim);
+  if (PrimeFrame::Node* node = frame.getNode(nodeId)) {
+    node->primitives.push_back(pid);
+  }
+  return pid;
+}
+
+// Hidden row parts keep their primitive at zero opacity, so paint order never changes.
+void place_primitive(PrimeFrame::Frame& frame,
+                     PrimeFrame::PrimitiveId primId,
+                     InternalRect const& rect,
+                     bool visible) {
+  PrimeFrame::Primitive* prim = frame.getPrimitive(primId);
+  if (!prim) {
+    return;
+  }
+  prim->offsetX = rect.x;
+  prim->offsetY = rect.y;
+  prim->width = rect.width;
+  prim->height = rect.height;
+  if (visible) {
+    prim->rect.overrideStyle.opacity.reset();
+  } else {
+    prim->rect.overrideStyle.opacity = 0.0f;
+  }
+}
+
+void hide_primitive(PrimeFrame::Frame& frame, PrimeFrame::PrimitiveId primId) {
+  if (PrimeFrame::Primitive* prim = frame.getPrimitive(primId)) {
+    prim->rect.overrideStyle.opacity = 0.0f;
+  }
+}
+
+PrimeFrame::PrimitiveId first_primitive(PrimeFrame::Frame& frame, PrimeFrame::NodeId nodeId) {
+  PrimeFrame::Node const* node = frame.getNode(nodeId);
+  if (!node || node->primitives.empty()) {
+    return 0;
+  }
+  return node->primitives.front();
+}
+
+} // namespace
+
+int FlatTree::spliceExpanded(size_t row, bool value) {
+  if (row >= rows.size() || !hasChildren(row) || expanded(row) == value) {
+    return 0;
+  }
+  setExpanded(row, value);
+  size_t nodeIndex = rows[row];
+  uint32_t end = subtreeEnds[nodeIndex];
+  auto first = rows.begin() + static_cast<std::ptrdiff_t>(row) + 1;
+  if (!value) {
+    auto last = std::find_if(first, rows.end(), [end](uint32_t index) { return index >= end; });
+    int removed = static_cast<int>(last - first);
+    rows.erase(first, last);
+    return -removed;
+  }
+  // Collapsed descendants are skipped whole, so the walk only touches revealed rows.
+  std::vector<uint32_t> revealed;
+  uint32_t current = static_cast<uint32_t>(nodeIndex) + 1u;
+  while (current < end) {
+    revealed.push_back(current);
+    bool descend = (flags[current] & HasChildren) != 0 && (flags[current] & Expanded) != 0;
+    current = descend ? current + 1u : subtreeEnds[current];
+  }
+  rows.insert(first, revealed.begin(), revealed.end());
+  return static_cast<int>(revealed.size());
+}
+
+int FlatTree::rowOfNode(int nodeIndex) const {
+  if (nodeIndex < 0) {
+    return -1;
+  }
+  auto it = std::lower_bound(rows.begin(), rows.end(), static_cast<uint32_t>(nodeIndex));
+  if (it == rows.end() || *it != static_cast<uint32_t>(nodeIndex)) {
+    return -1;
+  }
+  return static_cast<int>(it - rows.begin());
+}
+
+int FlatTree::parentRow(size_t row) const {
+  return rowOfNode(parents[rows[row]]);
+}
+
+int FlatTree::lastChildRow(size_t row) const {
+  return rowOfNode(lastChildren[rows[row]]);
+}
+
+std::string_view FlatTree::nodeLabel(size_t nodeIndex) const {
+  if (!provider) {
+    return labels[nodeIndex];
+  }
+  if ((flags[nodeIndex] & Loading) != 0) {
+    return provider->loadingLabel();
+  }
+  int parent = parents[nodeIndex];
+  WidgetIdentityId parentKey =
+      parent >= 0 ? keys[static_cast<size_t>(parent)] : InvalidWidgetIdentityId;
+  return provider->childLabel(parentKey, childIndices[nodeIndex]);
+}
+
+FlatTreeRow FlatTree::row(size_t row) const {
+  size_t nodeIndex = rows[row];
+  FlatTreeRow result;
+  result.label = nodeLabel(nodeIndex);
+  result.depth = depths[nodeIndex];
+  result.hasChildren = (flags[nodeIndex] & HasChildren) != 0;
+  result.expanded = (flags[nodeIndex] & Expanded) != 0;
+  result.selected = (flags[nodeIndex] & Selected) != 0;
+  return result;
+}
+
+void FlatTree::path(size_t row, std::vector<uint32_t>& out) const {
+  out.clear();
+  if (row >= rows.size()) {
+    return;
+  }
+  for (int current = static_cast<int>(rows[row]); current >= 0;
+       current = parents[static_cast<size_t>(current)]) {
+    out.push_back(childIndices[static_cast<size_t>(current)]);
+  }
+  std::reverse(out.begin(), out.end());
+}
+
+void flattenTree(std::vector<TreeNode> const& nodes, TreeViewState const* state, FlatTree& out) {
+  struct Level {
+    std::vector<TreeNode> const* nodes = nullptr;
+    size_t next = 0u;
+    int parent = -1;
+    bool visible = true;
+  };
+  out = FlatTree{};
+  std::vector<Level> stack;
+  stack.push_back(Level{&nodes, 0u, -1, true});
+  while (!stack.empty()) {
+    Level& level = stack.back();
+    if (level.next >= level.nodes->size()) {
+      if (level.parent >= 0) {
+        out.subtreeEnds[static_cast<size_t>(level.parent)] = static_cast<uint32_t>(out.nodeCount());
+      }
+      stack.pop_back();
+      continue;
+    }
+    size_t childIndex = level.next++;
+    int parent = level.parent;
+    bool visible = level.visible;
+    TreeNode const& node = (*level.nodes)[childIndex];
+    int index = static_cast<int>(out.nodeCount());
+    bool expanded = node.expanded;
+    if (state && node.key != InvalidWidgetIdentityId) {
+      auto it = state->expanded.find(node.key);
+      if (it != state->expanded.end()) {
+        expanded = it->second;
+      }
+    }
+    uint8_t flags = 0u;
+    if (!node.children.empty()) {
+      flags |= FlatTree::HasChildren;
+    }
+    if (expanded) {
+      flags |= FlatTree::Expanded;
+    }
+    if (node.selected) {
+      flags |= FlatTree::Selected;
+    }
+    out.labels.push_back(node.label);
+    out.keys.push_back(node.key);
+    out.parents.push_back(parent);
+    out.depths.push_back(static_cast<int>(stack.size()) - 1);
+    out.childIndices.push_back(static_cast<uint32_t>(childIndex));
+    out.lastChildren.push_back(-1);
+    out.subtreeEnds.push_back(static_cast<uint32_t>(index) + 1u);
+    out.flags.push_back(flags);
+    if (visible) {
+      out.rows.push_back(static_cast<uint32_t>(index));
+    }
+    if (parent >= 0) {
+      out.lastChildren[static_cast<size_t>(parent)] = index;
+    }
+    // With a state, collapsed branches are flattened too so they can be spliced in later.
+    if (!node.children.empty() && (expanded || state)) {
+      stack.push_back(Level{&node.children, 0u, index, visible && expanded});
+    }
+  }
+}
+
+void flattenTree(TreeDataProvider& provider, TreeViewState const& state, FlatTree& out) {
+  struct Level {
+    WidgetIdentityId key = InvalidWidgetIdentityId;
+    size_t count = 0u;
+    size_t next = 0u;
+    int parent = -1;
+  };
+  out = FlatTree{};
+  out.provider = &provider;
+  TreeDataProvider::PinScope pin(provider);
+  auto push_node = [&out](WidgetIdentityId key,
+                          int parent,
+                          int depth,
+                          uint32_t childIndex,
+                          uint8_t flags) {
+    int index = static_cast<int>(out.nodeCount());
+    out.keys.push_back(key);
+    out.parents.push_back(parent);
+    out.depths.push_back(depth);
+    out.childIndices.push_back(childIndex);
+    out.lastChildren.push_back(-1);
+    out.subtreeEnds.push_back(static_cast<uint32_t>(index) + 1u);
+    out.flags.push_back(flags);
+    out.rows.push_back(static_cast<uint32_t>(index));
+    if (parent >= 0) {
+      out.lastChildren[static_cast<size_t>(parent)] = index;
+    }
+    return index;
+  };
+
+  std::optional<size_t> rootCount = provider.childCount(InvalidWidgetIdentityId);
+  if (!rootCount.has_value()) {
+    push_node(InvalidWidgetIdentityId, -1, 0, 0u, FlatTree::Loading);
+    return;
+  }
+  std::vector<Level> stack;
+  stack.push_back(Level{InvalidWidgetIdentityId, rootCount.value(), 0u, -1});
+  while (!stack.empty()) {
+    Level& level = stack.back();
+    if (level.next >= level.count) {
+      if (level.parent >= 0) {
+        out.subtreeEnds[static_cast<size_t>(level.parent)] = static_cast<uint32_t>(out.nodeCount());
+      }
+      stack.pop_back();
+      continue;
+    }
+    size_t childIndex = level.next++;
+    WidgetIdentityId parentKey = level.key;
+    int parent = level.parent;
+    int depth = static_cast<int>(stack.size()) - 1;
+    WidgetIdentityId key = provider.childKey(parentKey, childIndex);
+    bool expanded = false;
+    uint8_t flags = 0u;
+    if (provider.childHasChildren(parentKey, childIndex)) {
+      flags |= FlatTree::HasChildren;
+      auto it = state.expanded.find(key);
+      expanded = it != state.expanded.end() && it->second;
+    }
+    // Only expanded branches are enumerated; a collapsed one costs a single row.
+    std::optional<size_t> count;
+    if (expanded) {
+      count = provider.childCount(key);
+      if (count.has_value() && count.value() == 0u) {
+        expanded = false;
+        flags = 0u;
+      }
+    }
+    if (expanded) {
+      flags |= FlatTree::Expanded;
+    }
+    int index = push_node(key, parent, depth, static_cast<uint32_t>(childIndex), flags);
+    if (!expanded) {
+      continue;
+    }
+    if (!count.has_value()) {
+      push_node(InvalidWidgetIdentityId, index, depth + 1, 0u, FlatTree::Loading);
+      out.subtreeEnds[static_cast<size_t>(index)] = static_cast<uint32_t>(out.nodeCount());
+      continue;
+    }
+    stack.push_back(Level{key, count.value(), 0u, index});
+  }
+}
+
+void collectTreeConnectorRects(FlatTree const& tree,
+                               size_t row,
+                               TreeRowGeometry const& geometry,
+                               std::vector<InternalRect>& out) {
+  if (row >= tree.size()) {
+    return;
+  }
+  int current = static_cast<int>(tree.node(row));
+  int parent = tree.parents[static_cast<size_t>(current)];
+  int depth = tree.depths[static_cast<size_t>(current)];
+  float halfThickness = geometry.connectorThickness * 0.5f;
+  float rowCenterY = geometry.rowHeight * 0.5f;
+  float rowTop = -geometry.rowGap * 0.5f;
+  float rowBottom = geometry.rowHeight + geometry.rowGap * 0.5f;
+
+  auto add_trunk_segment = [&](int ancestorIndex) {
+    size_t ancestor = static_cast<size_t>(ancestorIndex);
+    uint8_t trunkFlags = FlatTree::HasChildren | FlatTree::Expanded;
+    if ((tree.flags[ancestor] & trunkFlags) != trunkFlags) {
+      return;
+    }
+    int last = tree.lastChildren[ancestor];
+    if (last < 0) {
+      return;
+    }
+    if (current != ancestorIndex && current > last) {
+      return;
+    }
+    float trunkX = geometry.caretBaseX +
+                   static_cast<float>(tree.depths[ancestor]) * geometry.indent +
+                   geometry.caretSize * 0.5f;
+    float segmentTop = rowTop;
+    float segmentBottom = rowBottom;
+    if (current == ancestorIndex) {
+      segmentTop = rowCenterY;
+    }
+    if (current == last) {
+      segmentBottom = rowCenterY;
+    }
+    if (segmentBottom > segmentTop + 0.5f) {
+      out.push_back(InternalRect{trunkX - halfThickness,
+                                 segmentTop - halfThickness,
+                                 geometry.connectorThickness,
+                                 (segmentBottom - segmentTop) + geometry.connectorThickness});
+    }
+  };
+
+  // Ancestors are walked upwards; restore root-first order so segments paint as they always have.
+  size_t ancestorStart = out.size();
+  for (int ancestor = parent; ancestor >= 0;
+       ancestor = tree.parents[static_cast<size_t>(ancestor)]) {
+    add_trunk_segment(ancestor);
+  }
+  std::reverse(out.begin() + static_cast<std::ptrdiff_t>(ancestorStart), out.end());
+  add_trunk_segment(current);
+
+  if (parent >= 0) {
+    float trunkX = geometry.caretBaseX + static_cast<float>(depth - 1) * geometry.indent +
+                   geometry.caretSize * 0.5f;
+    float childTrunkX = geometry.caretBaseX + static_cast<float>(depth) * geometry.indent +
+                        geometry.caretSize * 0.5f;
+    float linkStartX = trunkX - halfThickness;
+    float linkEndX = childTrunkX + halfThickness;
+    float linkW = linkEndX - linkStartX;
+    if (linkW > 0.5f) {
+      out.push_back(InternalRect{linkStartX,
+                                 rowCenterY - halfThickness,
+                                 linkW,
+                                 geometry.connectorThickness});
+    }
+  }
+}
+
+TreeRowParts createTreeRowParts(PrimeFrame::Frame& frame,
+                                PrimeFrame::NodeId rowId,
+                                FlatTreeRow const& row,
+                                std::span<InternalRect const> connectors,
+                                PrimeFrame::RectStyleToken rowRole,
+                                TreeViewSpec const& spec,
+                                TreeRowGeometry const& geometry) {
+  TreeRowParts parts;
+  float indent = (row.depth > 0) ? geometry.indent * static_cast<float>(row.depth) : 0.0f;
+  float glyphX = geometry.caretBaseX + indent;
+  float glyphY = (geometry.rowHeight - geometry.caretSize) * 0.5f;
+
+  for (InternalRect const& connector : connectors) {
+    add_rect_primitive(frame, rowId, connector, spec.connectorStyle);
+  }
+
+  if (spec.showCaretMasks && row.depth > 0 && spec.visible) {
+    float maskPad = geometry.caretMaskPad;
+    parts.mask = add_rect_primitive(frame,
+                                    rowId,
+                                    InternalRect{glyphX - maskPad,
+                                                 glyphY - maskPad,
+                                                 geometry.caretSize + maskPad * 2.0f,
+                                                 geometry.caretSize + maskPad * 2.0f},
+                                    rowRole);
+    parts.hasMask = parts.mask != 0;
+  }
+
+  add_rect_primitive(frame,
+                     rowId,
+                     InternalRect{glyphX, glyphY, geometry.caretSize, geometry.caretSize},
+                     spec.caretBackgroundStyle);
+  if (row.hasChildren) {
+    add_rect_primitive(frame,
+                       rowId,
+                       InternalRect{glyphX + geometry.caretInset,
+                                    glyphY + geometry.caretSize * 0.5f -
+                                        geometry.caretThickness * 0.5f,
+                                    geometry.caretSize - geometry.caretInset * 2.0f,
+                                    geometry.caretThickness},
+                       spec.caretLineStyle);
+    if (!row.expanded) {
+      float lineX = glyphX + geometry.caretSize * 0.5f - geometry.caretThickness * 0.5f;
+      add_rect_primitive(frame,
+                         rowId,
+                         InternalRect{lineX,
+                                      glyphY + geometry.caretInset,
+                                      geometry.caretThickness,
+                                      geometry.caretSize - geometry.caretInset * 2.0f},
+                         spec.caretLineStyle);
+    }
+  } else {
+    float dot = std::max(2.0f, geometry.caretThickness);
+    add_rect_primitive(frame,
+                       rowId,
+                       InternalRect{glyphX + geometry.caretSize * 0.5f - dot * 0.5f,
+                                    glyphY + geometry.caretSize * 0.5f - dot * 0.5f,
+                                    dot,
+                                    dot},
+                       spec.caretLineStyle);
+  }
+
+  if (spec.selectionAccentWidth > 0.0f && spec.selectionAccentStyle != 0 && spec.visible) {
+    PrimeFrame::RectStyleOverride accentOverride;
+    if (!row.selected) {
+      accentOverride.opacity = 0.0f;
+    }
+    parts.accent =
+        add_rect_primitive(frame,
+                           rowId,
+                           InternalRect{0.0f, 0.0f, spec.selectionAccentWidth, geometry.rowHeight},
+                           spec.selectionAccentStyle,
+                           accentOverride);
+    parts.hasAccent = parts.accent != 0;
+  }
+
+  float textX = geometry.rowStartX + 20.0f + indent;
+  PrimeFrame::TextStyleToken textRole = row.selected ? spec.selectedTextStyle : spec.textStyle;
+  float lineHeight = row.selected ? geometry.selectedTextHeight : geometry.rowTextHeight;
+  float textY = (geometry.rowHeight - lineHeight) * 0.5f;
+  float labelWidth = std::max(0.0f, geometry.rowWidth - geometry.rowWidthInset - textX);
+  PrimeFrame::NodeId labelId = createTextNode(frame,
+                                              rowId,
+                                              InternalRect{textX, textY, labelWidth, lineHeight},
+                                              row.label,
+                                              textRole,
+                                              {},
+                                              PrimeFrame::TextAlign::Start,
+                                              PrimeFrame::WrapMode::None,
+                                              labelWidth,
+                                              spec.visible);
+  parts.label = first_primitive(frame, labelId);
+  return parts;
+}
+
+void releaseTreeRowSlot(PrimeFrame::Frame& frame, TreeRowSlot& slot) {
+  slot.rowIndex = -1;
+  hide_node(frame, slot.row);
+  LayoutRequestScope::request();
+}
+
+TreeRowSlot createTreeRowSlot(PrimeFrame::Frame& frame,
+                              UiNode& rowsNode,
+                              TreeViewSpec const& spec,
+                              TreeRowGeometry const& geometry) {
+  TreeRowSlot slot;
+  PanelSpec rowPanel;
+  rowPanel.rectStyle = spec.rowStyle;
+  rowPanel.layout = PrimeFrame::LayoutType::Overlay;
+  rowPanel.size.preferredHeight = geometry.rowHeight;
+  rowPanel.size.preferredWidth = geometry.rowWidth;
+  rowPanel.size.stretchX = 1.0f;
+  rowPanel.clipChildren = false;
+  rowPanel.visible = spec.visible;
+  slot.row = rowsNode.createPanel(rowPanel).setHitTestVisible(false).nodeId();
+  slot.background = first_primitive(frame, slot.row);
+  slot.connectorStyle = spec.connectorStyle;
+
+  // Added in the same paint order as eagerly built rows; connectors are inserted ahead of these
+  // when a row needs them.
+  PrimeFrame::RectStyleOverride hidden;
+  hidden.opacity = 0.0f;
+  if (spec.showCaretMasks && spec.visible) {
+    slot.mask = add_rect_primitive(frame, slot.row, InternalRect{}, spec.rowStyle, hidden);
+  }
+  slot.caretBackground =
+      add_rect_primitive(frame, slot.row, InternalRect{}, spec.caretBackgroundStyle, hidden);
+  slot.caretHorizontal =
+      add_rect_primitive(frame, slot.row, InternalRect{}, spec.caretLineStyle, hidden);
+  slot.caretVertical =
+      add_rect_primitive(frame, slot.row, InternalRect{}, spec.caretLineStyle, hidden);
+  slot.leafDot = add_rect_primitive(frame, slot.row, InternalRect{}, spec.caretLineStyle, hidden);
+  if (spec.selectionAccentWidth > 0.0f && spec.selectionAccentStyle != 0 && spec.visible) {
+    InternalRect accentRect{0.0f, 0.0f, spec.selectionAccentWidth, geometry.rowHeight};
+    slot.accent =
+        add_rect_primitive(frame, slot.row, accentRect, spec.selectionAccentStyle, hidden);
+  }
+  slot.label = createTextNode(frame,
+                              slot.row,
+                              InternalRect{},
+                              {},
+                              spec.textStyle,
+                              {},
+                              PrimeFrame::TextAlign::Start,
+                              PrimeFrame::WrapMode::None,
+                              0.0f,
+                              false);
+  slot.labelPrim = first_primitive(frame, slot.label);
+  return slot;
+}
+
+void bindTreeRowSlot(PrimeFrame::Frame& frame,
+                     TreeRowSlot& slot,
+                     int rowIndex,
+                     FlatTreeRow const& row,
+                     std::span<InternalRect const> connectors,
+                     TreeRowGeometry const& geometry,
+                     bool visible) {
+  slot.rowIndex = rowIndex;
+  float rowPitch = std::max(1.0f, geometry.rowHeight + geometry.rowGap);
+  if (PrimeFrame::Node* rowNode = frame.getNode(slot.row)) {
+    rowNode->localY = rowPitch * static_cast<float>(rowIndex);
+    rowNode->visible = visible;
+  }
+  LayoutRequestScope::request();
+
+  // Connector primitives paint after the background and ahead of the caret parts.
+  while (slot.connectors.size() < connectors.size()) {
+    PrimeFrame::Primitive prim;
+    prim.type = PrimeFrame::PrimitiveType::Rect;
+    prim.rect.token = slot.connectorStyle;
+    PrimeFrame::PrimitiveId pid = frame.addPrimitive(prim);
+    PrimeFrame::Node* rowNode = frame.getNode(slot.row);
+    if (!rowNode) {
+      break;
+    }
+    PrimeFrame::PrimitiveId firstPart = slot.mask != 0 ? slot.mask : slot.caretBackground;
+    auto anchor = std::find(rowNode->primitives.begin(), rowNode->primitives.end(), firstPart);
+    rowNode->primitives.insert(anchor, pid);
+    slot.connectors.push_back(pid);
+  }
+  for (size_t i = 0; i < slot.connectors.size(); ++i) {
+    if (i < connectors.size()) {
+      place_primitive(frame, slot.connectors[i], connectors[i], true);
+    } else {
+      hide_primitive(frame, slot.connectors[i]);
+    }
+  }
+
+  float indent = (row.depth > 0) ? geometry.indent * static_cast<float>(row.depth) : 0.0f;
+  float glyphX = geometry.caretBaseX + indent;
+  float glyphY = (geometry.rowHeight - geometry.caretSize) * 0.5f;
+  if (slot.mask != 0) {
+    float maskPad = geometry.caretMaskPad;
+    place_primitive(frame,
+                    slot.mask,
+                    InternalRect{glyphX - maskPad,
+                                 glyphY - maskPad,
+                                 geometry.caretSize + maskPad * 2.0f,
+                                 geometry.caretSize + maskPad * 2.0f},
+                    row.depth > 0);
+  }
+
+  place_primitive(frame,
+                  slot.caretBackground,
+                  InternalRect{glyphX, glyphY, geometry.caretSize, geometry.caretSize},
+                  true);
+  if (row.hasChildren) {
+    place_primitive(frame,
+                    slot.caretHorizontal,
+                    InternalRect{glyphX + geometry.caretInset,
+                                 glyphY + geometry.caretSize * 0.5f -
+                                     geometry.caretThickness * 0.5f,
+                                 geometry.caretSize - geometry.caretInset * 2.0f,
+                                 geometry.caretThickness},
+                    true);
+    place_primitive(frame,
+                    slot.caretVertical,
+                    InternalRect{glyphX + geometry.caretSize * 0.5f -
+                                     geometry.caretThickness * 0.5f,
+                                 glyphY + geometry.caretInset,
+                                 geometry.caretThickness,
+                                 geometry.caretSize - geometry.caretInset * 2.0f},
+                    !row.expanded);
+    hide_primitive(frame, slot.leafDot);
+  } else {
+    float dot = std::max(2.0f, geometry.caretThickness);
+    place_primitive(frame,
+                    slot.leafDot,
+                    InternalRect{glyphX + geometry.caretSize * 0.5f - dot * 0.5f,
+                                 glyphY + geometry.caretSize * 0.5f - dot * 0.5f,
+                                 dot,
+                                 dot},
+                    true);
+    hide_primitive(frame, slot.caretHorizontal);
+    hide_primitive(frame, slot.caretVertical);
+  }
+
+  float textX = geometry.rowStartX + 20.0f + indent;
+  float lineHeight = row.selected ? geometry.selectedTextHeight : geometry.rowTextHeight;
+  float textY = (geometry.rowHeight - lineHeight) * 0.5f;
+  float labelWidth = std::max(0.0f, geometry.rowWidth - geometry.rowWidthInset - textX);
+  place_node(frame, slot.label, InternalRect{textX, textY, labelWidth, lineHeight}, visible);
+  if (PrimeFrame::Primitive* prim = frame.getPrimitive(slot.labelPrim)) {
+    if (prim->type == PrimeFrame::PrimitiveType::Text) {
+      prim->width = labelWidth;
+      prim->height = lineHeight;
+      prim->textBlock.text.assign(row.label);
+      prim->textBlock.maxWidth = labelWidth;
+    }
+  }
+}
+
+} // namespace PrimeStage::Internal
@@ -31,8 +31,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <mutex>
 #include <span>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace PrimeStage {
@@ -63,6 +66,59 @@ std::string_view renderStatusMessage(RenderStatusCode code) {
   return "Unknown render status";
 }
 
+namespace {
+
+RenderStatus make_status(RenderStatusCode code,
+                         RenderTarget const* target = nullptr,
+                         uint32_t requiredStride = 0,
+                         std::string_view detail = {}) {
+  RenderStatus status;
+  status.code = code;
+  status.requiredStride = requiredStride;
+  status.detail = detail;
+  if (target != nullptr) {
+    status.targetWidth = target->width;
+    status.targetHeight = target->height;
+    status.targetStride = target->stride;
+  }
+  return status;
+}
+
+RenderStatus make_success(RenderTarget const* target = nullptr) {
+  return make_status(RenderStatusCode::Success, target);
+}
+
+uint64_t required_buffer_bytes(RenderTarget const& target) {
+  return static_cast<uint64_t>(target.stride) * static_cast<uint64_t>(target.height);
+}
+
+RenderStatus validate_target(RenderTarget const& target) {
+  if (target.width == 0 || target.height == 0) {
+    return make_status(RenderStatusCode::InvalidTargetDimensions,
+                       &target,
+                       target.width * 4u,
+                       "target width/height must be greater than zero");
+  }
+  uint32_t requiredStride = target.width * 4u;
+  if (target.stride < requiredStride) {
+    return make_status(RenderStatusCode::InvalidTargetStride,
+                       &target,
+                       requiredStride,
+                       "target stride must be at least width * 4 bytes");
+  }
+  uint64_t requiredBytes = required_buffer_bytes(target);
+  if (target.pixels.empty() ||
+      static_cast<uint64_t>(target.pixels.size()) < requiredBytes) {
+    return make_status(RenderStatusCode::InvalidTargetBuffer,
+                       &target,
+                       requiredStride,
+                       "target pixel span is smaller than required stride * height bytes");
+  }
+  return make_success(&target);
+}
+
+} // namespace
+
 #if defined(PRIMESTAGE_HAS_PRIMEMANIFEST)
 namespace {
 
@@ -137,15 +193,16 @@ void add_rect_raw(PrimeManifest::RenderBatch& batch,
   batch.commands.push_back(PrimeManifest::RenderCommand{PrimeManifest::CommandType::Rect, idx});
 }
 
-void add_rect(PrimeManifest::RenderBatch& batch, PrimeFrame::DrawCommand const& cmd, float radiusPx) {
+void add_rect(PrimeManifest::RenderBatch& batch,
+              PrimeFrame::DrawCommand const& cmd,
+              float radiusPx,
+              uint8_t colorIndex) {
   uint32_t idx = static_cast<uint32_t>(batch.rects.x0.size());
   batch.rects.x0.push_back(cmd.x0);
   batch.rects.y0.push_back(cmd.y0);
   batch.rects.x1.push_back(cmd.x1);
   batch.rects.y1.push_back(cmd.y1);
 
-  uint32_t color = pack_color(cmd.rectStyle.fill, cmd.rectStyle.opacity);
-  uint8_t colorIndex = palette_index(batch, color);
   batch.rects.colorIndex.push_back(colorIndex);
   float clamped = std::clamp(radiusPx, 0.0f, 255.0f);
   uint16_t radiusQ8_8 = static_cast<uint16_t>(std::lround(clamped * 256.0f));
@@ -230,6 +287,19 @@ void add_bitmap_text(PrimeManifest::RenderBatch& batch,
   }
 }
 
+bool same_rect_fill(PrimeFrame::DrawCommand const& lhs, PrimeFrame::DrawCommand const& rhs) {
+  PrimeFrame::Color const& a = lhs.rectStyle.fill;
+  PrimeFrame::Color const& b = rhs.rectStyle.fill;
+  return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a &&
+         lhs.rectStyle.opacity == rhs.rectStyle.opacity;
+}
+
+bool same_text_style(PrimeFrame::ResolvedTextStyle const& lhs, PrimeFrame::ResolvedTextStyle const& rhs) {
+  return lhs.size == rhs.size && lhs.weight == rhs.weight && lhs.lineHeight == rhs.lineHeight &&
+         lhs.color.r == rhs.color.r && lhs.color.g == rhs.color.g && lhs.color.b == rhs.color.b &&
+         lhs.color.a == rhs.color.a;
+}
+
 PrimeManifest::Typography make_typography(PrimeFrame::ResolvedTextStyle const& style) {
   PrimeManifest::Typography type;
   type.size = style.size;
@@ -255,30 +325,6 @@ bool write_png(std::string_view path, PrimeManifest::RenderTarget const& target)
                         static_cast<int>(target.width * 4)) != 0;
 }
 
-RenderStatus make_status(RenderStatusCode code,
-                         RenderTarget const* target = nullptr,
-                         uint32_t requiredStride = 0,
-                         std::string_view detail = {}) {
-  RenderStatus status;
-  status.code = code;
-  status.requiredStride = requiredStride;
-  status.detail = detail;
-  if (target != nullptr) {
-    status.targetWidth = target->width;
-    status.targetHeight = target->height;
-    status.targetStride = target->stride;
-  }
-  return status;
-}
-
-RenderStatus make_success(RenderTarget const* target = nullptr) {
-  return make_status(RenderStatusCode::Success, target);
-}
-
-uint64_t required_buffer_bytes(RenderTarget const& target) {
-  return static_cast<uint64_t>(target.stride) * static_cast<uint64_t>(target.height);
-}
-
 float resolve_corner_radius(float logicalWidth,
                             float logicalHeight,
                             RenderOptions const& options) {
@@ -302,17 +348,17 @@ float resolve_corner_radius(float logicalWidth,
 }
 
 void ensure_fonts_loaded() {
-  static bool loaded = false;
-  if (loaded) {
-    return;
-  }
-  auto& registry = PrimeManifest::GetFontRegistry();
+  // Function-local static init is thread-safe, so the UI thread and the render pipeline may race
+  // to the first render without loading fonts twice.
+  [[maybe_unused]] static bool const loaded = []() {
+    auto& registry = PrimeManifest::GetFontRegistry();
 #if defined(PRIMESTAGE_HAS_BUNDLED_FONT) && PRIMESTAGE_HAS_BUNDLED_FONT
-  registry.addBundleDir(PRIMESTAGE_BUNDLED_FONT_DIR);
+    registry.addBundleDir(PRIMESTAGE_BUNDLED_FONT_DIR);
 #endif
-  registry.loadBundledFonts();
-  registry.loadOsFallbackFonts();
-  loaded = true;
+    registry.loadBundledFonts();
+    registry.loadOsFallbackFonts();
+    return true;
+  }();
 }
 
 RenderStatus compute_target_size(PrimeFrame::Frame const& frame,
@@ -352,41 +398,11 @@ RenderStatus compute_target_size(PrimeFrame::Frame const& frame,
   return status;
 }
 
-} // namespace
-
-RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
-                                 PrimeFrame::LayoutOutput const& layout,
-                                 RenderTarget const& target,
-                                 RenderOptions const& options) {
-  if (target.width == 0 || target.height == 0) {
-    return make_status(RenderStatusCode::InvalidTargetDimensions,
-                       &target,
-                       target.width * 4u,
-                       "target width/height must be greater than zero");
-  }
-  uint32_t requiredStride = target.width * 4u;
-  if (target.stride < requiredStride) {
-    return make_status(RenderStatusCode::InvalidTargetStride,
-                       &target,
-                       requiredStride,
-                       "target stride must be at least width * 4 bytes");
-  }
-  uint64_t requiredBytes = required_buffer_bytes(target);
-  if (target.pixels.empty() ||
-      static_cast<uint64_t>(target.pixels.size()) < requiredBytes) {
-    return make_status(RenderStatusCode::InvalidTargetBuffer,
-                       &target,
-                       requiredStride,
-                       "target pixel span is smaller than required stride * height bytes");
-  }
-
-  ensure_fonts_loaded();
-
+RenderStatus rasterize_batch(PrimeFrame::RenderBatch const& pfBatch,
+                             RenderTarget const& target,
+                             RenderOptions const& options) {
   float scale = target.scale > 0.0f ? target.scale : 1.0f;
 
-  PrimeFrame::RenderBatch pfBatch;
-  PrimeFrame::flattenToRenderBatch(frame, layout, pfBatch);
-
   PrimeManifest::RenderBatch batch;
   batch.assumeFrontToBack = false;
   if (options.clear) {
@@ -395,9 +411,16 @@ RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
     add_clear(batch, PrimeManifest::PackRGBA8(clear));
   }
 
+  // Same for rect fills: pack and look up the palette slot only when the fill changes.
+  PrimeFrame::DrawCommand const* lastRect = nullptr;
+  uint8_t rectColorIndex = 0u;
   for (PrimeFrame::DrawCommand const& cmd : pfBatch.commands) {
     if (cmd.type == PrimeFrame::CommandType::Rect ||
         cmd.type == PrimeFrame::CommandType::ImagePlaceholder) {
+      if (!lastRect || !same_rect_fill(*lastRect, cmd)) {
+        rectColorIndex = palette_index(batch, pack_color(cmd.rectStyle.fill, cmd.rectStyle.opacity));
+        lastRect = &cmd;
+      }
       float logicalW = static_cast<float>(cmd.x1 - cmd.x0);
       float logicalH = static_cast<float>(cmd.y1 - cmd.y0);
       float radius = resolve_corner_radius(logicalW, logicalH, options);
@@ -412,19 +435,26 @@ RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
         scaled.clip.x1 = static_cast<int>(std::lround(static_cast<float>(cmd.clip.x1) * scale));
         scaled.clip.y1 = static_cast<int>(std::lround(static_cast<float>(cmd.clip.y1) * scale));
       }
-      add_rect(batch, scaled, radius * scale);
+      add_rect(batch, scaled, radius * scale, rectColorIndex);
     }
   }
 
+  // Text commands mostly repeat a handful of styles; typography and the palette slot are only
+  // recomputed when the style changes from the previous text command.
+  PrimeFrame::ResolvedTextStyle const* lastStyle = nullptr;
+  PrimeManifest::Typography type{};
+  uint8_t colorIndex = 0u;
   for (PrimeFrame::DrawCommand const& cmd : pfBatch.commands) {
     if (cmd.type != PrimeFrame::CommandType::Text) {
       continue;
     }
-    PrimeManifest::Typography type = make_typography(cmd.textStyle);
-    type.size *= scale;
-    type.lineHeight *= scale;
-    uint32_t packed = pack_color(cmd.textStyle.color, 1.0f);
-    uint8_t colorIndex = palette_index(batch, packed);
+    if (!lastStyle || !same_text_style(*lastStyle, cmd.textStyle)) {
+      type = make_typography(cmd.textStyle);
+      type.size *= scale;
+      type.lineHeight *= scale;
+      colorIndex = palette_index(batch, pack_color(cmd.textStyle.color, 1.0f));
+      lastStyle = &cmd.textStyle;
+    }
     ClipRect clip;
     if (cmd.clipEnabled) {
       clip.x0 = static_cast<int32_t>(std::lround(static_cast<float>(cmd.clip.x0) * scale));
@@ -464,6 +494,35 @@ RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
   return make_success(&target);
 }
 
+} // namespace
+
+RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
+                                 PrimeFrame::LayoutOutput const& layout,
+                                 RenderTarget const& target,
+                                 RenderOptions const& options,
+                                 std::span<PrimeFrame::DrawCommand const> overlay) {
+  RenderStatus status = validate_target(target);
+  if (!status.ok()) {
+    return status;
+  }
+
+  ensure_fonts_loaded();
+
+  PrimeFrame::RenderBatch pfBatch;
+  PrimeFrame::flattenToRenderBatch(frame, layout, pfBatch);
+  pfBatch.commands.insert(pfBatch.commands.end(), overlay.begin(), overlay.end());
+  return rasterize_batch(pfBatch, target, options);
+}
+
+RenderStatus renderSnapshotToTarget(RenderSnapshot const& snapshot, RenderTarget const& target) {
+  RenderStatus status = validate_target(target);
+  if (!status.ok()) {
+    return status;
+  }
+  ensure_fonts_loaded();
+  return rasterize_batch(snapshot.batch, target, snapshot.options);
+}
+
 RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
                                  RenderTarget const& target,
                                  RenderOptions const& options) {
@@ -482,7 +541,8 @@ RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
 RenderStatus renderFrameToPng(PrimeFrame::Frame& frame,
                               PrimeFrame::LayoutOutput const& layout,
                               std::string_view path,
-                              RenderOptions const& options) {
+                              RenderOptions const& options,
+                              std::span<PrimeFrame::DrawCommand const> overlay) {
   if (path.empty()) {
     return make_status(RenderStatusCode::PngPathEmpty, nullptr, 0, "path must not be empty");
   }
@@ -500,7 +560,7 @@ RenderStatus renderFrameToPng(PrimeFrame::Frame& frame,
   target.stride = widthPx * 4;
   target.scale = 1.0f;
 
-  RenderStatus renderStatus = renderFrameToTarget(frame, layout, target, options);
+  RenderStatus renderStatus = renderFrameToTarget(frame, layout, target, options, overlay);
   if (!renderStatus.ok()) {
     return renderStatus;
   }
@@ -528,7 +588,8 @@ RenderStatus renderFrameToPng(PrimeFrame::Frame& frame,
 RenderStatus renderFrameToTarget(PrimeFrame::Frame&,
                                  PrimeFrame::LayoutOutput const&,
                                  RenderTarget const& target,
-                                 RenderOptions const&) {
+                                 RenderOptions const&,
+                                 std::span<PrimeFrame::DrawCommand const>) {
   RenderStatus status;
   status.code = RenderStatusCode::BackendUnavailable;
   status.targetWidth = target.width;
@@ -545,10 +606,22 @@ RenderStatus renderFrameToTarget(PrimeFrame::Frame& frame,
   return renderFrameToTarget(frame, PrimeFrame::LayoutOutput{}, target, options);
 }
 
+RenderStatus renderSnapshotToTarget(RenderSnapshot const&, RenderTarget const& target) {
+  RenderStatus status;
+  status.code = RenderStatusCode::BackendUnavailable;
+  status.targetWidth = target.width;
+  status.targetHeight = target.height;
+  status.targetStride = target.stride;
+  status.requiredStride = target.width * 4u;
+  status.detail = "build configured with PRIMESTAGE_ENABLE_PRIMEMANIFEST=OFF";
+  return status;
+}
+
 RenderStatus renderFrameToPng(PrimeFrame::Frame&,
                               PrimeFrame::LayoutOutput const&,
                               std::string_view,
-                              RenderOptions const&) {
+                              RenderOptions const&,
+                              std::span<PrimeFrame::DrawCommand const>) {
   RenderStatus status;
   status.code = RenderStatusCode::BackendUnavailable;
   status.detail = "build configured with PRIMESTAGE_ENABLE_PRIMEMANIFEST=OFF";
@@ -563,4 +636,116 @@ RenderStatus renderFrameToPng(PrimeFrame::Frame& frame,
 
 #endif
 
+void captureRenderSnapshot(PrimeFrame::Frame const& frame,
+                           PrimeFrame::LayoutOutput const& layout,
+                           RenderOptions const& options,
+                           RenderSnapshot& out) {
+  out.options = options;
+  out.batch.commands.clear();
+  out.textStorage.clear();
+  PrimeFrame::flattenToRenderBatch(frame, layout, out.batch);
+  // Sized up front so copying never reallocates under views that are already rebound.
+  size_t textBytes = 0u;
+  for (PrimeFrame::DrawCommand const& cmd : out.batch.commands) {
+    if (cmd.type == PrimeFrame::CommandType::Text) {
+      textBytes += cmd.text.size();
+    }
+  }
+  out.textStorage.resize(textBytes);
+  size_t offset = 0u;
+  for (PrimeFrame::DrawCommand& cmd : out.batch.commands) {
+    if (cmd.type != PrimeFrame::CommandType::Text) {
+      continue;
+    }
+    char* text = out.textStorage.data() + offset;
+    std::copy(cmd.text.begin(), cmd.text.end(), text);
+    cmd.text = std::string_view(text, cmd.text.size());
+    offset += cmd.text.size();
+  }
+}
+
+RenderPipeline::RenderPipeline(size_t maxQueued)
+    : maxQueued_(std::clamp<size_t>(maxQueued, 1u, 2u)) {
+  worker_ = std::thread([this]() { run(); });
+}
+
+RenderPipeline::~RenderPipeline() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  workAvailable_.notify_all();
+  queueChanged_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+RenderSnapshot RenderPipeline::acquireSnapshot() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (recycled_.empty()) {
+    return RenderSnapshot{};
+  }
+  RenderSnapshot snapshot = std::move(recycled_.back());
+  recycled_.pop_back();
+  return snapshot;
+}
+
+RenderStatus RenderPipeline::submit(RenderSnapshot snapshot,
+                                    RenderTarget const& target,
+                                    Completion onComplete) {
+  RenderStatus status = validate_target(target);
+  if (!status.ok()) {
+    return status;
+  }
+  std::unique_lock<std::mutex> lock(mutex_);
+  queueChanged_.wait(lock, [this]() { return stopping_ || queue_.size() < maxQueued_; });
+  if (stopping_) {
+    return make_status(RenderStatusCode::BackendUnavailable, &target, 0u, "render pipeline stopped");
+  }
+  queue_.push_back(Job{std::move(snapshot), target, std::move(onComplete)});
+  lock.unlock();
+  workAvailable_.notify_one();
+  return status;
+}
+
+void RenderPipeline::waitIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  queueChanged_.wait(lock, [this]() { return queue_.empty() && !rendering_; });
+}
+
+size_t RenderPipeline::pending() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queue_.size() + (rendering_ ? 1u : 0u);
+}
+
+void RenderPipeline::run() {
+  for (;;) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    workAvailable_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+    // Drain queued frames before stopping so completions always fire for submitted work.
+    if (queue_.empty()) {
+      return;
+    }
+    Job job = std::move(queue_.front());
+    queue_.pop_front();
+    rendering_ = true;
+    lock.unlock();
+    queueChanged_.notify_all();
+
+    RenderStatus status = renderSnapshotToTarget(job.snapshot, job.target);
+    if (job.onComplete) {
+      job.onComplete(status);
+    }
+
+    lock.lock();
+    rendering_ = false;
+    if (recycled_.size() <= maxQueued_) {
+      recycled_.push_back(std::move(job.snapshot));
+    }
+    lock.unlock();
+    queueChanged_.notify_all();
+  }
+}
+
 } // namespace PrimeStage
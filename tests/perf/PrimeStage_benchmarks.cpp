@@ -1,3 +1,4 @@
+#include "PrimeStage/App.h"
 #include "PrimeStage/Render.h"
 #include "PrimeStage/Ui.h"
 
@@ -7,6 +8,7 @@
 #include "PrimeFrame/Layout.h"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <cstdint>
@@ -15,6 +17,7 @@
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <sstream>
 #include <span>
@@ -46,6 +49,26 @@ constexpr PrimeFrame::RectStyleToken StyleFocus = 4u;
 
 constexpr int KeyBackspace = 0x2A;
 
+constexpr size_t ShortcutBindingCount = 5000u;
+constexpr size_t ShortcutKeysPerModifier = 1250u;
+constexpr uint32_t ShortcutKeyBase = 0x100u;
+constexpr size_t ShortcutDispatchesPerSample = 64u;
+
+constexpr float TableRootWidth = 900.0f;
+constexpr float TableRootHeight = 640.0f;
+constexpr float TableWheelStep = 4000.0f;
+constexpr size_t WideTableRowCount = 200u;
+constexpr size_t WideTableColumnCount = 20u;
+
+constexpr int StartupSectionCount = 8;
+constexpr std::chrono::microseconds StartupFrameBudget{4000};
+constexpr size_t StartupMaxFrames = 256u;
+
+constexpr size_t ParallelSectionCount = 8u;
+constexpr size_t ParallelPrepareRows = 4000u;
+constexpr size_t ParallelBuildLabels = 200u;
+constexpr size_t ParallelBuildThreads = 3u;
+
 volatile uint64_t PerfSink = 0u;
 
 struct BenchmarkOptions {
@@ -136,6 +159,16 @@ std::vector<std::vector<std::string_view>> const& benchmarkTableRows() {
   return rows;
 }
 
+std::vector<std::vector<std::string_view>> makeBenchmarkTableRows(size_t count) {
+  std::vector<std::vector<std::string_view>> const& pattern = benchmarkTableRows();
+  std::vector<std::vector<std::string_view>> value;
+  value.reserve(count);
+  for (size_t index = 0u; index < count; ++index) {
+    value.push_back(pattern[index % pattern.size()]);
+  }
+  return value;
+}
+
 std::vector<PrimeStage::TreeNode> makeBenchmarkTreeNodes(int sections,
                                                           int itemsPerSection,
                                                           int leavesPerItem) {
@@ -626,6 +659,13 @@ struct DashboardRuntime {
                      {"Name", 220.0f, 0u, 0u},
                      {"Priority", 120.0f, 0u, 0u},
                      {"Area", 140.0f, 0u, 0u}};
+    if (autoWidth) {
+      for (PrimeStage::TableColumn& column : table.columns) {
+        column.width = 0.0f;
+      }
+      table.widthCache = &widthCache;
+      table.modelRevision = 1u;
+    }
     table.rows = benchmarkTableRows();
     table.selectedRow = 8;
     page.createTable(table);
@@ -828,6 +868,333 @@ struct TreeRuntime {
     PerfSink += static_cast<uint64_t>(std::max(lastScroll.offset, 0.0f));
     return true;
   }
+
+  // Presses alternate between two adjacent rows, so every press moves the selection.
+  bool runRowClickInteraction() {
+    PrimeFrame::LayoutOut const* out = layout.get(tableNode);
+    if (!out) {
+      return false;
+    }
+    float x = out->absX + out->absW * 0.5f;
+    float y = out->absY + out->absH * 0.5f + (clickLowerRow ? table.rowHeight : 0.0f);
+    clickLowerRow = !clickLowerRow;
+    int previous = selectedRow;
+    router.dispatch(makePointerEvent(PrimeFrame::EventType::PointerDown, 1, x, y),
+                    frame,
+                    layout,
+                    &focus);
+    router.dispatch(makePointerEvent(PrimeFrame::EventType::PointerUp, 1, x, y),
+                    frame,
+                    layout,
+                    &focus);
+    PerfSink += static_cast<uint64_t>(std::max(selectedRow, 0));
+    return selectedRow >= 0 && selectedRow != previous;
+  }
+};
+
+// A virtualized table over a large row set, either copied from `rows` or read through a data
+// source. The spec is built once, so samples time the table build and its scroll window rather
+// than copying the rows into a fresh spec. Auto-sized columns infer the table width from a width
+// cache that the unchanged model revision keeps valid across rebuilds.
+struct TableRuntime {
+  PrimeFrame::Frame frame;
+  PrimeFrame::LayoutOutput layout;
+  PrimeFrame::EventRouter router;
+  PrimeFrame::FocusManager focus;
+
+  PrimeStage::TableSpec table;
+  PrimeStage::TableColumnWidthCache widthCache;
+  PrimeFrame::NodeId tableNode{};
+  PrimeStage::TableScrollInfo lastScroll{};
+  float wheelDirection = 1.0f;
+  int selectedRow = -1;
+  bool clickLowerRow = false;
+
+  void initialize(size_t rowCount, bool readThroughSource, bool autoWidth) {
+    if (!autoWidth) {
+      table.size.preferredWidth = TableRootWidth - 32.0f;
+    }
+    table.size.preferredHeight = TableRootHeight - 32.0f;
+    table.headerStyle = StyleBackground;
+    table.rowStyle = StyleSurface;
+    table.rowAltStyle = StyleBackground;
+    table.selectionStyle = StyleAccent;
+    table.dividerStyle = StyleBackground;
+    table.focusStyle = StyleFocus;
+    table.columns = {{"State", 120.0f, 0u, 0u},
+                     {"Name", 220.0f, 0u, 0u},
+                     {"Priority", 120.0f, 0u, 0u},
+                     {"Area", 140.0f, 0u, 0u}};
+    if (readThroughSource) {
+      table.dataSource.rowCount = [rowCount]() { return rowCount; };
+      table.dataSource.cell = [](size_t row, size_t column) {
+        std::vector<std::vector<std::string_view>> const& pattern = benchmarkTableRows();
+        return pattern[row % pattern.size()][column];
+      };
+    } else {
+      table.rows = makeBenchmarkTableRows(rowCount);
+    }
+    table.selectedRow = 8;
+    table.virtualized = true;
+    table.callbacks.onScrollChanged = [this](PrimeStage::TableScrollInfo const& info) {
+      lastScroll = info;
+    };
+  }
+
+  // An eagerly built table of `columnCount` narrow columns, repeating the benchmark row pattern
+  // across them.
+  void initializeWide(size_t rowCount, size_t columnCount) {
+    table.size.preferredWidth = TableRootWidth - 32.0f;
+    table.size.preferredHeight = TableRootHeight - 32.0f;
+    table.headerStyle = StyleBackground;
+    table.rowStyle = StyleSurface;
+    table.rowAltStyle = StyleBackground;
+    table.selectionStyle = StyleAccent;
+    table.dividerStyle = StyleBackground;
+    table.focusStyle = StyleFocus;
+    std::vector<std::vector<std::string_view>> const& pattern = benchmarkTableRows();
+    table.columns.clear();
+    for (size_t column = 0u; column < columnCount; ++column) {
+      table.columns.push_back({pattern.front()[column % pattern.front().size()], 40.0f, 0u, 0u});
+    }
+    table.rows.clear();
+    table.rows.reserve(rowCount);
+    for (size_t row = 0u; row < rowCount; ++row) {
+      std::vector<std::string_view> const& source = pattern[row % pattern.size()];
+      std::vector<std::string_view>& cells = table.rows.emplace_back();
+      cells.reserve(columnCount);
+      for (size_t column = 0u; column < columnCount; ++column) {
+        cells.push_back(source[column % source.size()]);
+      }
+    }
+    table.selectedRow = 8;
+    table.callbacks.onSelect = [this](PrimeStage::TableRowInfo const& info) {
+      selectedRow = info.rowIndex;
+    };
+  }
+
+  void buildFrame() {
+    frame = PrimeFrame::Frame();
+    configureTheme(frame);
+    PrimeStage::UiNode root = createRoot(frame, TableRootWidth, TableRootHeight);
+    PrimeStage::StackSpec shell;
+    shell.size.stretchX = 1.0f;
+    shell.size.stretchY = 1.0f;
+    shell.padding.left = 16.0f;
+    shell.padding.top = 16.0f;
+    PrimeStage::UiNode page = root.createVerticalStack(shell);
+    tableNode = page.createTable(table).nodeId();
+  }
+
+  void runLayoutPass() {
+    layout = layoutFrame(frame, TableRootWidth, TableRootHeight);
+  }
+
+  void rebuild() {
+    buildFrame();
+    runLayoutPass();
+    focus.updateAfterRebuild(frame, layout);
+  }
+
+  // Each wheel step scrolls past the whole row pool, so every slot is rebound.
+  bool runWheelInteraction() {
+    PrimeFrame::LayoutOut const* out = layout.get(tableNode);
+    if (!out) {
+      return false;
+    }
+    float x = out->absX + out->absW * 0.5f;
+    float y = out->absY + out->absH * 0.5f;
+    router.dispatch(makePointerScrollEvent(x, y, TableWheelStep * wheelDirection),
+                    frame,
+                    layout,
+                    &focus);
+    if (lastScroll.offset >= lastScroll.maxOffset || lastScroll.offset <= 0.0f) {
+      wheelDirection = -wheelDirection;
+    }
+    PerfSink += static_cast<uint64_t>(std::max(lastScroll.offset, 0.0f));
+    return true;
+  }
+};
+
+struct ShortcutRuntime {
+  PrimeStage::App app;
+  std::vector<PrimeHost::KeyEvent> keys;
+  PrimeHost::EventBatch batch{};
+  size_t cursor = 0u;
+  uint64_t invocations = 0u;
+
+  bool initialize(size_t bindingCount) {
+    keys.clear();
+    keys.reserve(bindingCount);
+    for (size_t index = 0u; index < bindingCount; ++index) {
+      std::string actionId = "bench.action." + std::to_string(index);
+      if (!app.registerAction(actionId, [this](PrimeStage::AppActionInvocation const&) {
+            invocations += 1u;
+          })) {
+        return false;
+      }
+
+      PrimeStage::AppShortcut shortcut;
+      shortcut.key = static_cast<PrimeStage::HostKey>(
+          ShortcutKeyBase + static_cast<uint32_t>(index % ShortcutKeysPerModifier));
+      shortcut.modifiers =
+          static_cast<PrimeHost::KeyModifierMask>(index / ShortcutKeysPerModifier);
+      if (!app.bindShortcut(shortcut, actionId)) {
+        return false;
+      }
+
+      PrimeHost::KeyEvent key;
+      key.pressed = true;
+      key.keyCode = PrimeStage::hostKeyCode(shortcut.key);
+      key.modifiers = shortcut.modifiers;
+      keys.push_back(key);
+    }
+    // Spread lookups over the whole table instead of walking it in registration order.
+    std::vector<PrimeHost::KeyEvent> shuffled;
+    shuffled.reserve(keys.size());
+    size_t stride = 7919u;
+    for (size_t index = 0u; index < keys.size(); ++index) {
+      shuffled.push_back(keys[(index * stride) % keys.size()]);
+    }
+    keys = std::move(shuffled);
+    return !keys.empty();
+  }
+
+  bool runDispatch() {
+    uint64_t before = invocations;
+    for (size_t index = 0u; index < ShortcutDispatchesPerSample; ++index) {
+      PrimeHost::InputEvent input = keys[cursor];
+      cursor = (cursor + 1u) % keys.size();
+      PrimeStage::InputBridgeResult result = app.bridgeHostInputEvent(input, batch);
+      if (!result.requestFrame) {
+        return false;
+      }
+    }
+    app.markFramePresented();
+    PerfSink += invocations;
+    return (invocations - before) == ShortcutDispatchesPerSample;
+  }
+};
+
+struct StartupRuntime {
+  std::unique_ptr<PrimeStage::App> app;
+  std::chrono::microseconds budget{0};
+  size_t frames = 0u;
+
+  static void buildUi(PrimeStage::UiNode root) {
+    PrimeStage::StackSpec shell;
+    shell.size.stretchX = 1.0f;
+    shell.size.stretchY = 1.0f;
+    shell.gap = 8.0f;
+    PrimeStage::UiNode page = root.createVerticalStack(shell);
+
+    for (int section = 0; section < StartupSectionCount; ++section) {
+      PrimeStage::StackSpec placeholder;
+      placeholder.size.stretchX = 1.0f;
+      placeholder.size.preferredHeight = 360.0f;
+      page.deferred(placeholder, [](PrimeStage::UiNode& body) {
+        PrimeStage::TreeViewSpec tree;
+        tree.nodes = benchmarkDashboardTreeNodes();
+        tree.rowStyle = StyleSurface;
+        tree.rowAltStyle = StyleBackground;
+        tree.selectionStyle = StyleAccent;
+        tree.focusStyle = StyleFocus;
+        tree.size.stretchX = 1.0f;
+        tree.size.preferredHeight = 360.0f;
+        body.createTreeView(tree);
+      });
+    }
+  }
+
+  void reset() {
+    app = std::make_unique<PrimeStage::App>();
+    app->setSurfaceMetrics(static_cast<uint32_t>(TreeRootWidth), static_cast<uint32_t>(TreeRootHeight));
+    app->setProgressiveBuildBudget(budget);
+    frames = 0u;
+  }
+
+  bool presentFrame() {
+    if (!app->runRebuildIfNeeded(buildUi)) {
+      return false;
+    }
+    (void)app->runLayoutIfNeeded();
+    app->markFramePresented();
+    frames += 1u;
+    return true;
+  }
+
+  bool runFirstFrame() {
+    reset();
+    bool presented = presentFrame();
+    PerfSink += app->frame().roots().size();
+    return presented;
+  }
+
+  bool runToCompletion() {
+    if (!runFirstFrame()) {
+      return false;
+    }
+    while (app->progressiveBuildPending() && frames < StartupMaxFrames) {
+      if (!presentFrame()) {
+        return false;
+      }
+    }
+    PerfSink += frames;
+    return !app->progressiveBuildPending();
+  }
+};
+
+// Eight prepareInParallel sections rebuilt through App. `buildHeavy` moves the cost from prepare
+// (formatting and sorting rows) to build (one label per row), which stays on the building thread.
+struct ParallelPrepareRuntime {
+  PrimeStage::App app;
+  bool buildHeavy = false;
+  std::array<std::vector<std::string>, ParallelSectionCount> prepared{};
+
+  void initialize(size_t buildThreads, bool heavyBuild) {
+    app.setSurfaceMetrics(static_cast<uint32_t>(TreeRootWidth),
+                          static_cast<uint32_t>(TreeRootHeight));
+    app.setBuildThreadCount(buildThreads);
+    buildHeavy = heavyBuild;
+  }
+
+  void buildUi(PrimeStage::UiNode root) {
+    size_t rowCount = buildHeavy ? ParallelBuildLabels : ParallelPrepareRows;
+    std::vector<PrimeStage::ParallelSection> sections;
+    sections.reserve(ParallelSectionCount);
+    for (size_t index = 0u; index < ParallelSectionCount; ++index) {
+      std::vector<std::string>& rows = prepared[index];
+      PrimeStage::ParallelSection section;
+      section.prepare = [&rows, index, rowCount]() {
+        rows.clear();
+        rows.reserve(rowCount);
+        for (size_t row = 0u; row < rowCount; ++row) {
+          rows.push_back("Section " + std::to_string(index) + " row " +
+                         std::to_string((row * 7919u) % rowCount));
+        }
+        std::sort(rows.begin(), rows.end());
+      };
+      section.build = [&rows, heavy = buildHeavy](PrimeStage::UiNode& parent) {
+        size_t labelCount = heavy ? rows.size() : std::min<size_t>(rows.size(), 1u);
+        for (size_t row = 0u; row < labelCount; ++row) {
+          PrimeStage::LabelSpec label;
+          label.text = rows[row];
+          parent.createLabel(label);
+        }
+      };
+      sections.push_back(std::move(section));
+    }
+    root.prepareInParallel(sections);
+  }
+
+  bool runRebuild() {
+    app.lifecycle().requestRebuild();
+    if (!app.runRebuildIfNeeded([this](PrimeStage::UiNode root) { buildUi(root); })) {
+      return false;
+    }
+    PerfSink += prepared.front().size();
+    return prepared.back().size() == (buildHeavy ? ParallelBuildLabels : ParallelPrepareRows);
+  }
 };
 
 bool runBenchmarks(BenchmarkOptions const& options,
@@ -991,6 +1358,165 @@ bool runBenchmarks(BenchmarkOptions const& options,
     return false;
   }
 
+  struct TableScale {
+    char const* name;
+    size_t rowCount;
+    bool readThroughSource;
+    bool autoWidth;
+  };
+  constexpr TableScale TableScales[] = {{"10k", 10000u, false, false},
+                                        {"100k", 100000u, false, false},
+                                        {"1m", 1000000u, false, false},
+                                        {"1m_source", 1000000u, true, false},
+                                        {"1m_source_autowidth", 1000000u, true, true}};
+  for (auto const& [scale, rowCount, readThroughSource, autoWidth] : TableScales) {
+    TableRuntime table;
+    table.initialize(rowCount, readThroughSource, autoWidth);
+    std::string prefix = std::string("scene.table_virtualized_") + scale;
+    if (auto metric = runMetric(prefix + ".rebuild.p95_us",
+                                options.warmupIterations,
+                                options.benchmarkIterations,
+                                [&]() {
+                                  table.buildFrame();
+                                  PerfSink += table.tableNode.isValid() ? 1u : 0u;
+                                  return table.tableNode.isValid();
+                                },
+                                error)) {
+      results.push_back(*metric);
+    } else {
+      return false;
+    }
+
+    table.rebuild();
+    if (auto metric = runMetric(std::string("interaction.table_virtualized_") + scale +
+                                    ".wheel.p95_us",
+                                options.warmupIterations,
+                                options.benchmarkIterations,
+                                [&]() { return table.runWheelInteraction(); },
+                                error)) {
+      results.push_back(*metric);
+    } else {
+      return false;
+    }
+  }
+
+  TableRuntime wideTable;
+  wideTable.initializeWide(WideTableRowCount, WideTableColumnCount);
+  if (auto metric = runMetric("scene.table_wide_eager.rebuild.p95_us",
+                              options.warmupIterations,
+                              options.benchmarkIterations,
+                              [&]() {
+                                wideTable.buildFrame();
+                                PerfSink += wideTable.tableNode.isValid() ? 1u : 0u;
+                                return wideTable.tableNode.isValid();
+                              },
+                              error)) {
+    results.push_back(*metric);
+  } else {
+    return false;
+  }
+
+  wideTable.buildFrame();
+  if (auto metric = runMetric("scene.table_wide_eager.layout.p95_us",
+                              options.warmupIterations,
+                              options.benchmarkIterations,
+                              [&]() {
+                                wideTable.runLayoutPass();
+                                PerfSink += wideTable.layout.get(wideTable.tableNode) ? 1u : 0u;
+                                return true;
+                              },
+                              error)) {
+    results.push_back(*metric);
+  } else {
+    return false;
+  }
+
+  if (auto metric = runMetric("interaction.table_wide_eager.row_click.p95_us",
+                              options.warmupIterations,
+                              options.benchmarkIterations,
+                              [&]() { return wideTable.runRowClickInteraction(); },
+                              error)) {
+    results.push_back(*metric);
+  } else {
+    return false;
+  }
+
+  ShortcutRuntime shortcuts;
+  if (!shortcuts.initialize(ShortcutBindingCount)) {
+    error = "Failed to register shortcut benchmark bindings";
+    return false;
+  }
+  if (auto metric = runMetric("interaction.shortcut_dispatch_5k.p95_us",
+                              options.warmupIterations,
+                              options.benchmarkIterations,
+                              [&]() { return shortcuts.runDispatch(); },
+                              error)) {
+    results.push_back(*metric);
+  } else {
+    return false;
+  }
+
+  // Startup: time until the first frame is presented versus time until every deferred section
+  // has been built, with and without a progressive per-frame budget.
+  StartupRuntime eagerStartup;
+  if (auto metric = runMetric("startup.eager.complete.p95_us",
+                              options.warmupIterations,
+                              options.benchmarkIterations,
+                              [&]() { return eagerStartup.runToCompletion(); },
+                              error)) {
+    results.push_back(*metric);
+  } else {
+    return false;
+  }
+
+  StartupRuntime progressiveStartup;
+  progressiveStartup.budget = StartupFrameBudget;
+  if (auto metric = runMetric("startup.progressive.first_frame.p95_us",
+                              options.warmupIterations,
+                              options.benchmarkIterations,
+                              [&]() { return progressiveStartup.runFirstFrame(); },
+                              error)) {
+    results.push_back(*metric);
+  } else {
+    return false;
+  }
+
+  if (auto metric = runMetric("startup.progressive.complete.p95_us",
+                              options.warmupIterations,
+                              options.benchmarkIterations,
+                              [&]() { return progressiveStartup.runToCompletion(); },
+                              error)) {
+    results.push_back(*metric);
+  } else {
+    return false;
+  }
+
+  // prepareInParallel: only prepare steps spread over build threads, so the prepare-heavy scene
+  // should scale with ParallelBuildThreads while the build-heavy one stays flat.
+  struct ParallelScene {
+    char const* name;
+    size_t buildThreads;
+    bool buildHeavy;
+  };
+  constexpr ParallelScene ParallelScenes[] = {
+      {"scene.parallel_prepare.serial.rebuild.p95_us", 0u, false},
+      {"scene.parallel_prepare.threads3.rebuild.p95_us", ParallelBuildThreads, false},
+      {"scene.parallel_build_heavy.serial.rebuild.p95_us", 0u, true},
+      {"scene.parallel_build_heavy.threads3.rebuild.p95_us", ParallelBuildThreads, true}};
+  for (ParallelScene const& scene : ParallelScenes) {
+    ParallelPrepareRuntime parallel;
+    parallel.initialize(scene.buildThreads, scene.buildHeavy);
+    if (auto metric = runMetric(scene.name,
+                                options.warmupIterations,
+                                options.benchmarkIterations,
+                                [&]() { return parallel.runRebuild(); },
+                                error)) {
+      results.push_back(*metric);
+    } else {
+      return false;
+    }
+  }
+
   return true;
 }
 
@@ -217,6 +217,37 @@ TEST_CASE("PrimeStage installs readable defaults for untouched PrimeFrame themes
   CHECK(contrast >= 4.5f);
 }
 
+TEST_CASE("PrimeStage revalidates theme readability only after the theme changes") {
+  PrimeFrame::Frame frame;
+  PrimeFrame::NodeId rootId = frame.createNode();
+  frame.addRoot(rootId);
+  PrimeStage::UiNode root(frame, rootId, true);
+  (void)root;
+
+  PrimeFrame::Theme* theme = frame.getTheme(PrimeFrame::DefaultThemeId);
+  REQUIRE(theme != nullptr);
+  size_t validatedPaletteSize = theme->palette.size();
+  for (int index = 0; index < 64; ++index) {
+    PrimeStage::UiNode again(frame, rootId, true);
+    (void)again;
+  }
+  CHECK(theme->palette.size() == validatedPaletteSize);
+
+  // An unreadable edit after validation is still caught by the next UiNode.
+  size_t fillIndex = theme->rectStyles[0].fill;
+  size_t textIndex = theme->textStyles[0].color;
+  REQUIRE(textIndex < theme->palette.size());
+  theme->palette[textIndex] = theme->palette[fillIndex];
+  PrimeStage::UiNode patched(frame, rootId, true);
+  (void)patched;
+
+  theme = frame.getTheme(PrimeFrame::DefaultThemeId);
+  REQUIRE(theme != nullptr);
+  PrimeFrame::Color fill = theme->palette[theme->rectStyles[0].fill];
+  PrimeFrame::Color text = theme->palette[theme->textStyles[0].color];
+  CHECK(contrastRatio(text, fill) >= 4.5f);
+}
+
 TEST_CASE("PrimeStage list model adapter binds typed rows and key extractors") {
   std::vector<ListModelRow> rows = {
       {"asset.alpha", "Alpha"},
@@ -2467,9 +2498,8 @@ TEST_CASE("PrimeStage data ownership and lifetime contract is documented and wir
                        std::istreambuf_iterator<char>());
   REQUIRE(!tableCpp.empty());
   std::string combinedSource = sourceCpp + collectionsCpp + tableCpp;
-  CHECK(combinedSource.find("ownedRows") != std::string::npos);
   CHECK(combinedSource.find("rowViewScratch") != std::string::npos);
-  CHECK(combinedSource.find("interaction->ownedRows.push_back(std::move(ownedRow));") !=
+  CHECK(combinedSource.find("Internal::copyTableRows(*interaction, spec.rows);") !=
         std::string::npos);
   CHECK(combinedSource.find("info.row = std::span<const std::string_view>(interaction->rowViewScratch);") !=
         std::string::npos);
@@ -4327,6 +4357,7 @@ TEST_CASE("PrimeStage collection entrypoints are split into dedicated translatio
   CHECK(collections.find("UiNode UiNode::createTreeView(std::vector<TreeNode> nodes, SizeSpec const& size)") ==
         std::string::npos);
   CHECK(collections.find("Internal::normalizeListSpec(specInput)") != std::string::npos);
+  CHECK(collections.find("ListSpec spec = Internal::normalizeListSpec(") == std::string::npos);
   CHECK(collections.find("Internal::normalizeTableSpec(specInput)") == std::string::npos);
   CHECK(collections.find("Internal::normalizeTreeViewSpec(spec)") == std::string::npos);
   CHECK(collections.find("Internal::normalizeScrollViewSpec(specInput)") != std::string::npos);
@@ -4343,6 +4374,7 @@ TEST_CASE("PrimeStage collection entrypoints are split into dedicated translatio
   CHECK(table.find("UiNode UiNode::createTable(std::vector<TableColumn> columns,") !=
         std::string::npos);
   CHECK(table.find("Internal::normalizeTableSpec(specInput)") != std::string::npos);
+  CHECK(table.find("TableSpec spec = Internal::normalizeTableSpec(") == std::string::npos);
   CHECK(table.find("Internal::makeWidgetRuntimeContext(") != std::string::npos);
   CHECK(table.find("Internal::configureInteractiveRoot(runtime, tableRoot.nodeId()") !=
         std::string::npos);
@@ -4357,11 +4389,12 @@ TEST_CASE("PrimeStage collection entrypoints are split into dedicated translatio
   CHECK(tree.find("UiNode UiNode::createTreeView(std::vector<TreeNode> nodes, SizeSpec const& size)") !=
         std::string::npos);
   CHECK(tree.find("Internal::normalizeTreeViewSpec(spec)") != std::string::npos);
+  CHECK(tree.find("TreeViewSpec normalized = Internal::normalizeTreeViewSpec(") == std::string::npos);
   CHECK(tree.find("Internal::makeWidgetRuntimeContext(") != std::string::npos);
   CHECK(tree.find("Internal::makeParentNode(runtime)") != std::string::npos);
   CHECK(tree.find("Internal::attachFocusOverlay(runtime,") != std::string::npos);
   CHECK(tree.find("Internal::addDisabledScrimOverlay(runtime,") != std::string::npos);
-  CHECK(tree.find("flatten_tree(") != std::string::npos);
+  CHECK(tree.find("Internal::flattenTree(") != std::string::npos);
 
   std::ifstream dropdownInput(dropdownPath);
   REQUIRE(dropdownInput.good());
@@ -4769,6 +4802,52 @@ TEST_CASE("PrimeStage LowLevel appendNodeOnFocus and appendNodeOnBlur compose ca
   CHECK(appendedBlur == 1);
 }
 
+TEST_CASE("PrimeStage LowLevel append helpers flatten handlers into one node callback") {
+  PrimeFrame::Frame frame;
+  PrimeFrame::NodeId nodeId = frame.createNode();
+  frame.addRoot(nodeId);
+  PrimeFrame::Node* node = frame.getNode(nodeId);
+  REQUIRE(node != nullptr);
+
+  std::vector<int> order;
+  CHECK(PrimeStage::LowLevel::appendNodeOnEvent(frame, nodeId, [&](PrimeFrame::Event const&) {
+    order.push_back(1);
+    return false;
+  }));
+  PrimeFrame::CallbackId firstId = node->callbacks;
+  CHECK(PrimeStage::LowLevel::appendNodeOnEvent(frame, nodeId, [&](PrimeFrame::Event const&) {
+    order.push_back(2);
+    return false;
+  }));
+  bool appendedDuringDispatch = false;
+  CHECK(PrimeStage::LowLevel::appendNodeOnEvent(frame, nodeId, [&](PrimeFrame::Event const&) {
+    order.push_back(3);
+    if (!appendedDuringDispatch) {
+      appendedDuringDispatch = true;
+      CHECK(PrimeStage::LowLevel::appendNodeOnEvent(frame, nodeId, [&](PrimeFrame::Event const&) {
+        order.push_back(4);
+        return true;
+      }));
+    }
+    return false;
+  }));
+  CHECK(node->callbacks == firstId);
+
+  PrimeFrame::Callback const* callback = frame.getCallback(node->callbacks);
+  REQUIRE(callback != nullptr);
+  REQUIRE(callback->onEvent);
+
+  PrimeFrame::Event event;
+  event.type = PrimeFrame::EventType::KeyDown;
+  CHECK_FALSE(callback->onEvent(event));
+  CHECK(order == std::vector<int>{3, 2, 1});
+
+  order.clear();
+  CHECK(callback->onEvent(event));
+  CHECK(order == std::vector<int>{4});
+  CHECK(node->callbacks == firstId);
+}
+
 TEST_CASE("PrimeStage LowLevel appendNodeOnEvent suppresses direct reentrant recursion") {
   PrimeFrame::Frame frame;
   PrimeFrame::NodeId nodeId = frame.createNode();
@@ -1,11 +1,20 @@
 #include "PrimeStage/App.h"
 #include "PrimeStage/AppRuntime.h"
+#include "PrimeStage/TextSelection.h"
+#include "src/PrimeStageBuildTaskPool.h"
 
 #include "third_party/doctest.h"
 
 #include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
 #include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 TEST_CASE("AppShortcut equality compares key modifiers and repeat policy") {
@@ -427,6 +436,237 @@ TEST_CASE("App dispatchFrameEvent consumes pending layout before ignored events"
   CHECK_FALSE(app.lifecycle().framePending());
 }
 
+TEST_CASE("App dispatchFrameEvent lays out recycled table rows after a scroll") {
+  PrimeStage::App app;
+
+  std::vector<std::string> names;
+  for (int index = 0; index < 200; ++index) {
+    names.push_back("Row " + std::to_string(index));
+  }
+  PrimeFrame::NodeId tableId{};
+  PrimeFrame::NodeId rowsId{};
+  int selected = -1;
+  CHECK(app.runRebuildIfNeeded([&](PrimeStage::UiNode root) {
+    PrimeStage::TableSpec spec;
+    spec.columns = {{"Name", 160.0f, 0u, 0u}};
+    for (std::string const& name : names) {
+      spec.rows.push_back({name});
+    }
+    spec.size.preferredWidth = 220.0f;
+    spec.size.preferredHeight = 120.0f;
+    spec.headerInset = 0.0f;
+    spec.headerHeight = 0.0f;
+    spec.showHeaderDividers = false;
+    spec.rowHeight = 20.0f;
+    spec.rowGap = 0.0f;
+    spec.virtualized = true;
+    spec.overscanRows = 2;
+    spec.callbacks.onSelect = [&](PrimeStage::TableRowInfo const& info) {
+      selected = info.rowIndex;
+    };
+    tableId = root.createTable(spec).nodeId();
+  }));
+  CHECK(app.runLayoutIfNeeded());
+  app.markFramePresented();
+
+  std::vector<PrimeFrame::NodeId> pending = {tableId};
+  while (!pending.empty() && !rowsId.isValid()) {
+    PrimeFrame::NodeId nodeId = pending.back();
+    pending.pop_back();
+    PrimeFrame::Node const* node = app.frame().getNode(nodeId);
+    if (!node) {
+      continue;
+    }
+    if (node->isViewport) {
+      rowsId = nodeId;
+    }
+    pending.insert(pending.end(), node->children.begin(), node->children.end());
+  }
+  REQUIRE(rowsId.isValid());
+  auto rowNodeAt = [&](int rowIndex) {
+    PrimeFrame::Node const* rowsNode = app.frame().getNode(rowsId);
+    for (PrimeFrame::NodeId child : rowsNode->children) {
+      PrimeFrame::Node const* rowNode = app.frame().getNode(child);
+      if (rowNode && rowNode->visible &&
+          rowNode->localY == doctest::Approx(static_cast<float>(rowIndex) * 20.0f)) {
+        return child;
+      }
+    }
+    return PrimeFrame::NodeId{};
+  };
+
+  PrimeFrame::LayoutOut const* tableOut = app.layout().get(tableId);
+  REQUIRE(tableOut != nullptr);
+  float tableX = tableOut->absX;
+  float tableY = tableOut->absY;
+  PrimeFrame::Event wheel;
+  wheel.type = PrimeFrame::EventType::PointerScroll;
+  wheel.x = tableX + 40.0f;
+  wheel.y = tableY + 40.0f;
+  wheel.scrollY = 200.0f;
+  CHECK(app.dispatchFrameEvent(wheel));
+  // The scroll rebound recycled row nodes to new offsets.
+  CHECK(app.lifecycle().layoutPending());
+
+  CHECK(app.runLayoutIfNeeded());
+  PrimeFrame::NodeId topRowId = rowNodeAt(10);
+  REQUIRE(topRowId.isValid());
+  PrimeFrame::LayoutOut const* topRowOut = app.layout().get(topRowId);
+  REQUIRE(topRowOut != nullptr);
+  CHECK(topRowOut->absY == doctest::Approx(tableY));
+
+  PrimeFrame::Event down;
+  down.type = PrimeFrame::EventType::PointerDown;
+  down.pointerId = 1;
+  down.x = topRowOut->absX + 20.0f;
+  down.y = topRowOut->absY + topRowOut->absH * 0.5f;
+  CHECK(app.dispatchFrameEvent(down));
+  CHECK(selected == 10);
+
+  // A scroll that cannot move the rows leaves layout alone.
+  app.markFramePresented();
+  wheel.scrollY = -1000.0f;
+  (void)app.dispatchFrameEvent(wheel);
+  CHECK(app.runLayoutIfNeeded());
+  app.markFramePresented();
+  (void)app.dispatchFrameEvent(wheel);
+  CHECK_FALSE(app.lifecycle().layoutPending());
+}
+
+TEST_CASE("App dispatchEventBatch coalesces pointer moves and sums scroll deltas") {
+  PrimeStage::App app;
+
+  PrimeFrame::NodeId panelId{};
+  CHECK(app.runRebuildIfNeeded([&](PrimeStage::UiNode root) {
+    PrimeStage::PanelSpec panel;
+    panel.size.preferredWidth = 200.0f;
+    panel.size.preferredHeight = 120.0f;
+    panelId = root.createPanel(panel).nodeId();
+  }));
+
+  std::vector<PrimeFrame::EventType> received;
+  std::vector<float> moveX;
+  float scrollTotal = 0.0f;
+  CHECK(PrimeStage::LowLevel::appendNodeOnEvent(
+      app.frame(),
+      panelId,
+      [&](PrimeFrame::Event const& event) {
+        if (event.type == PrimeFrame::EventType::PointerMove ||
+            event.type == PrimeFrame::EventType::PointerDown ||
+            event.type == PrimeFrame::EventType::PointerScroll) {
+          received.push_back(event.type);
+        }
+        if (event.type == PrimeFrame::EventType::PointerMove) {
+          moveX.push_back(event.x);
+        }
+        if (event.type == PrimeFrame::EventType::PointerScroll) {
+          scrollTotal += event.scrollY;
+        }
+        return true;
+      }));
+
+  auto pointerEvent = [](PrimeHost::PointerPhase phase, float x) {
+    PrimeHost::PointerEvent pointer;
+    pointer.pointerId = 1u;
+    pointer.phase = phase;
+    pointer.x = static_cast<int32_t>(x);
+    pointer.y = 20;
+    PrimeHost::Event event;
+    event.payload = PrimeHost::InputEvent{pointer};
+    return event;
+  };
+  auto scrollEvent = [](float deltaY) {
+    PrimeHost::ScrollEvent scroll;
+    scroll.deltaY = deltaY;
+    scroll.isLines = false;
+    PrimeHost::Event event;
+    event.payload = PrimeHost::InputEvent{scroll};
+    return event;
+  };
+
+  std::vector<PrimeHost::Event> events;
+  events.push_back(pointerEvent(PrimeHost::PointerPhase::Move, 10.0f));
+  events.push_back(pointerEvent(PrimeHost::PointerPhase::Move, 20.0f));
+  events.push_back(pointerEvent(PrimeHost::PointerPhase::Move, 30.0f));
+  events.push_back(scrollEvent(4.0f));
+  events.push_back(scrollEvent(6.0f));
+  events.push_back(pointerEvent(PrimeHost::PointerPhase::Down, 30.0f));
+  events.push_back(pointerEvent(PrimeHost::PointerPhase::Move, 40.0f));
+  events.push_back(pointerEvent(PrimeHost::PointerPhase::Move, 50.0f));
+  PrimeHost::EventBatch batch{
+      std::span<const PrimeHost::Event>(events.data(), events.size()),
+      std::span<const char>{},
+  };
+
+  app.markFramePresented();
+  PrimeStage::InputBridgeResult result = app.dispatchEventBatch(batch);
+  CHECK(result.requestFrame);
+  CHECK(result.bypassFrameCap);
+  CHECK_FALSE(result.requestExit);
+  CHECK(app.lifecycle().framePending());
+  CHECK_FALSE(app.lifecycle().layoutPending());
+
+  std::vector<PrimeFrame::EventType> expected{
+      PrimeFrame::EventType::PointerMove,
+      PrimeFrame::EventType::PointerScroll,
+      PrimeFrame::EventType::PointerDown,
+      PrimeFrame::EventType::PointerMove,
+  };
+  CHECK(received == expected);
+  REQUIRE(moveX.size() == 2u);
+  CHECK(moveX[0] == doctest::Approx(30.0f));
+  CHECK(moveX[1] == doctest::Approx(50.0f));
+  CHECK(scrollTotal == doctest::Approx(10.0f));
+}
+
+TEST_CASE("App dispatchEventBatch lays out again before events that follow a resize") {
+  PrimeStage::App app;
+  app.setSurfaceMetrics(100u, 100u, 1.0f);
+
+  PrimeFrame::NodeId panelId{};
+  CHECK(app.runRebuildIfNeeded([&](PrimeStage::UiNode root) {
+    PrimeStage::PanelSpec panel;
+    panel.size.stretchX = 1.0f;
+    panel.size.stretchY = 1.0f;
+    panelId = root.createPanel(panel).nodeId();
+  }));
+  CHECK(app.runLayoutIfNeeded());
+
+  int downs = 0;
+  CHECK(PrimeStage::LowLevel::appendNodeOnEvent(
+      app.frame(),
+      panelId,
+      [&](PrimeFrame::Event const& event) {
+        if (event.type != PrimeFrame::EventType::PointerDown) {
+          return false;
+        }
+        downs += 1;
+        return true;
+      }));
+
+  PrimeHost::ResizeEvent resize;
+  resize.width = 400u;
+  resize.height = 300u;
+  resize.scale = 1.0f;
+  PrimeHost::PointerEvent pointer;
+  pointer.pointerId = 1u;
+  pointer.phase = PrimeHost::PointerPhase::Down;
+  pointer.x = 300;
+  pointer.y = 200;
+  std::vector<PrimeHost::Event> events(2u);
+  events[0].payload = resize;
+  events[1].payload = PrimeHost::InputEvent{pointer};
+  PrimeHost::EventBatch batch{
+      std::span<const PrimeHost::Event>(events.data(), events.size()),
+      std::span<const char>{},
+  };
+
+  (void)app.dispatchEventBatch(batch);
+  // The press lies outside the pre-resize surface, so it only lands on the grown panel.
+  CHECK(downs == 1);
+  CHECK_FALSE(app.lifecycle().layoutPending());
+}
+
 TEST_CASE("App focusWidget no-op does not request an extra frame") {
   PrimeStage::App app;
 
@@ -1450,6 +1690,32 @@ TEST_CASE("App unregisterAction preserves shortcuts bound to other actions") {
   CHECK(app.lifecycle().framePending());
 }
 
+TEST_CASE("App action callback may unregister and re-register itself while running") {
+  PrimeStage::App app;
+
+  int firstCount = 0;
+  int replacementCount = 0;
+  std::string observedId;
+  CHECK(app.registerAction("demo.self_remove", [&](PrimeStage::AppActionInvocation const& invocation) {
+    firstCount += 1;
+    CHECK(app.unregisterAction("demo.self_remove"));
+    CHECK_FALSE(app.invokeAction("demo.self_remove"));
+    CHECK(app.registerAction("demo.self_remove", [&](PrimeStage::AppActionInvocation const&) {
+      replacementCount += 1;
+    }));
+    observedId = invocation.actionId;
+  }));
+
+  CHECK(app.invokeAction("demo.self_remove"));
+  CHECK(firstCount == 1);
+  CHECK(replacementCount == 0);
+  CHECK(observedId == "demo.self_remove");
+
+  CHECK(app.invokeAction("demo.self_remove"));
+  CHECK(firstCount == 1);
+  CHECK(replacementCount == 1);
+}
+
 TEST_CASE("App unregisterAction removes all shortcuts bound to the action") {
   PrimeStage::App app;
 
@@ -2390,3 +2656,676 @@ TEST_CASE("App does not emit duplicate IME rect updates when focus rect is uncha
   CHECK_FALSE(app.focusWidget(focusHandle));
   CHECK(imeUpdates == updatesAfterFirstFocus);
 }
+
+TEST_CASE("TimerScheduler fires due timers in deadline order and honors cancel") {
+  PrimeStage::TimerScheduler timers;
+  auto base = PrimeStage::TimerScheduler::Clock::time_point{} + std::chrono::seconds(10);
+  std::vector<int> order;
+
+  PrimeStage::TimerId late = timers.schedule(base + std::chrono::milliseconds(30),
+                                             [&]() { order.push_back(3); });
+  PrimeStage::TimerId early = timers.schedule(base + std::chrono::milliseconds(10),
+                                              [&]() { order.push_back(1); });
+  PrimeStage::TimerId cancelled = timers.schedule(base + std::chrono::milliseconds(5),
+                                                  [&]() { order.push_back(0); });
+  CHECK(late != PrimeStage::InvalidTimerId);
+  CHECK(early != PrimeStage::InvalidTimerId);
+  CHECK(timers.pendingCount() == 3u);
+  REQUIRE(timers.nextDeadline().has_value());
+  CHECK(*timers.nextDeadline() == base + std::chrono::milliseconds(5));
+
+  CHECK(timers.cancel(cancelled));
+  CHECK_FALSE(timers.cancel(cancelled));
+  CHECK_FALSE(timers.pending(cancelled));
+  REQUIRE(timers.nextDeadline().has_value());
+  CHECK(*timers.nextDeadline() == base + std::chrono::milliseconds(10));
+
+  CHECK(timers.runDue(base) == 0u);
+  CHECK(order.empty());
+
+  // A callback that re-arms itself at an already-due deadline waits for the next runDue call.
+  timers.schedule(base + std::chrono::milliseconds(20), [&]() {
+    order.push_back(2);
+    timers.schedule(base, [&]() { order.push_back(4); });
+  });
+  CHECK(timers.runDue(base + std::chrono::milliseconds(40)) == 3u);
+  CHECK(order == std::vector<int>{1, 2, 3});
+  CHECK(timers.pendingCount() == 1u);
+  CHECK(timers.runDue(base + std::chrono::milliseconds(40)) == 1u);
+  CHECK(order == std::vector<int>{1, 2, 3, 4});
+  CHECK_FALSE(timers.nextDeadline().has_value());
+}
+
+TEST_CASE("TimerScheduler queues timers from a deferring thread until adopted") {
+  PrimeStage::TimerScheduler timers;
+  auto base = PrimeStage::TimerScheduler::Clock::time_point{} + std::chrono::seconds(10);
+  int fired = 0;
+  PrimeStage::TimerId kept = PrimeStage::InvalidTimerId;
+  PrimeStage::TimerId dropped = PrimeStage::InvalidTimerId;
+  std::thread worker([&]() {
+    PrimeStage::TimerScheduler::DeferScope scope{timers};
+    kept = timers.schedule(base, [&]() { ++fired; });
+    dropped = timers.schedule(base, [&]() { fired += 10; });
+  });
+  worker.join();
+
+  CHECK(kept != dropped);
+  CHECK(timers.pending(kept));
+  CHECK(timers.pendingCount() == 0u);
+  CHECK_FALSE(timers.nextDeadline().has_value());
+  CHECK(timers.runDue(base) == 0u);
+
+  CHECK(timers.cancel(dropped));
+  CHECK(timers.adoptDeferred() == 1u);
+  CHECK(timers.pendingCount() == 1u);
+  REQUIRE(timers.nextDeadline().has_value());
+  CHECK(*timers.nextDeadline() == base);
+  CHECK(timers.runDue(base) == 1u);
+  CHECK(fired == 1);
+}
+
+TEST_CASE("App drives text field cursor blink from wake deadlines") {
+  PrimeStage::App app;
+
+  PrimeStage::WidgetFocusHandle focusHandle;
+  PrimeStage::TextFieldState textState;
+  textState.text = "blink";
+  CHECK(app.runRebuildIfNeeded([&](PrimeStage::UiNode root) {
+    PrimeStage::TextFieldSpec field;
+    field.state = &textState;
+    field.cursorBlinkInterval = std::chrono::milliseconds(500);
+    field.size.preferredWidth = 180.0f;
+    field.size.preferredHeight = 28.0f;
+    app.applyPlatformServices(field);
+    CHECK(field.timers == &app.timers());
+    focusHandle = root.createTextField(field).focusHandle();
+  }));
+  CHECK(app.runLayoutIfNeeded());
+  CHECK(app.timers().pendingCount() == 0u);
+
+  CHECK(app.focusWidget(focusHandle));
+  CHECK(textState.cursorVisible);
+  REQUIRE(app.timers().nextDeadline().has_value());
+  auto firstBlink = *app.timers().nextDeadline();
+  CHECK(firstBlink == textState.nextBlink);
+
+  app.markFramePresented();
+  REQUIRE(app.nextWakeDeadline().has_value());
+  CHECK(*app.nextWakeDeadline() == firstBlink);
+
+  CHECK(app.runDueTimers(firstBlink - std::chrono::milliseconds(1)) == 0u);
+  CHECK_FALSE(app.lifecycle().framePending());
+  CHECK(app.runDueTimers(firstBlink) == 1u);
+  CHECK_FALSE(textState.cursorVisible);
+  CHECK(app.lifecycle().framePending());
+  REQUIRE(app.timers().nextDeadline().has_value());
+  CHECK(*app.timers().nextDeadline() == firstBlink + std::chrono::milliseconds(500));
+
+  app.markFramePresented();
+  CHECK(app.runDueTimers(firstBlink + std::chrono::milliseconds(500)) == 1u);
+  CHECK(textState.cursorVisible);
+}
+
+TEST_CASE("App runDueTimers requests a frame only for repaint timers") {
+  PrimeStage::App app;
+  auto base = PrimeStage::TimerScheduler::Clock::time_point{} + std::chrono::seconds(10);
+  int stateResets = 0;
+  int repaints = 0;
+  app.timers().schedule(base, [&]() { ++stateResets; }, PrimeStage::TimerEffect::StateOnly);
+  app.markFramePresented();
+
+  CHECK(app.runDueTimers(base) == 1u);
+  CHECK(stateResets == 1);
+  CHECK(app.timers().lastRepaintCount() == 0u);
+  CHECK_FALSE(app.lifecycle().framePending());
+
+  app.timers().schedule(base, [&]() { ++stateResets; }, PrimeStage::TimerEffect::StateOnly);
+  app.timers().schedule(base, [&]() { ++repaints; });
+  CHECK(app.runDueTimers(base) == 2u);
+  CHECK(stateResets == 2);
+  CHECK(repaints == 1);
+  CHECK(app.timers().lastRepaintCount() == 1u);
+  CHECK(app.lifecycle().framePending());
+}
+
+TEST_CASE("App background rebuild swaps in the back frame and restores focus by identity") {
+  PrimeStage::App app;
+  PrimeStage::WidgetIdentityReconciler identity;
+
+  auto buildButtons = [&identity](std::vector<std::string> labels) {
+    return [&identity, labels = std::move(labels)](PrimeStage::UiNode root) {
+      PrimeStage::UiNode column = root.column();
+      for (std::string const& label : labels) {
+        PrimeStage::ButtonSpec button;
+        button.label = label;
+        button.size.preferredWidth = 100.0f;
+        button.size.preferredHeight = 28.0f;
+        identity.registerNode(label, column.createButton(button).nodeId());
+      }
+    };
+  };
+
+  identity.beginRebuild(app.focus().focusedNode());
+  CHECK(app.runRebuildIfNeeded(buildButtons({"save", "load"})));
+  CHECK(app.runLayoutIfNeeded());
+  PrimeFrame::NodeId frontLoad = identity.findNode("load");
+  REQUIRE(frontLoad.isValid());
+  REQUIRE(app.focus().setFocus(app.frame(), app.layout(), frontLoad));
+
+  CHECK_FALSE(app.startBackgroundRebuild(buildButtons({"noop"}), &identity));
+  app.lifecycle().requestRebuild();
+  CHECK(app.startBackgroundRebuild(buildButtons({"extra", "save", "load"}), &identity));
+  CHECK(app.backgroundRebuildInFlight());
+  CHECK_FALSE(app.lifecycle().rebuildPending());
+  CHECK_FALSE(app.startBackgroundRebuild(buildButtons({"noop"})));
+
+  // Requests made while the worker runs stay pending; the synchronous path waits for the swap.
+  app.lifecycle().requestRebuild();
+  CHECK_FALSE(app.runRebuildIfNeeded([](PrimeStage::UiNode) { FAIL("sync rebuild raced worker"); }));
+  CHECK(app.frame().getNode(frontLoad) != nullptr);
+
+  while (!app.commitBackgroundRebuild()) {
+    std::this_thread::yield();
+  }
+  CHECK_FALSE(app.backgroundRebuildInFlight());
+  CHECK(app.lifecycle().rebuildPending());
+  CHECK(app.lifecycle().layoutPending());
+
+  CHECK(app.runLayoutIfNeeded());
+  PrimeFrame::NodeId backLoad = identity.findNode("load");
+  REQUIRE(backLoad.isValid());
+  CHECK(backLoad != frontLoad);
+  CHECK(app.focus().focusedNode() == backLoad);
+
+  // Handlers built on the worker drive the ring the App adopted, so the restored focus draws.
+  REQUIRE(app.focusRing().target().has_value());
+  CHECK(app.focusRing().target()->node == backLoad);
+  std::vector<PrimeFrame::DrawCommand> ring;
+  app.focusRing().appendDrawCommands(app.frame(), app.layout(), backLoad, ring);
+  CHECK(ring.size() == 4u);
+}
+
+TEST_CASE("App background rebuild hands widget timers to the UI thread at commit") {
+  PrimeStage::App app;
+  CHECK(app.runRebuildIfNeeded([](PrimeStage::UiNode) {}));
+
+  auto blinkAt = PrimeStage::TimerScheduler::Clock::now() + std::chrono::seconds(60);
+  auto textState = std::make_shared<PrimeStage::TextFieldState>();
+  textState->text = "queued";
+  textState->focused = true;
+  textState->cursorVisible = true;
+  textState->nextBlink = blinkAt;
+
+  app.lifecycle().requestRebuild();
+  CHECK(app.startBackgroundRebuild([&app, textState](PrimeStage::UiNode root) {
+    PrimeStage::TextFieldSpec field;
+    field.state = textState.get();
+    field.cursorBlinkInterval = std::chrono::milliseconds(500);
+    app.applyPlatformServices(field);
+    (void)root.createTextField(field);
+  }));
+  while (!app.commitBackgroundRebuild()) {
+    std::this_thread::yield();
+  }
+
+  CHECK(app.timers().pendingCount() == 1u);
+  REQUIRE(app.timers().nextDeadline().has_value());
+  CHECK(*app.timers().nextDeadline() == blinkAt);
+  CHECK(app.runDueTimers(blinkAt) == 1u);
+  CHECK_FALSE(textState->cursorVisible);
+}
+
+TEST_CASE("PostedUpdateQueue coalesces by key text") {
+  PrimeStage::PostedUpdateQueue queue;
+  std::vector<std::string> ran;
+  CHECK(queue.push("progress", [&]() { ran.push_back("progress 1"); }));
+  CHECK_FALSE(queue.push("status", [&]() { ran.push_back("status"); }));
+  CHECK_FALSE(queue.push([&]() { ran.push_back("log 1"); }));
+  CHECK_FALSE(queue.push("", [&]() { ran.push_back("empty 1"); }));
+  CHECK_FALSE(queue.push("progress", [&]() { ran.push_back("progress 2"); }));
+  CHECK_FALSE(queue.push([&]() { ran.push_back("log 2"); }));
+  CHECK_FALSE(queue.push("", [&]() { ran.push_back("empty 2"); }));
+
+  CHECK(queue.drain() == 5u);
+  CHECK(ran == std::vector<std::string>{"status", "log 1", "progress 2", "log 2", "empty 2"});
+  CHECK(queue.empty());
+  CHECK(queue.drain() == 0u);
+}
+
+TEST_CASE("App post coalesces keyed worker updates into one rebuild per frame") {
+  PrimeStage::App app;
+  CHECK(app.runRebuildIfNeeded([](PrimeStage::UiNode) {}));
+  CHECK_FALSE(app.lifecycle().rebuildPending());
+
+  std::atomic<int> wakes{0};
+  PrimeStage::AppPlatformServices services;
+  services.onPostedUpdate = [&wakes]() { wakes.fetch_add(1, std::memory_order_relaxed); };
+  app.setPlatformServices(services);
+
+  constexpr int WorkerCount = 4;
+  constexpr int PostsPerWorker = 500;
+  int progressUpdates = 0;
+  int latestProgress = -1;
+  int logLines = 0;
+  std::vector<std::thread> workers;
+  for (int worker = 0; worker < WorkerCount; ++worker) {
+    workers.emplace_back([&app, &progressUpdates, &latestProgress, &logLines, worker]() {
+      for (int i = 0; i < PostsPerWorker; ++i) {
+        int value = worker * PostsPerWorker + i;
+        app.post("telemetry.progress", [&progressUpdates, &latestProgress, value]() {
+          progressUpdates += 1;
+          latestProgress = value;
+        });
+        app.post([&logLines]() { logLines += 1; });
+      }
+    });
+  }
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+  CHECK(wakes.load() == 1);
+  CHECK(progressUpdates == 0);
+
+  int rebuildCalls = 0;
+  CHECK(app.runRebuildIfNeeded([&](PrimeStage::UiNode) { rebuildCalls += 1; }));
+  CHECK(rebuildCalls == 1);
+  CHECK(progressUpdates == 1);
+  CHECK(latestProgress >= 0);
+  CHECK(logLines == WorkerCount * PostsPerWorker);
+  CHECK_FALSE(app.lifecycle().rebuildPending());
+
+  CHECK(app.drainPostedUpdates() == 0u);
+  app.post("telemetry.progress", [&latestProgress]() { latestProgress = -7; });
+  CHECK(wakes.load() == 2);
+  CHECK(app.drainPostedUpdates() == 1u);
+  CHECK(latestProgress == -7);
+  CHECK(app.lifecycle().rebuildPending());
+}
+
+TEST_CASE("App memo sections reuse unchanged subtrees across rebuilds") {
+  PrimeStage::App app;
+
+  int staticBuilds = 0;
+  int dynamicBuilds = 0;
+  uint64_t dynamicHash = 1u;
+  bool includeStatic = true;
+  PrimeFrame::NodeId staticButton{};
+  PrimeFrame::NodeId dynamicButton{};
+  auto makeButton = [](PrimeStage::UiNode& section, std::string_view label) {
+    PrimeStage::ButtonSpec button;
+    button.label = label;
+    button.size.preferredWidth = 100.0f;
+    button.size.preferredHeight = 28.0f;
+    return section.createButton(button).nodeId();
+  };
+  auto rebuild = [&](PrimeStage::UiNode root) {
+    if (includeStatic) {
+      root.memo("sections.static", 7u, [&](PrimeStage::UiNode& section) {
+        staticBuilds += 1;
+        staticButton = makeButton(section, "Static");
+      });
+    }
+    root.memo("sections.dynamic", dynamicHash, [&](PrimeStage::UiNode& section) {
+      dynamicBuilds += 1;
+      dynamicButton = makeButton(section, "Dynamic");
+    });
+  };
+
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(staticBuilds == 1);
+  CHECK(dynamicBuilds == 1);
+  CHECK(app.memoCache().size() == 2u);
+  PrimeFrame::NodeId firstStatic = staticButton;
+
+  app.lifecycle().requestRebuild();
+  dynamicHash = 2u;
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(staticBuilds == 1);
+  CHECK(dynamicBuilds == 2);
+  CHECK(app.memoCache().reusedCount() == 1u);
+
+  auto const& roots = app.frame().roots();
+  REQUIRE_FALSE(roots.empty());
+  PrimeFrame::Node const* rootNode = app.frame().getNode(roots.front());
+  REQUIRE(rootNode != nullptr);
+  REQUIRE(rootNode->children.size() == 2u);
+  CHECK(rootNode->children.front() == firstStatic);
+  CHECK(rootNode->children.back() == dynamicButton);
+  CHECK(app.runLayoutIfNeeded());
+  CHECK(app.layout().get(firstStatic) != nullptr);
+
+  app.lifecycle().requestRebuild();
+  includeStatic = false;
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(dynamicBuilds == 2);
+  CHECK(app.memoCache().size() == 1u);
+  rootNode = app.frame().getNode(app.frame().roots().front());
+  REQUIRE(rootNode != nullptr);
+  REQUIRE(rootNode->children.size() == 1u);
+  CHECK(rootNode->children.front() == dynamicButton);
+}
+
+TEST_CASE("App progressive builds fill deferred sections over later frames") {
+  PrimeStage::App app;
+  app.setSurfaceMetrics(640u, 480u, 1.0f);
+  app.setProgressiveBuildBudget(std::chrono::microseconds{1});
+
+  int built = 0;
+  std::vector<PrimeFrame::NodeId> sections;
+  auto rebuild = [&](PrimeStage::UiNode root) {
+    sections.clear();
+    for (int index = 0; index < 3; ++index) {
+      PrimeStage::StackSpec placeholder;
+      placeholder.size.preferredWidth = 120.0f;
+      placeholder.size.preferredHeight = 40.0f;
+      sections.push_back(root.deferred(placeholder, [&built](PrimeStage::UiNode& section) {
+                                 // Outlast the budget so each frame finishes exactly one section.
+                                 std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                                 PrimeStage::PanelSpec panel;
+                                 panel.size.preferredWidth = 100.0f;
+                                 panel.size.preferredHeight = 20.0f;
+                                 section.createPanel(panel);
+                                 built += 1;
+                               })
+                                 .nodeId());
+    }
+  };
+
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(built <= 1);
+  CHECK(app.progressiveBuildPending());
+  CHECK(app.nextWakeDeadline().has_value());
+  CHECK(app.runLayoutIfNeeded());
+  REQUIRE(sections.size() == 3u);
+  PrimeFrame::Node const* lastSection = app.frame().getNode(sections.back());
+  REQUIRE(lastSection != nullptr);
+  CHECK(lastSection->children.empty());
+  PrimeFrame::LayoutOut const* placeholderOut = app.layout().get(sections.back());
+  REQUIRE(placeholderOut != nullptr);
+  CHECK(placeholderOut->absH == doctest::Approx(40.0f));
+
+  int frames = 0;
+  while (app.progressiveBuildPending() && frames < 8) {
+    int before = built;
+    CHECK(app.runRebuildIfNeeded(rebuild));
+    CHECK(built == before + 1);
+    CHECK(app.lifecycle().layoutPending());
+    app.markFramePresented();
+    frames += 1;
+  }
+  CHECK_FALSE(app.progressiveBuildPending());
+  CHECK(built == 3);
+  CHECK(app.frame().getNode(sections.back())->children.size() == 1u);
+  CHECK_FALSE(app.runRebuildIfNeeded(rebuild));
+
+  // A new rebuild discards unfinished sections from the previous tree.
+  built = 0;
+  app.lifecycle().requestRebuild();
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  app.lifecycle().requestRebuild();
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  while (app.progressiveBuildPending()) {
+    CHECK(app.runRebuildIfNeeded(rebuild));
+  }
+  CHECK(built <= 4);
+  for (PrimeFrame::NodeId section : sections) {
+    PrimeFrame::Node const* node = app.frame().getNode(section);
+    REQUIRE(node != nullptr);
+    CHECK(node->children.size() == 1u);
+  }
+}
+
+TEST_CASE("UiNode deferred sections build inline without a progressive budget") {
+  PrimeStage::App app;
+  int built = 0;
+  CHECK(app.runRebuildIfNeeded([&](PrimeStage::UiNode root) {
+    root.deferred(PrimeStage::StackSpec{}, [&built](PrimeStage::UiNode& outer) {
+      built += 1;
+      outer.deferred(PrimeStage::StackSpec{}, [&built](PrimeStage::UiNode&) { built += 1; });
+    });
+  }));
+  CHECK(built == 2);
+  CHECK_FALSE(app.progressiveBuildPending());
+}
+
+TEST_CASE("App prepareInParallel prepares concurrently and builds in declaration order") {
+  PrimeStage::App app;
+  app.setBuildThreadCount(3u);
+  CHECK(app.buildThreadCount() == 3u);
+
+  constexpr size_t SectionCount = 6u;
+  std::array<float, SectionCount> widths{};
+  std::atomic<int> prepared{0};
+  std::vector<PrimeFrame::NodeId> built;
+  auto rebuild = [&](PrimeStage::UiNode root) {
+    built.clear();
+    std::vector<PrimeStage::ParallelSection> sections;
+    for (size_t index = 0u; index < SectionCount; ++index) {
+      PrimeStage::ParallelSection section;
+      section.prepare = [&widths, &prepared, index]() {
+        widths[index] = 10.0f * static_cast<float>(index + 1u);
+        prepared.fetch_add(1, std::memory_order_relaxed);
+      };
+      section.build = [&widths, &built, index](PrimeStage::UiNode& parent) {
+        PrimeStage::PanelSpec panel;
+        panel.size.preferredWidth = widths[index];
+        panel.size.preferredHeight = 10.0f;
+        built.push_back(parent.createPanel(panel).nodeId());
+      };
+      sections.push_back(std::move(section));
+    }
+    root.prepareInParallel(sections);
+  };
+
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(prepared.load() == static_cast<int>(SectionCount));
+  REQUIRE(built.size() == SectionCount);
+  PrimeFrame::Node const* rootNode = app.frame().getNode(app.frame().roots().front());
+  REQUIRE(rootNode != nullptr);
+  REQUIRE(rootNode->children.size() == SectionCount);
+  for (size_t index = 0u; index < SectionCount; ++index) {
+    CHECK(rootNode->children[index] == built[index]);
+    PrimeFrame::Node const* panel = app.frame().getNode(built[index]);
+    REQUIRE(panel != nullptr);
+    REQUIRE(panel->sizeHint.width.preferred.has_value());
+    CHECK(*panel->sizeHint.width.preferred == doctest::Approx(widths[index]));
+  }
+}
+
+TEST_CASE("BuildTaskPool runs every task and rethrows the first failure") {
+  PrimeStage::Internal::BuildTaskPool pool(2u);
+  std::array<std::atomic<int>, 16> hits{};
+  pool.run(hits.size(), [&hits](size_t index) { hits[index].fetch_add(1, std::memory_order_relaxed); });
+  for (std::atomic<int> const& hit : hits) {
+    CHECK(hit.load() == 1);
+  }
+
+  std::atomic<int> completed{0};
+  CHECK_THROWS_AS(pool.run(8u,
+                           [&completed](size_t index) {
+                             if (index == 3u) {
+                               throw std::runtime_error("prepare failed");
+                             }
+                             completed.fetch_add(1, std::memory_order_relaxed);
+                           }),
+                  std::runtime_error);
+  CHECK(completed.load() == 7);
+
+  pool.resize(0u);
+  CHECK(pool.workerCount() == 0u);
+  int serial = 0;
+  pool.run(4u, [&serial](size_t) { serial += 1; });
+  CHECK(serial == 4);
+}
+
+TEST_CASE("App rebuilds resolve text styles through one compiled table per rebuild") {
+  PrimeStage::App app;
+  float builtWidth = 0.0f;
+  float builtLineHeight = 0.0f;
+  auto rebuild = [&](PrimeStage::UiNode root) {
+    for (int index = 0; index < 32; ++index) {
+      PrimeStage::LabelSpec label;
+      label.text = "Compiled style";
+      root.createLabel(label);
+    }
+    builtWidth = PrimeStage::measureTextWidth(root.frame(), 0u, "Compiled style");
+    builtLineHeight = PrimeStage::textLineHeight(root.frame(), 0u);
+  };
+
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(app.themeStyles().compileCount() == 1u);
+  CHECK(builtWidth == doctest::Approx(PrimeStage::measureTextWidth(app.frame(), 0u, "Compiled style")));
+  CHECK(builtLineHeight == doctest::Approx(PrimeStage::textLineHeight(app.frame(), 0u)));
+  CHECK(builtLineHeight > 0.0f);
+
+  app.lifecycle().requestRebuild();
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(app.themeStyles().compileCount() == 2u);
+}
+
+TEST_CASE("App setTheme swaps colors without a rebuild and keeps the theme across rebuilds") {
+  PrimeStage::App app;
+  PrimeFrame::NodeId labelId{};
+  auto rebuild = [&](PrimeStage::UiNode root) {
+    PrimeStage::LabelSpec label;
+    label.text = "Themed";
+    labelId = root.createLabel(label).nodeId();
+  };
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(app.runLayoutIfNeeded());
+  app.markFramePresented();
+  PrimeFrame::LayoutOut const* labelOut = app.layout().get(labelId);
+  REQUIRE(labelOut != nullptr);
+  float smallWidth = labelOut->absW;
+  float smallHeight = labelOut->absH;
+
+  PrimeFrame::Theme const* current = app.frame().getTheme(PrimeFrame::DefaultThemeId);
+  REQUIRE(current != nullptr);
+  REQUIRE_FALSE(current->palette.empty());
+  PrimeFrame::Theme dark = *current;
+  dark.palette[0] = PrimeFrame::Color{0.9f, 0.1f, 0.2f, 1.0f};
+  PrimeFrame::NodeId before = labelId;
+
+  CHECK_FALSE(app.setTheme(dark));
+  CHECK_FALSE(app.lifecycle().rebuildPending());
+  CHECK_FALSE(app.lifecycle().layoutPending());
+  CHECK(app.lifecycle().framePending());
+  CHECK(app.frame().getNode(before) != nullptr);
+  current = app.frame().getTheme(PrimeFrame::DefaultThemeId);
+  REQUIRE(current != nullptr);
+  CHECK(current->palette[0].r == doctest::Approx(0.9f));
+
+  PrimeFrame::Theme large = dark;
+  REQUIRE_FALSE(large.textStyles.empty());
+  large.textStyles[0].size = 28.0f;
+  CHECK(app.setTheme(large));
+  // Labels measured their text at build time, so the new size needs a rebuild.
+  CHECK(app.lifecycle().rebuildPending());
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  CHECK(app.runLayoutIfNeeded());
+  labelOut = app.layout().get(labelId);
+  REQUIRE(labelOut != nullptr);
+  CHECK(labelOut->absW > smallWidth);
+  CHECK(labelOut->absH > smallHeight);
+
+  app.lifecycle().requestRebuild();
+  CHECK(app.runRebuildIfNeeded(rebuild));
+  current = app.frame().getTheme(PrimeFrame::DefaultThemeId);
+  REQUIRE(current != nullptr);
+  CHECK(current->textStyles[0].size == doctest::Approx(28.0f));
+  CHECK(current->palette[0].r == doctest::Approx(0.9f));
+}
+
+TEST_CASE("App setTheme patches unreadable color swaps and survives a background rebuild") {
+  PrimeStage::App app;
+  CHECK(app.runRebuildIfNeeded([](PrimeStage::UiNode root) { root.label("Themed"); }));
+  app.markFramePresented();
+
+  PrimeFrame::Theme const* current = app.frame().getTheme(PrimeFrame::DefaultThemeId);
+  REQUIRE(current != nullptr);
+  REQUIRE_FALSE(current->rectStyles.empty());
+  REQUIRE_FALSE(current->textStyles.empty());
+  PrimeFrame::Theme unreadable = *current;
+  // Default text drawn in the default fill color.
+  unreadable.textStyles[0].color = unreadable.rectStyles[0].fill;
+  CHECK_FALSE(app.setTheme(unreadable));
+  current = app.frame().getTheme(PrimeFrame::DefaultThemeId);
+  REQUIRE(current != nullptr);
+  CHECK(current->textStyles[0].color != current->rectStyles[0].fill);
+
+  app.lifecycle().requestRebuild();
+  CHECK(app.startBackgroundRebuild([](PrimeStage::UiNode root) { root.label("Rebuilt"); }));
+  PrimeFrame::Theme accent = *current;
+  accent.palette[0] = PrimeFrame::Color{0.2f, 0.6f, 0.3f, 1.0f};
+  CHECK_FALSE(app.setTheme(accent));
+  while (!app.commitBackgroundRebuild()) {
+    std::this_thread::yield();
+  }
+  current = app.frame().getTheme(PrimeFrame::DefaultThemeId);
+  REQUIRE(current != nullptr);
+  CHECK(current->palette[0].g == doctest::Approx(0.6f));
+}
+
+TEST_CASE("App widgets share one focus ring positioned from layout at render time") {
+  PrimeStage::ButtonSpec button;
+  button.label = "Field";
+  button.size.preferredWidth = 120.0f;
+  button.size.preferredHeight = 24.0f;
+
+  PrimeFrame::Frame standalone;
+  PrimeFrame::NodeId standaloneRoot = standalone.createNode();
+  standalone.addRoot(standaloneRoot);
+  PrimeFrame::NodeId standaloneButton =
+      PrimeStage::UiNode(standalone, standaloneRoot, true).createButton(button).nodeId();
+  PrimeFrame::Node const* standaloneNode = standalone.getNode(standaloneButton);
+  REQUIRE(standaloneNode != nullptr);
+
+  PrimeStage::App app;
+  app.setSurfaceMetrics(640u, 480u, 1.0f);
+  std::vector<PrimeStage::WidgetFocusHandle> handles;
+  std::vector<PrimeFrame::NodeId> nodes;
+  CHECK(app.runRebuildIfNeeded([&](PrimeStage::UiNode root) {
+    PrimeStage::StackSpec column;
+    column.size.stretchX = 1.0f;
+    column.size.stretchY = 1.0f;
+    PrimeStage::UiNode stack = root.createVerticalStack(column);
+    for (int index = 0; index < 16; ++index) {
+      PrimeStage::UiNode field = stack.createButton(button);
+      handles.push_back(field.focusHandle());
+      nodes.push_back(field.nodeId());
+    }
+  }));
+  CHECK(app.runLayoutIfNeeded());
+
+  // Widgets built by the App carry no per-widget overlay node.
+  for (PrimeFrame::NodeId nodeId : nodes) {
+    PrimeFrame::Node const* node = app.frame().getNode(nodeId);
+    REQUIRE(node != nullptr);
+    CHECK(node->children.size() + 1u == standaloneNode->children.size());
+  }
+  CHECK_FALSE(app.focusRing().target().has_value());
+
+  std::vector<PrimeFrame::DrawCommand> ring;
+  app.focusRing().appendDrawCommands(app.frame(), app.layout(), app.focus().focusedNode(), ring);
+  CHECK(ring.empty());
+
+  REQUIRE(app.focusWidget(handles[3]));
+  REQUIRE(app.focusRing().target().has_value());
+  CHECK(app.focusRing().target()->node == nodes[3]);
+  app.focusRing().appendDrawCommands(app.frame(), app.layout(), app.focus().focusedNode(), ring);
+  REQUIRE(ring.size() == 4u);
+  PrimeFrame::LayoutOut const* out = app.layout().get(nodes[3]);
+  REQUIRE(out != nullptr);
+  CHECK(ring.front().x0 == static_cast<int>(std::lround(out->absX)));
+  CHECK(ring.front().y0 == static_cast<int>(std::lround(out->absY)));
+  CHECK(ring.front().rectStyle.opacity > 0.0f);
+
+  REQUIRE(app.focusWidget(handles[9]));
+  CHECK(app.focusRing().target()->node == nodes[9]);
+  ring.clear();
+  app.focusRing().appendDrawCommands(app.frame(), app.layout(), app.focus().focusedNode(), ring);
+  REQUIRE(ring.size() == 4u);
+  out = app.layout().get(nodes[9]);
+  REQUIRE(out != nullptr);
+  CHECK(ring.front().y0 == static_cast<int>(std::lround(out->absY)));
+}
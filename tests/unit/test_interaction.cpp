@@ -6,6 +6,7 @@
 
 #include "third_party/doctest.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -3503,6 +3504,71 @@ TEST_CASE("PrimeStage tree view scrolls with mouse wheel when scroll bar is disa
   CHECK(lastScroll.offset > 0.0f);
 }
 
+TEST_CASE("PrimeStage tree view hit tests hover again after scrolling under the pointer") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 240.0f, 140.0f);
+
+  PrimeStage::TreeViewSpec spec;
+  spec.size.preferredWidth = 200.0f;
+  spec.size.preferredHeight = 80.0f;
+  spec.rowStartY = 0.0f;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.rowStartX = 8.0f;
+  spec.rowWidthInset = 0.0f;
+  spec.rowStyle = 331u;
+  spec.rowAltStyle = 332u;
+  spec.hoverStyle = 333u;
+  spec.selectionStyle = 334u;
+  spec.selectionAccentStyle = 335u;
+  spec.textStyle = 431u;
+  spec.selectedTextStyle = 432u;
+  spec.showScrollBar = false;
+  spec.scrollBar.enabled = false;
+  for (int index = 0; index < 8; ++index) {
+    spec.nodes.push_back(PrimeStage::TreeNode{"Row " + std::to_string(index)});
+  }
+
+  int hoverRow = -2;
+  spec.callbacks.onHoverChanged = [&](int row) { hoverRow = row; };
+
+  PrimeStage::UiNode tree = root.createTreeView(spec);
+  PrimeFrame::LayoutOutput layout = layoutFrame(frame, 240.0f, 140.0f);
+  PrimeFrame::LayoutOut const* out = layout.get(tree.nodeId());
+  REQUIRE(out != nullptr);
+
+  PrimeFrame::EventRouter router;
+  float pointerX = out->absX + spec.rowStartX + 32.0f;
+  float pointerY = out->absY + 30.0f;
+  router.dispatch(makePointerEvent(PrimeFrame::EventType::PointerMove, 1, pointerX, pointerY),
+                  frame,
+                  layout);
+  CHECK(hoverRow == 1);
+
+  // The rows slide under a stationary pointer: 30 + 40 lands in row 3, not the recycled row 1.
+  PrimeFrame::Event scroll;
+  scroll.type = PrimeFrame::EventType::PointerScroll;
+  scroll.x = pointerX;
+  scroll.y = pointerY;
+  scroll.scrollY = 40.0f;
+  router.dispatch(scroll, frame, layout);
+  CHECK(hoverRow == 3);
+
+  router.dispatch(makePointerEvent(PrimeFrame::EventType::PointerMove,
+                                   1,
+                                   out->absX - 10.0f,
+                                   out->absY - 10.0f),
+                  frame,
+                  layout);
+  CHECK(hoverRow == -1);
+  hoverRow = -2;
+  scroll.scrollY = -20.0f;
+  scroll.x = out->absX + 12.0f;
+  scroll.y = out->absY + 12.0f;
+  router.dispatch(scroll, frame, layout);
+  CHECK(hoverRow == -2);
+}
+
 TEST_CASE("PrimeStage vertical slider maps top to 1 and bottom to 0") {
   PrimeFrame::Frame frame;
   PrimeStage::UiNode root = createRoot(frame, 120.0f, 160.0f);
@@ -3853,6 +3919,502 @@ TEST_CASE("PrimeStage table callbacks keep row text alive for short-lived source
   CHECK(clickedCells[1] == "One");
 }
 
+TEST_CASE("PrimeStage list selection reports item text after the source buffers change") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 320.0f, 180.0f);
+
+  std::vector<std::string> sourceItems = {"Alpha", "Beta", "Gamma"};
+  PrimeStage::ListSpec spec;
+  spec.items = {sourceItems[0], sourceItems[1], sourceItems[2]};
+  spec.size.preferredWidth = 220.0f;
+  spec.size.preferredHeight = 96.0f;
+  spec.rowHeight = 24.0f;
+  spec.rowGap = 0.0f;
+
+  int selectedRow = -1;
+  std::string selectedItem;
+  spec.callbacks.onSelect = [&](PrimeStage::ListRowInfo const& info) {
+    selectedRow = info.rowIndex;
+    selectedItem = std::string(info.item);
+  };
+
+  PrimeStage::UiNode list = root.createList(spec);
+  spec.items.clear();
+  sourceItems = {"omega", "zeta", "eta"};
+
+  PrimeFrame::NodeId callbackNodeId = findFirstNodeWithOnEventInSubtree(frame, list.nodeId());
+  REQUIRE(callbackNodeId.isValid());
+  PrimeFrame::LayoutOutput layout = layoutFrame(frame, 320.0f, 180.0f);
+  PrimeFrame::LayoutOut const* callbackOut = layout.get(callbackNodeId);
+  REQUIRE(callbackOut != nullptr);
+
+  float clickX = callbackOut->absX + callbackOut->absW * 0.5f;
+  float clickY = callbackOut->absY + spec.rowHeight * 1.5f;
+  PrimeFrame::EventRouter router;
+  PrimeFrame::FocusManager focus;
+  router.dispatch(makePointerEvent(PrimeFrame::EventType::PointerDown, 1, clickX, clickY),
+                  frame,
+                  layout,
+                  &focus);
+  CHECK(selectedRow == 1);
+  CHECK(selectedItem == "Beta");
+
+  focus.setFocus(frame, layout, list.nodeId());
+  router.dispatch(makeKeyDownEvent(PrimeStage::KeyCode::End), frame, layout, &focus);
+  CHECK(selectedRow == 2);
+  CHECK(selectedItem == "Gamma");
+}
+
+TEST_CASE("PrimeStage virtualized table recycles rows and keeps keyboard selection") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 240.0f, 140.0f);
+
+  std::vector<std::string> names;
+  names.reserve(10000u);
+  for (int index = 0; index < 10000; ++index) {
+    names.push_back("Row " + std::to_string(index));
+  }
+
+  PrimeStage::TableSpec spec;
+  spec.columns = {{"Name", 160.0f, 0u, 0u}};
+  for (std::string const& name : names) {
+    spec.rows.push_back({name});
+  }
+  spec.size.preferredWidth = 220.0f;
+  spec.size.preferredHeight = 120.0f;
+  spec.headerInset = 0.0f;
+  spec.headerHeight = 0.0f;
+  spec.showHeaderDividers = false;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.rowStyle = 371u;
+  spec.rowAltStyle = 372u;
+  spec.selectionStyle = 373u;
+  spec.virtualized = true;
+  spec.overscanRows = 2;
+
+  int selected = -1;
+  std::string selectedName;
+  spec.callbacks.onSelect = [&](PrimeStage::TableRowInfo const& info) {
+    selected = info.rowIndex;
+    selectedName = info.row.empty() ? std::string{} : std::string(info.row.front());
+  };
+  PrimeStage::TableScrollInfo lastScroll;
+  spec.callbacks.onScrollChanged = [&](PrimeStage::TableScrollInfo const& info) {
+    lastScroll = info;
+  };
+
+  PrimeStage::UiNode table = root.createTable(spec);
+
+  PrimeFrame::Node const* rowsNode = nullptr;
+  std::vector<PrimeFrame::NodeId> pending = {table.nodeId()};
+  while (!pending.empty() && !rowsNode) {
+    PrimeFrame::Node const* node = frame.getNode(pending.back());
+    pending.pop_back();
+    if (!node) {
+      continue;
+    }
+    if (node->isViewport) {
+      rowsNode = node;
+    }
+    pending.insert(pending.end(), node->children.begin(), node->children.end());
+  }
+  REQUIRE(rowsNode != nullptr);
+  // Six visible rows, one straddling row and two overscan rows on each side.
+  CHECK(rowsNode->children.size() == 11u);
+
+  auto rowNodeAt = [&](int rowIndex) {
+    for (PrimeFrame::NodeId child : rowsNode->children) {
+      PrimeFrame::Node const* rowNode = frame.getNode(child);
+      if (rowNode && rowNode->visible &&
+          rowNode->localY == doctest::Approx(static_cast<float>(rowIndex) * 20.0f)) {
+        return child;
+      }
+    }
+    return PrimeFrame::NodeId{};
+  };
+
+  PrimeFrame::LayoutOutput layout = layoutFrame(frame, 240.0f, 140.0f);
+  PrimeFrame::EventRouter router;
+  PrimeFrame::FocusManager focus;
+  focus.setFocus(frame, layout, table.nodeId());
+
+  router.dispatch(makeKeyDownEvent(PrimeStage::KeyCode::End), frame, layout, &focus);
+  CHECK(selected == 9999);
+  CHECK(selectedName == "Row 9999");
+  CHECK(lastScroll.offset == doctest::Approx(10000.0f * 20.0f - 120.0f));
+  CHECK(lastScroll.offset == doctest::Approx(lastScroll.maxOffset));
+  PrimeFrame::NodeId lastRowId = rowNodeAt(9999);
+  REQUIRE(lastRowId.isValid());
+  CHECK(findRectPrimitiveByTokenInSubtree(frame, lastRowId, spec.selectionStyle) != nullptr);
+  CHECK(rowsNode->children.size() == 11u);
+
+  router.dispatch(makeKeyDownEvent(PrimeStage::KeyCode::Home), frame, layout, &focus);
+  CHECK(selected == 0);
+  CHECK(lastScroll.offset == doctest::Approx(0.0f));
+  router.dispatch(makeKeyDownEvent(PrimeStage::KeyCode::Down), frame, layout, &focus);
+  CHECK(selected == 1);
+  router.dispatch(makeKeyDownEvent(PrimeStage::KeyCode::Up), frame, layout, &focus);
+  CHECK(selected == 0);
+
+  PrimeFrame::LayoutOut const* tableOut = layout.get(table.nodeId());
+  REQUIRE(tableOut != nullptr);
+  PrimeFrame::Event wheel;
+  wheel.type = PrimeFrame::EventType::PointerScroll;
+  wheel.x = tableOut->absX + 40.0f;
+  wheel.y = tableOut->absY + 40.0f;
+  wheel.scrollY = 200.0f;
+  router.dispatch(wheel, frame, layout, &focus);
+  CHECK(lastScroll.offset == doctest::Approx(200.0f));
+
+  // The row scrolled to the top is served by a recycled node and selects its own index.
+  layout = layoutFrame(frame, 240.0f, 140.0f);
+  PrimeFrame::NodeId topRowId = rowNodeAt(10);
+  REQUIRE(topRowId.isValid());
+  PrimeFrame::LayoutOut const* topRowOut = layout.get(topRowId);
+  REQUIRE(topRowOut != nullptr);
+  float clickX = topRowOut->absX + 20.0f;
+  float clickY = topRowOut->absY + topRowOut->absH * 0.5f;
+  router.dispatch(makePointerEvent(PrimeFrame::EventType::PointerDown, 1, clickX, clickY),
+                  frame,
+                  layout,
+                  &focus);
+  CHECK(selected == 10);
+  CHECK(selectedName == "Row 10");
+  CHECK(findRectPrimitiveByTokenInSubtree(frame, topRowId, spec.selectionStyle) != nullptr);
+}
+
+TEST_CASE("PrimeStage table data source reads bound rows in place and reports row keys") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 240.0f, 140.0f);
+
+  std::vector<std::string> names;
+  for (int index = 0; index < 1000; ++index) {
+    names.push_back("Name " + std::to_string(index));
+  }
+  int cellReads = 0;
+
+  PrimeStage::TableSpec spec;
+  spec.columns = {{"Name", 120.0f, 0u, 0u}, {"Kind", 80.0f, 0u, 0u}};
+  spec.size.preferredWidth = 220.0f;
+  spec.size.preferredHeight = 120.0f;
+  spec.headerInset = 0.0f;
+  spec.headerHeight = 0.0f;
+  spec.showHeaderDividers = false;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.selectionStyle = 381u;
+  spec.virtualized = true;
+  spec.overscanRows = 2;
+  spec.dataSource.rowCount = [&]() { return names.size(); };
+  spec.dataSource.cell = [&](size_t row, size_t column) -> std::string_view {
+    cellReads += 1;
+    return column == 0u ? std::string_view(names[row]) : std::string_view("Item");
+  };
+  spec.dataSource.rowKey = [](size_t row) {
+    return static_cast<PrimeStage::WidgetIdentityId>(5000u + row);
+  };
+
+  int selected = -1;
+  std::vector<std::string> selectedCells;
+  PrimeStage::WidgetIdentityId selectedKey = PrimeStage::InvalidWidgetIdentityId;
+  spec.callbacks.onSelect = [&](PrimeStage::TableRowInfo const& info) {
+    selected = info.rowIndex;
+    selectedKey = info.key;
+    selectedCells.assign(info.row.begin(), info.row.end());
+  };
+
+  PrimeStage::UiNode table = root.createTable(spec);
+  // Only the eleven pooled rows were read, not the thousand in the model.
+  CHECK(cellReads == 11 * 2);
+
+  PrimeFrame::LayoutOutput layout = layoutFrame(frame, 240.0f, 140.0f);
+  PrimeFrame::EventRouter router;
+  PrimeFrame::FocusManager focus;
+  focus.setFocus(frame, layout, table.nodeId());
+
+  // The model is read at selection time, so edits made after the build are reported.
+  names[999] = "Renamed";
+  router.dispatch(makeKeyDownEvent(PrimeStage::KeyCode::End), frame, layout, &focus);
+  CHECK(selected == 999);
+  CHECK(selectedKey == 5999u);
+  REQUIRE(selectedCells.size() == 2u);
+  CHECK(selectedCells[0] == "Renamed");
+  CHECK(selectedCells[1] == "Item");
+}
+
+TEST_CASE("PrimeStage table copies data source cells that only live until the next call") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 240.0f, 140.0f);
+
+  // Every call overwrites the text the previous view pointed into.
+  std::string formatted;
+  PrimeStage::TableSpec spec;
+  spec.columns = {{"Name", 120.0f, 0u, 0u}, {"Kind", 80.0f, 0u, 0u}};
+  spec.size.preferredWidth = 220.0f;
+  spec.size.preferredHeight = 120.0f;
+  spec.headerInset = 0.0f;
+  spec.headerHeight = 0.0f;
+  spec.showHeaderDividers = false;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.virtualized = true;
+  spec.dataSource.rowCount = []() { return size_t{100}; };
+  spec.dataSource.cell = [&](size_t row, size_t column) -> std::string_view {
+    formatted.assign(column == 0u ? "Name " : "Kind ");
+    formatted.append(std::to_string(row));
+    return formatted;
+  };
+
+  std::vector<std::string> selectedCells;
+  spec.callbacks.onSelect = [&](PrimeStage::TableRowInfo const& info) {
+    selectedCells.assign(info.row.begin(), info.row.end());
+  };
+
+  PrimeStage::UiNode table = root.createTable(spec);
+  std::vector<std::string> texts;
+  std::vector<PrimeFrame::NodeId> pending = {table.nodeId()};
+  while (!pending.empty()) {
+    PrimeFrame::Node const* node = frame.getNode(pending.back());
+    pending.pop_back();
+    if (!node) {
+      continue;
+    }
+    for (PrimeFrame::PrimitiveId primId : node->primitives) {
+      PrimeFrame::Primitive const* prim = frame.getPrimitive(primId);
+      if (prim && prim->type == PrimeFrame::PrimitiveType::Text) {
+        texts.push_back(prim->textBlock.text);
+      }
+    }
+    pending.insert(pending.end(), node->children.begin(), node->children.end());
+  }
+  CHECK(std::find(texts.begin(), texts.end(), "Name 3") != texts.end());
+  CHECK(std::find(texts.begin(), texts.end(), "Kind 3") != texts.end());
+
+  PrimeFrame::LayoutOutput layout = layoutFrame(frame, 240.0f, 140.0f);
+  PrimeFrame::EventRouter router;
+  PrimeFrame::FocusManager focus;
+  focus.setFocus(frame, layout, table.nodeId());
+  router.dispatch(makeKeyDownEvent(PrimeStage::KeyCode::End), frame, layout, &focus);
+  REQUIRE(selectedCells.size() == 2u);
+  CHECK(selectedCells[0] == "Name 99");
+  CHECK(selectedCells[1] == "Kind 99");
+}
+
+TEST_CASE("PrimeStage table width cache measures only changed rows between revisions") {
+  std::vector<std::string> names;
+  for (int index = 0; index < 2000; ++index) {
+    names.push_back("Row " + std::to_string(index));
+  }
+  PrimeStage::TableColumnWidthCache widthCache;
+  PrimeStage::TableAutoWidthPolicy policy;
+
+  auto build = [&](uint64_t revision) {
+    PrimeFrame::Frame frame;
+    PrimeStage::UiNode root = createRoot(frame, 640.0f, 480.0f);
+    PrimeStage::TableSpec spec;
+    spec.columns = {{"Name", 0.0f, 0u, 0u}};
+    spec.size.preferredHeight = 120.0f;
+    spec.virtualized = true;
+    spec.dataSource.rowCount = [&]() { return names.size(); };
+    spec.dataSource.cell = [&](size_t row, size_t) -> std::string_view { return names[row]; };
+    spec.widthCache = &widthCache;
+    spec.modelRevision = revision;
+    spec.autoWidth = policy;
+    PrimeStage::UiNode table = root.createTable(spec);
+    PrimeFrame::Node const* node = frame.getNode(table.nodeId());
+    REQUIRE(node != nullptr);
+    REQUIRE(node->sizeHint.width.preferred.has_value());
+    return node->sizeHint.width.preferred.value();
+  };
+
+  float initialWidth = build(1u);
+  CHECK(widthCache.measuredCellCount() == names.size());
+  CHECK(widthCache.revision() == 1u);
+
+  // Same revision: the cached widths are reused without measuring a cell.
+  CHECK(build(1u) == doctest::Approx(initialWidth));
+  CHECK(widthCache.measuredCellCount() == 0u);
+
+  // Inserted rows are measured on their own and can only widen the column.
+  names.insert(names.begin() + 10, 2, "A much longer inserted row");
+  widthCache.rowsInserted(10u, 2u);
+  float widened = build(2u);
+  CHECK(widthCache.measuredCellCount() == 2u);
+  CHECK(widened > initialWidth);
+
+  // Updating a row other than the widest one measures just that row.
+  names[500] = "Short";
+  widthCache.rowsUpdated(500u, 1u);
+  CHECK(build(3u) == doctest::Approx(widened));
+  CHECK(widthCache.measuredCellCount() == 1u);
+
+  // Removing the widest rows forces a full pass, which finds the narrower width again.
+  names.erase(names.begin() + 10, names.begin() + 12);
+  widthCache.rowsRemoved(10u, 2u);
+  CHECK(build(4u) == doctest::Approx(initialWidth));
+  CHECK(widthCache.measuredCellCount() == names.size());
+
+  // A revision change without a report measures everything.
+  build(5u);
+  CHECK(widthCache.measuredCellCount() == names.size());
+
+  // Sampling measures the first rows and the longest ones by byte count.
+  names[1500] = "The longest row in the sampled table";
+  policy.sampleRows = 100u;
+  policy.longestCells = 4u;
+  float sampled = build(6u);
+  CHECK(widthCache.measuredCellCount() == 104u);
+  CHECK(sampled > initialWidth);
+}
+
+TEST_CASE("PrimeStage table rows place cell text and dividers as primitives on one node") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 480.0f, 200.0f);
+
+  PrimeStage::TableSpec spec;
+  spec.columns = {{"Name", 100.0f, 0u, 0u}, {"Kind", 100.0f, 0u, 0u}, {"Size", 100.0f, 0u, 0u}};
+  spec.rows = {{"a.txt", "Text", "1 KB"}, {"b.png", "Image", "4 KB"}};
+  spec.size.preferredWidth = 302.0f;
+  spec.size.preferredHeight = 120.0f;
+  spec.rowHeight = 24.0f;
+  spec.cellPaddingX = 8.0f;
+  spec.headerPaddingX = 6.0f;
+  spec.dividerStyle = 77u;
+  PrimeStage::UiNode table = root.createTable(spec);
+
+  auto findNodeWithText = [&](std::string_view text) {
+    std::vector<PrimeFrame::NodeId> pending = {table.nodeId()};
+    while (!pending.empty()) {
+      PrimeFrame::NodeId nodeId = pending.back();
+      pending.pop_back();
+      PrimeFrame::Node const* node = frame.getNode(nodeId);
+      if (!node) {
+        continue;
+      }
+      for (PrimeFrame::PrimitiveId primId : node->primitives) {
+        PrimeFrame::Primitive const* prim = frame.getPrimitive(primId);
+        if (prim && prim->type == PrimeFrame::PrimitiveType::Text && prim->textBlock.text == text) {
+          return nodeId;
+        }
+      }
+      pending.insert(pending.end(), node->children.begin(), node->children.end());
+    }
+    return PrimeFrame::NodeId{};
+  };
+  auto primitivesOf = [&](PrimeFrame::NodeId nodeId, PrimeFrame::PrimitiveType type) {
+    std::vector<PrimeFrame::Primitive const*> out;
+    if (PrimeFrame::Node const* node = frame.getNode(nodeId)) {
+      for (PrimeFrame::PrimitiveId primId : node->primitives) {
+        PrimeFrame::Primitive const* prim = frame.getPrimitive(primId);
+        if (prim && prim->type == type) {
+          out.push_back(prim);
+        }
+      }
+    }
+    return out;
+  };
+
+  PrimeFrame::NodeId rowId = findNodeWithText("Image");
+  REQUIRE(rowId.isValid());
+  CHECK(findNodeWithText("b.png") == rowId);
+  CHECK(findNodeWithText("4 KB") == rowId);
+  PrimeFrame::Node const* row = frame.getNode(rowId);
+  REQUIRE(row != nullptr);
+  CHECK(row->children.empty());
+
+  std::vector<PrimeFrame::Primitive const*> texts =
+      primitivesOf(rowId, PrimeFrame::PrimitiveType::Text);
+  REQUIRE(texts.size() == 3u);
+  CHECK(texts[0]->offsetX == doctest::Approx(8.0f));
+  CHECK(texts[1]->offsetX == doctest::Approx(109.0f));
+  CHECK(texts[2]->offsetX == doctest::Approx(210.0f));
+  CHECK(texts[1]->width == doctest::Approx(84.0f));
+
+  // Background first, then one divider per column gap.
+  std::vector<PrimeFrame::Primitive const*> rects =
+      primitivesOf(rowId, PrimeFrame::PrimitiveType::Rect);
+  REQUIRE(rects.size() == 3u);
+  CHECK(rects[1]->rect.token == 77u);
+  CHECK(rects[1]->offsetX == doctest::Approx(100.0f));
+  CHECK(rects[1]->width == doctest::Approx(1.0f));
+  CHECK(rects[1]->height == doctest::Approx(24.0f));
+  CHECK(rects[2]->offsetX == doctest::Approx(201.0f));
+
+  PrimeFrame::NodeId headerId = findNodeWithText("Kind");
+  REQUIRE(headerId.isValid());
+  CHECK(frame.getNode(headerId)->children.empty());
+  std::vector<PrimeFrame::Primitive const*> labels =
+      primitivesOf(headerId, PrimeFrame::PrimitiveType::Text);
+  REQUIRE(labels.size() == 3u);
+  CHECK(labels[1]->offsetX == doctest::Approx(107.0f));
+}
+
+TEST_CASE("PrimeStage table resolves clicked rows on the rows node without row callbacks") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 240.0f, 200.0f);
+
+  PrimeStage::TableSpec spec;
+  spec.columns = {{"Name", 160.0f, 0u, 0u}};
+  spec.rows = {{"Alpha"}, {"Beta"}, {"Gamma"}, {"Delta"}, {"Epsilon"}};
+  spec.size.preferredWidth = 200.0f;
+  spec.size.preferredHeight = 160.0f;
+  spec.headerInset = 0.0f;
+  spec.headerHeight = 0.0f;
+  spec.showHeaderDividers = false;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 4.0f;
+  spec.selectionStyle = 391u;
+
+  int selected = -1;
+  int selectCount = 0;
+  spec.callbacks.onSelect = [&](PrimeStage::TableRowInfo const& info) {
+    selected = info.rowIndex;
+    selectCount += 1;
+  };
+
+  PrimeStage::UiNode table = root.createTable(spec);
+  PrimeFrame::NodeId rowsId = findFirstNodeWithOnEventInSubtree(frame, table.nodeId());
+  REQUIRE(rowsId.isValid());
+  PrimeFrame::Node const* rowsNode = frame.getNode(rowsId);
+  REQUIRE(rowsNode != nullptr);
+  REQUIRE(rowsNode->children.size() == spec.rows.size());
+  for (PrimeFrame::NodeId rowId : rowsNode->children) {
+    PrimeFrame::Node const* rowNode = frame.getNode(rowId);
+    REQUIRE(rowNode != nullptr);
+    CHECK(rowNode->callbacks == PrimeFrame::InvalidCallbackId);
+    CHECK_FALSE(rowNode->hitTestVisible);
+  }
+
+  PrimeFrame::LayoutOutput layout = layoutFrame(frame, 240.0f, 200.0f);
+  PrimeFrame::LayoutOut const* rowsOut = layout.get(rowsId);
+  REQUIRE(rowsOut != nullptr);
+  PrimeFrame::EventRouter router;
+  auto clickAt = [&](float contentY) {
+    router.dispatch(makePointerEvent(PrimeFrame::EventType::PointerDown,
+                                     1,
+                                     rowsOut->absX + 20.0f,
+                                     rowsOut->absY + contentY),
+                    frame,
+                    layout);
+  };
+
+  clickAt(3.0f * 24.0f + 10.0f);
+  CHECK(selected == 3);
+  CHECK(selectCount == 1);
+
+  // The gap below a row and the space past the last row select nothing.
+  clickAt(24.0f + 22.0f);
+  clickAt(5.0f * 24.0f + 10.0f);
+  CHECK(selected == 3);
+  CHECK(selectCount == 1);
+
+  clickAt(24.0f + 19.0f);
+  CHECK(selected == 1);
+  CHECK(findRectPrimitiveByTokenInSubtree(frame, rowsNode->children[1], spec.selectionStyle) !=
+        nullptr);
+}
+
 TEST_CASE("PrimeStage window builder clamps geometry and emits slots") {
   PrimeFrame::Frame frame;
   PrimeStage::UiNode root = createRoot(frame, 640.0f, 480.0f);
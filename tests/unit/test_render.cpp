@@ -367,6 +367,129 @@ TEST_CASE("PrimeStage render status is successful for valid render targets") {
 #endif
 }
 
+TEST_CASE("PrimeStage render pipeline rasterizes frame-independent snapshots off thread") {
+  std::vector<uint8_t> directPixels(96u * 64u * 4u, 0u);
+  PrimeStage::RenderTarget directTarget;
+  directTarget.pixels = std::span<uint8_t>(directPixels);
+  directTarget.width = 96u;
+  directTarget.height = 64u;
+  directTarget.stride = 96u * 4u;
+
+  std::vector<uint8_t> pipelinePixels(96u * 64u * 4u, 0u);
+  PrimeStage::RenderTarget pipelineTarget = directTarget;
+  pipelineTarget.pixels = std::span<uint8_t>(pipelinePixels);
+
+  PrimeStage::RenderPipeline pipeline;
+  CHECK(pipeline.maxQueued() == 1u);
+  PrimeStage::RenderSnapshot snapshot = pipeline.acquireSnapshot();
+  PrimeStage::RenderStatus directStatus;
+  {
+    PrimeFrame::Frame frame = makeRenderableFrame(96.0f, 64.0f);
+    PrimeStage::UiNode root(frame, frame.roots().front(), true);
+    PrimeStage::LabelSpec label;
+    label.text = "Snapshot";
+    root.createLabel(label);
+    PrimeFrame::LayoutOutput layout = layoutFrame(frame, 96.0f, 64.0f);
+    directStatus = PrimeStage::renderFrameToTarget(frame, layout, directTarget, PrimeStage::RenderOptions{});
+    PrimeStage::captureRenderSnapshot(frame, layout, PrimeStage::RenderOptions{}, snapshot);
+  }
+  // The frame is gone; the snapshot owns everything the render thread reads.
+  CHECK_FALSE(snapshot.batch.commands.empty());
+  CHECK_FALSE(snapshot.textStorage.empty());
+
+  PrimeStage::RenderStatus completedStatus;
+  int completions = 0;
+  PrimeStage::RenderStatus submitStatus =
+      pipeline.submit(std::move(snapshot), pipelineTarget, [&](PrimeStage::RenderStatus const& status) {
+        completedStatus = status;
+        completions += 1;
+      });
+  CHECK(submitStatus.ok());
+  pipeline.waitIdle();
+  CHECK(pipeline.pending() == 0u);
+  CHECK(completions == 1);
+  CHECK(completedStatus.code == directStatus.code);
+#if defined(PRIMESTAGE_HAS_PRIMEMANIFEST)
+  CHECK(completedStatus.ok());
+  CHECK(pipelinePixels == directPixels);
+#endif
+
+  PrimeStage::RenderTarget invalidTarget = pipelineTarget;
+  invalidTarget.width = 0u;
+  PrimeStage::RenderStatus invalidStatus =
+      pipeline.submit(pipeline.acquireSnapshot(), invalidTarget, [&](PrimeStage::RenderStatus const&) {
+        completions += 1;
+      });
+  CHECK(invalidStatus.code == PrimeStage::RenderStatusCode::InvalidTargetDimensions);
+  pipeline.waitIdle();
+  CHECK(completions == 1);
+}
+
+TEST_CASE("PrimeStage render snapshot recapture reuses its text buffer") {
+  PrimeFrame::Frame frame = makeRenderableFrame(96.0f, 64.0f);
+  PrimeStage::UiNode root(frame, frame.roots().front(), true);
+  PrimeStage::LabelSpec first;
+  first.text = "First";
+  root.createLabel(first);
+  PrimeStage::LabelSpec second;
+  second.text = "Second";
+  root.createLabel(second);
+  PrimeFrame::LayoutOutput layout = layoutFrame(frame, 96.0f, 64.0f);
+
+  PrimeStage::RenderSnapshot snapshot;
+  PrimeStage::captureRenderSnapshot(frame, layout, PrimeStage::RenderOptions{}, snapshot);
+  char const* buffer = snapshot.textStorage.data();
+  PrimeStage::captureRenderSnapshot(frame, layout, PrimeStage::RenderOptions{}, snapshot);
+  CHECK(snapshot.textStorage.data() == buffer);
+  CHECK(std::string_view(snapshot.textStorage.data(), snapshot.textStorage.size()) ==
+        "FirstSecond");
+
+  std::vector<std::string_view> texts;
+  for (PrimeFrame::DrawCommand const& cmd : snapshot.batch.commands) {
+    if (cmd.type != PrimeFrame::CommandType::Text) {
+      continue;
+    }
+    CHECK(cmd.text.data() >= snapshot.textStorage.data());
+    CHECK(cmd.text.data() + cmd.text.size() <=
+          snapshot.textStorage.data() + snapshot.textStorage.size());
+    texts.push_back(cmd.text);
+  }
+  CHECK(texts == std::vector<std::string_view>{"First", "Second"});
+}
+
+TEST_CASE("PrimeStage render snapshot text survives moving the snapshot") {
+  // Short enough to sit inline in a std::string, where a move would relocate it.
+  PrimeStage::RenderSnapshot captured;
+  {
+    PrimeFrame::Frame frame = makeRenderableFrame(96.0f, 64.0f);
+    PrimeStage::UiNode root(frame, frame.roots().front(), true);
+    PrimeStage::LabelSpec label;
+    label.text = "Hi";
+    root.createLabel(label);
+    PrimeFrame::LayoutOutput layout = layoutFrame(frame, 96.0f, 64.0f);
+    PrimeStage::captureRenderSnapshot(frame, layout, PrimeStage::RenderOptions{}, captured);
+  }
+  // Moved the way App::submitRenderToTarget hands a snapshot to the render queue, then once more
+  // when the queue grows.
+  PrimeStage::RenderSnapshot moved = std::move(captured);
+  std::vector<PrimeStage::RenderSnapshot> queue;
+  queue.push_back(std::move(moved));
+  queue.reserve(queue.capacity() + 4u);
+
+  PrimeStage::RenderSnapshot const& queued = queue.front();
+  std::vector<std::string_view> texts;
+  for (PrimeFrame::DrawCommand const& cmd : queued.batch.commands) {
+    if (cmd.type != PrimeFrame::CommandType::Text) {
+      continue;
+    }
+    CHECK(cmd.text.data() >= queued.textStorage.data());
+    CHECK(cmd.text.data() + cmd.text.size() <=
+          queued.textStorage.data() + queued.textStorage.size());
+    texts.push_back(cmd.text);
+  }
+  CHECK(texts == std::vector<std::string_view>{"Hi"});
+}
+
 TEST_CASE("PrimeStage render overload treats non-positive scale as 1x fallback") {
   PrimeFrame::Frame frame = makeRenderableFrame(96.0f, 64.0f);
   PrimeStage::RenderOptions options;
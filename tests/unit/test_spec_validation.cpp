@@ -1460,7 +1460,8 @@ TEST_CASE("PrimeStage widget-spec sanitization keeps invariants under determinis
     list.rowPaddingX = fuzzFloat(rng, -32.0f, 32.0f);
     list.selectedIndex = fuzzInt(rng, -20, 20);
     list.tabIndex = fuzzInt(rng, -12, 12);
-    PrimeStage::ListSpec normalizedList = PrimeStage::Internal::normalizeListSpec(list);
+    PrimeStage::Internal::NormalizedListSpec normalizedList =
+        PrimeStage::Internal::normalizeListSpec(list);
     checkSanitizedSizeSpec(normalizedList.size);
     CHECK(normalizedList.rowHeight >= 0.0f);
     CHECK(normalizedList.rowGap >= 0.0f);
@@ -1484,7 +1485,8 @@ TEST_CASE("PrimeStage widget-spec sanitization keeps invariants under determinis
     table.cellPaddingX = fuzzFloat(rng, -32.0f, 32.0f);
     table.selectedRow = fuzzInt(rng, -20, 20);
     table.tabIndex = fuzzInt(rng, -12, 12);
-    PrimeStage::TableSpec normalizedTable = PrimeStage::Internal::normalizeTableSpec(table);
+    PrimeStage::Internal::NormalizedTableSpec normalizedTable =
+        PrimeStage::Internal::normalizeTableSpec(table);
     checkSanitizedSizeSpec(normalizedTable.size);
     CHECK(normalizedTable.headerInset >= 0.0f);
     CHECK(normalizedTable.headerHeight >= 0.0f);
@@ -1642,7 +1644,7 @@ TEST_CASE("PrimeStage widget-spec sanitization regression corpus preserves invar
     PrimeStage::ListSpec spec;
     spec.items = {"Alpha", "Beta"};
     spec.selectedIndex = 99;
-    PrimeStage::ListSpec normalized = PrimeStage::Internal::normalizeListSpec(spec);
+    PrimeStage::Internal::NormalizedListSpec normalized = PrimeStage::Internal::normalizeListSpec(spec);
     CHECK(normalized.selectedIndex == -1);
   });
 
@@ -1651,7 +1653,8 @@ TEST_CASE("PrimeStage widget-spec sanitization regression corpus preserves invar
     spec.columns = {{"Name", 0.0f, 0u, 0u}};
     spec.rows = {{"A"}, {"B"}};
     spec.selectedRow = -4;
-    PrimeStage::TableSpec normalized = PrimeStage::Internal::normalizeTableSpec(spec);
+    PrimeStage::Internal::NormalizedTableSpec normalized =
+        PrimeStage::Internal::normalizeTableSpec(spec);
     CHECK(normalized.selectedRow == -1);
   });
 
@@ -5,6 +5,9 @@
 #include "third_party/doctest.h"
 
 #include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
 
 static PrimeStage::UiNode createRoot(PrimeFrame::Frame& frame, float width, float height) {
   PrimeFrame::NodeId rootId = frame.createNode();
@@ -35,12 +38,8 @@ static PrimeFrame::NodeId findVerticalStack(PrimeFrame::Frame const& frame,
 static PrimeFrame::Primitive const* findRectToken(PrimeFrame::Frame const& frame,
                                                   PrimeFrame::Node const& row,
                                                   PrimeFrame::RectStyleToken token) {
-  for (PrimeFrame::NodeId child : row.children) {
-    PrimeFrame::Node const* childNode = frame.getNode(child);
-    if (!childNode || childNode->primitives.empty()) {
-      continue;
-    }
-    PrimeFrame::Primitive const* prim = frame.getPrimitive(childNode->primitives.front());
+  for (PrimeFrame::PrimitiveId primId : row.primitives) {
+    PrimeFrame::Primitive const* prim = frame.getPrimitive(primId);
     if (prim && prim->type == PrimeFrame::PrimitiveType::Rect &&
         prim->rect.token == token) {
       return prim;
@@ -49,6 +48,11 @@ static PrimeFrame::Primitive const* findRectToken(PrimeFrame::Frame const& frame
   return nullptr;
 }
 
+static bool primitiveShown(PrimeFrame::Primitive const& prim) {
+  return !prim.rect.overrideStyle.opacity.has_value() ||
+         prim.rect.overrideStyle.opacity.value() > 0.0f;
+}
+
 TEST_CASE("PrimeStage tree view flattens expanded nodes and selection accent") {
   PrimeFrame::Frame frame;
   PrimeStage::UiNode root = createRoot(frame, 220.0f, 140.0f);
@@ -210,3 +214,192 @@ TEST_CASE("PrimeStage scroll bar thumb pixels clamp to track") {
   CHECK(spec.thumbFraction == doctest::Approx(1.0f));
   CHECK(spec.thumbProgress == doctest::Approx(1.0f));
 }
+
+TEST_CASE("PrimeStage virtualized tree view materializes a viewport-sized row pool") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 220.0f, 140.0f);
+
+  PrimeStage::TreeViewSpec spec;
+  spec.size.preferredWidth = 200.0f;
+  spec.size.preferredHeight = 100.0f;
+  spec.rowHeight = 10.0f;
+  spec.rowGap = 0.0f;
+  spec.rowStartY = 0.0f;
+  spec.showScrollBar = false;
+  spec.virtualized = true;
+  spec.overscanRows = 2;
+  spec.rowStyle = 11u;
+  spec.rowAltStyle = 12u;
+  spec.selectionStyle = 13u;
+  spec.connectorStyle = 17u;
+  spec.textStyle = 1u;
+  spec.selectedTextStyle = 2u;
+
+  std::vector<std::string> labels;
+  labels.reserve(1000);
+  for (int folder = 0; folder < 10; ++folder) {
+    labels.push_back("Folder " + std::to_string(folder));
+    for (int leaf = 0; leaf < 99; ++leaf) {
+      labels.push_back("Leaf " + std::to_string(folder) + "." + std::to_string(leaf));
+    }
+  }
+  size_t labelIndex = 0;
+  for (int folder = 0; folder < 10; ++folder) {
+    PrimeStage::TreeNode folderNode;
+    folderNode.label = labels[labelIndex++];
+    for (int leaf = 0; leaf < 99; ++leaf) {
+      folderNode.children.push_back(PrimeStage::TreeNode{labels[labelIndex++]});
+    }
+    spec.nodes.push_back(std::move(folderNode));
+  }
+
+  PrimeStage::UiNode tree = root.createTreeView(spec);
+  PrimeFrame::Node const* treeNode = frame.getNode(tree.nodeId());
+  REQUIRE(treeNode != nullptr);
+
+  PrimeFrame::Node const* rowsNode = nullptr;
+  for (PrimeFrame::NodeId child : treeNode->children) {
+    PrimeFrame::Node const* childNode = frame.getNode(child);
+    if (childNode && childNode->isViewport) {
+      rowsNode = childNode;
+    }
+  }
+  REQUIRE(rowsNode != nullptr);
+
+  // Ten visible rows, one partially scrolled row and two overscan rows on each side.
+  CHECK(rowsNode->children.size() == 15u);
+  // Pointer hits are resolved once on the rows node rather than by a callback per row.
+  CHECK(rowsNode->callbacks != PrimeFrame::InvalidCallbackId);
+  for (PrimeFrame::NodeId child : rowsNode->children) {
+    PrimeFrame::Node const* rowNode = frame.getNode(child);
+    REQUIRE(rowNode != nullptr);
+    CHECK(rowNode->callbacks == PrimeFrame::InvalidCallbackId);
+    CHECK_FALSE(rowNode->hitTestVisible);
+  }
+
+  PrimeFrame::Node const* secondRow = nullptr;
+  for (PrimeFrame::NodeId child : rowsNode->children) {
+    PrimeFrame::Node const* rowNode = frame.getNode(child);
+    if (rowNode && rowNode->localY == doctest::Approx(10.0f)) {
+      secondRow = rowNode;
+    }
+  }
+  REQUIRE(secondRow != nullptr);
+  CHECK(secondRow->visible);
+
+  std::string rowText;
+  REQUIRE(secondRow->children.size() == 1u);
+  PrimeFrame::Node const* labelNode = frame.getNode(secondRow->children.front());
+  REQUIRE(labelNode != nullptr);
+  REQUIRE(!labelNode->primitives.empty());
+  if (PrimeFrame::Primitive const* prim = frame.getPrimitive(labelNode->primitives.front())) {
+    rowText = prim->textBlock.text;
+  }
+  size_t visibleConnectors = 0u;
+  for (PrimeFrame::PrimitiveId primId : secondRow->primitives) {
+    PrimeFrame::Primitive const* prim = frame.getPrimitive(primId);
+    if (prim && prim->type == PrimeFrame::PrimitiveType::Rect &&
+        prim->rect.token == spec.connectorStyle && primitiveShown(*prim)) {
+      ++visibleConnectors;
+    }
+  }
+  CHECK(rowText == "Leaf 0.0");
+  // Trunk segment from the parent folder plus the link into the row.
+  CHECK(visibleConnectors == 2u);
+}
+
+TEST_CASE("PrimeStage virtualized tree view without a height sizes its pool from the default") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 220.0f, 140.0f);
+
+  PrimeStage::TreeViewSpec spec;
+  spec.size.preferredWidth = 200.0f;
+  spec.rowHeight = 10.0f;
+  spec.rowGap = 0.0f;
+  spec.rowStartY = 0.0f;
+  spec.showScrollBar = false;
+  spec.virtualized = true;
+  spec.overscanRows = 2;
+
+  std::vector<std::string> labels;
+  labels.reserve(1000);
+  for (int i = 0; i < 1000; ++i) {
+    labels.push_back("Leaf " + std::to_string(i));
+  }
+  for (std::string const& label : labels) {
+    spec.nodes.push_back(PrimeStage::TreeNode{label});
+  }
+
+  PrimeStage::UiNode tree = root.createTreeView(spec);
+  PrimeFrame::Node const* treeNode = frame.getNode(tree.nodeId());
+  REQUIRE(treeNode != nullptr);
+  REQUIRE(treeNode->sizeHint.height.preferred.has_value());
+  CHECK(treeNode->sizeHint.height.preferred.value() == doctest::Approx(120.0f));
+
+  PrimeFrame::Node const* rowsNode = nullptr;
+  for (PrimeFrame::NodeId child : treeNode->children) {
+    PrimeFrame::Node const* childNode = frame.getNode(child);
+    if (childNode && childNode->isViewport) {
+      rowsNode = childNode;
+    }
+  }
+  REQUIRE(rowsNode != nullptr);
+  // Twelve visible rows, one partially scrolled row and two overscan rows on each side.
+  CHECK(rowsNode->children.size() == 17u);
+}
+
+TEST_CASE("PrimeStage tree view rows keep a constant node count at any depth") {
+  PrimeFrame::Frame frame;
+  PrimeStage::UiNode root = createRoot(frame, 400.0f, 700.0f);
+
+  PrimeStage::TreeViewSpec spec;
+  spec.size.preferredWidth = 400.0f;
+  spec.size.preferredHeight = 680.0f;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.rowStartY = 0.0f;
+  spec.indent = 8.0f;
+  spec.showScrollBar = false;
+  spec.rowStyle = 11u;
+  spec.rowAltStyle = 12u;
+  spec.selectionStyle = 13u;
+  spec.selectionAccentStyle = 14u;
+  spec.caretBackgroundStyle = 15u;
+  spec.caretLineStyle = 16u;
+  spec.connectorStyle = 17u;
+  spec.textStyle = 1u;
+  spec.selectedTextStyle = 2u;
+
+  constexpr int Depth = 32;
+  PrimeStage::TreeNode chain{"Leaf"};
+  for (int level = 0; level < Depth; ++level) {
+    chain = PrimeStage::TreeNode{"Level", {std::move(chain)}, true, false};
+  }
+  spec.nodes = {std::move(chain)};
+
+  PrimeStage::UiNode tree = root.createTreeView(spec);
+  PrimeFrame::NodeId rowsNodeId = findVerticalStack(frame, tree.nodeId());
+  REQUIRE(rowsNodeId.isValid());
+  PrimeFrame::Node const* rowsNode = frame.getNode(rowsNodeId);
+  REQUIRE(rowsNode != nullptr);
+  REQUIRE(rowsNode->children.size() == static_cast<size_t>(Depth) + 1u);
+
+  // Connectors, caret and accent are primitives on the row; only the label is a child node.
+  for (PrimeFrame::NodeId rowId : rowsNode->children) {
+    PrimeFrame::Node const* row = frame.getNode(rowId);
+    REQUIRE(row != nullptr);
+    CHECK(row->children.size() == 1u);
+  }
+  PrimeFrame::Node const* deepest = frame.getNode(rowsNode->children.back());
+  REQUIRE(deepest != nullptr);
+  size_t connectors = 0u;
+  for (PrimeFrame::PrimitiveId primId : deepest->primitives) {
+    PrimeFrame::Primitive const* prim = frame.getPrimitive(primId);
+    if (prim && prim->type == PrimeFrame::PrimitiveType::Rect &&
+        prim->rect.token == spec.connectorStyle) {
+      ++connectors;
+    }
+  }
+  // The leaf's link into its parent's trunk, plus the parent's trunk ending at the leaf.
+  CHECK(connectors == 2u);
+}
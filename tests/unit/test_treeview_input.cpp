@@ -5,6 +5,12 @@
 #include "PrimeFrame/Layout.h"
 #include "third_party/doctest.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
 using namespace PrimeStage;
 
 namespace {
@@ -18,6 +24,39 @@ PrimeFrame::NodeId makeRoot(PrimeFrame::Frame& frame, float width, float height)
   }
   return root;
 }
+
+// Label of the visible tree row whose node sits at `localY` inside the row viewport.
+std::string visibleRowLabelAt(PrimeFrame::Frame const& frame,
+                              PrimeFrame::NodeId treeId,
+                              float localY) {
+  PrimeFrame::Node const* treeNode = frame.getNode(treeId);
+  if (!treeNode) {
+    return {};
+  }
+  for (PrimeFrame::NodeId viewportId : treeNode->children) {
+    PrimeFrame::Node const* viewport = frame.getNode(viewportId);
+    if (!viewport || !viewport->isViewport) {
+      continue;
+    }
+    for (PrimeFrame::NodeId rowId : viewport->children) {
+      PrimeFrame::Node const* row = frame.getNode(rowId);
+      if (!row || !row->visible || row->localY != localY) {
+        continue;
+      }
+      for (PrimeFrame::NodeId partId : row->children) {
+        PrimeFrame::Node const* part = frame.getNode(partId);
+        if (!part || part->primitives.empty()) {
+          continue;
+        }
+        PrimeFrame::Primitive const* prim = frame.getPrimitive(part->primitives.front());
+        if (prim && prim->type == PrimeFrame::PrimitiveType::Text) {
+          return prim->textBlock.text;
+        }
+      }
+    }
+  }
+  return {};
+}
 }
 
 TEST_CASE("TreeView keyboard navigation selects rows") {
@@ -163,3 +202,517 @@ TEST_CASE("TreeView scroll follows keyboard selection") {
 
   CHECK(lastScrollOffset > 0.0f);
 }
+
+TEST_CASE("Virtualized TreeView keyboard navigation rebinds recycled rows") {
+  PrimeFrame::Frame frame;
+  PrimeFrame::NodeId rootId = makeRoot(frame, 240.0f, 80.0f);
+  UiNode root(frame, rootId);
+
+  TreeViewSpec spec;
+  spec.size.preferredWidth = 240.0f;
+  spec.size.preferredHeight = 80.0f;
+  spec.rowStartY = 0.0f;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.keyboardNavigation = true;
+  spec.virtualized = true;
+  spec.overscanRows = 1;
+  spec.rowStyle = 3u;
+  spec.rowAltStyle = 4u;
+  spec.selectionStyle = 5u;
+  spec.textStyle = 0;
+  spec.selectedTextStyle = 0;
+
+  std::vector<std::string> labels;
+  for (int i = 0; i < 500; ++i) {
+    labels.push_back("Item " + std::to_string(i));
+  }
+  for (std::string const& label : labels) {
+    spec.nodes.push_back(TreeNode{label});
+  }
+
+  int selected = -1;
+  spec.callbacks.onSelectionChanged = [&](TreeViewRowInfo const& info) { selected = info.rowIndex; };
+  float lastScrollOffset = 0.0f;
+  spec.callbacks.onScrollChanged = [&](TreeViewScrollInfo const& info) {
+    lastScrollOffset = info.offset;
+  };
+
+  UiNode tree = root.createTreeView(spec);
+
+  PrimeFrame::LayoutEngine engine;
+  PrimeFrame::LayoutOutput layout;
+  engine.layout(frame, layout);
+
+  PrimeFrame::FocusManager focus;
+  focus.setActiveRoot(frame, layout, rootId);
+
+  PrimeFrame::EventRouter router;
+  PrimeFrame::Event down;
+  down.type = PrimeFrame::EventType::PointerDown;
+  down.pointerId = 1;
+  down.x = 8.0f;
+  down.y = 10.0f;
+  router.dispatch(down, frame, layout, &focus);
+  CHECK(selected == 0);
+
+  PrimeFrame::Event keyDown;
+  keyDown.type = PrimeFrame::EventType::KeyDown;
+  keyDown.key = PrimeStage::keyCodeInt(PrimeStage::KeyCode::End);
+  router.dispatch(keyDown, frame, layout, &focus);
+  CHECK(selected == 499);
+  CHECK(lastScrollOffset == doctest::Approx(500.0f * 20.0f - 80.0f));
+
+  keyDown.key = PrimeStage::keyCodeInt(PrimeStage::KeyCode::Up);
+  router.dispatch(keyDown, frame, layout, &focus);
+  CHECK(selected == 498);
+
+  // The pool never grows; the slot now showing the last row sits at its logical position.
+  PrimeFrame::Node const* treeNode = frame.getNode(tree.nodeId());
+  REQUIRE(treeNode != nullptr);
+  PrimeFrame::Node const* rowsNode = nullptr;
+  for (PrimeFrame::NodeId child : treeNode->children) {
+    PrimeFrame::Node const* childNode = frame.getNode(child);
+    if (childNode && childNode->isViewport) {
+      rowsNode = childNode;
+    }
+  }
+  REQUIRE(rowsNode != nullptr);
+  CHECK(rowsNode->children.size() == 7u);
+
+  PrimeFrame::Node const* lastRow = nullptr;
+  for (PrimeFrame::NodeId child : rowsNode->children) {
+    PrimeFrame::Node const* rowNode = frame.getNode(child);
+    if (rowNode && rowNode->localY == doctest::Approx(499.0f * 20.0f)) {
+      lastRow = rowNode;
+    }
+  }
+  REQUIRE(lastRow != nullptr);
+  REQUIRE(!lastRow->primitives.empty());
+  PrimeFrame::Primitive const* background = frame.getPrimitive(lastRow->primitives.front());
+  REQUIRE(background != nullptr);
+  CHECK(background->rect.token == spec.rowStyle);
+  std::string lastText;
+  for (PrimeFrame::NodeId child : lastRow->children) {
+    PrimeFrame::Node const* childNode = frame.getNode(child);
+    if (!childNode || childNode->primitives.empty()) {
+      continue;
+    }
+    PrimeFrame::Primitive const* prim = frame.getPrimitive(childNode->primitives.front());
+    if (prim && prim->type == PrimeFrame::PrimitiveType::Text) {
+      lastText = prim->textBlock.text;
+    }
+  }
+  CHECK(lastText == "Item 499");
+}
+
+TEST_CASE("TreeView row info paths are rebuilt from the flattened parent chain") {
+  PrimeFrame::Frame frame;
+  PrimeFrame::NodeId rootId = makeRoot(frame, 240.0f, 80.0f);
+  UiNode root(frame, rootId);
+
+  TreeViewSpec spec;
+  spec.size.preferredWidth = 240.0f;
+  spec.size.preferredHeight = 80.0f;
+  spec.rowStartY = 0.0f;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.keyboardNavigation = true;
+  spec.virtualized = true;
+  spec.showConnectors = false;
+  spec.rowStyle = 0;
+  spec.rowAltStyle = 0;
+  spec.selectionStyle = 0;
+  spec.textStyle = 0;
+  spec.selectedTextStyle = 0;
+
+  // A single chain far deeper than any recursive flatten would comfortably handle.
+  constexpr int ChainDepth = 4000;
+  TreeNode chain{"Leaf"};
+  for (int depth = 1; depth < ChainDepth; ++depth) {
+    TreeNode parent{"Branch"};
+    parent.children.push_back(std::move(chain));
+    chain = std::move(parent);
+  }
+  spec.nodes = {TreeNode{"First"}, std::move(chain)};
+
+  int selected = -1;
+  std::vector<uint32_t> selectedPath;
+  spec.callbacks.onSelectionChanged = [&](TreeViewRowInfo const& info) {
+    selected = info.rowIndex;
+    selectedPath.assign(info.path.begin(), info.path.end());
+  };
+
+  root.createTreeView(spec);
+
+  PrimeFrame::LayoutEngine engine;
+  PrimeFrame::LayoutOutput layout;
+  engine.layout(frame, layout);
+
+  PrimeFrame::FocusManager focus;
+  focus.setActiveRoot(frame, layout, rootId);
+
+  PrimeFrame::EventRouter router;
+  PrimeFrame::Event down;
+  down.type = PrimeFrame::EventType::PointerDown;
+  down.pointerId = 1;
+  down.x = 8.0f;
+  down.y = 10.0f;
+  router.dispatch(down, frame, layout, &focus);
+  CHECK(selected == 0);
+  CHECK(selectedPath == std::vector<uint32_t>{0u});
+
+  PrimeFrame::Event keyDown;
+  keyDown.type = PrimeFrame::EventType::KeyDown;
+  keyDown.key = PrimeStage::keyCodeInt(PrimeStage::KeyCode::End);
+  router.dispatch(keyDown, frame, layout, &focus);
+  CHECK(selected == ChainDepth);
+  REQUIRE(selectedPath.size() == static_cast<size_t>(ChainDepth));
+  CHECK(selectedPath.front() == 1u);
+  CHECK(std::all_of(selectedPath.begin() + 1, selectedPath.end(), [](uint32_t index) {
+    return index == 0u;
+  }));
+
+  keyDown.key = PrimeStage::keyCodeInt(PrimeStage::KeyCode::Left);
+  router.dispatch(keyDown, frame, layout, &focus);
+  CHECK(selected == ChainDepth - 1);
+  CHECK(selectedPath.size() == static_cast<size_t>(ChainDepth - 1));
+}
+
+TEST_CASE("TreeView with owned expansion splices rows in place") {
+  PrimeFrame::Frame frame;
+  PrimeFrame::NodeId rootId = makeRoot(frame, 240.0f, 200.0f);
+  UiNode root(frame, rootId);
+
+  TreeViewState state;
+  TreeViewSpec spec;
+  spec.state = &state;
+  spec.size.preferredWidth = 240.0f;
+  spec.size.preferredHeight = 200.0f;
+  spec.rowStartY = 0.0f;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.keyboardNavigation = true;
+  spec.rowStyle = 0;
+  spec.rowAltStyle = 0;
+  spec.selectionStyle = 0;
+  spec.textStyle = 0;
+  spec.selectedTextStyle = 0;
+  TreeNode folder{"Folder", {TreeNode{"A"}, TreeNode{"B"}, TreeNode{"C"}}, false, false};
+  folder.key = 11u;
+  TreeNode file{"File"};
+  file.key = 12u;
+  spec.nodes = {folder, file};
+
+  int expandedRow = -1;
+  bool expandedValue = false;
+  spec.callbacks.onExpandedChanged = [&](TreeViewRowInfo const& info, bool expanded) {
+    expandedRow = info.rowIndex;
+    expandedValue = expanded;
+  };
+
+  UiNode tree = root.createTreeView(spec);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 20.0f) == "File");
+
+  PrimeFrame::LayoutEngine engine;
+  PrimeFrame::LayoutOutput layout;
+  engine.layout(frame, layout);
+
+  PrimeFrame::FocusManager focus;
+  focus.setActiveRoot(frame, layout, rootId);
+
+  // Pressing the caret expands the folder without a rebuild.
+  PrimeFrame::EventRouter router;
+  PrimeFrame::Event down;
+  down.type = PrimeFrame::EventType::PointerDown;
+  down.pointerId = 1;
+  down.x = spec.caretBaseX + spec.caretSize * 0.5f;
+  down.y = 10.0f;
+  router.dispatch(down, frame, layout, &focus);
+  CHECK(expandedRow == 0);
+  CHECK(expandedValue);
+  CHECK(state.expanded[11u]);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 20.0f) == "A");
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 60.0f) == "C");
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 80.0f) == "File");
+
+  PrimeFrame::Event keyDown;
+  keyDown.type = PrimeFrame::EventType::KeyDown;
+  keyDown.key = PrimeStage::keyCodeInt(PrimeStage::KeyCode::Left);
+  router.dispatch(keyDown, frame, layout, &focus);
+  CHECK(expandedRow == 0);
+  CHECK_FALSE(expandedValue);
+  CHECK_FALSE(state.expanded[11u]);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 20.0f) == "File");
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 40.0f).empty());
+
+  // Expansion recorded in the state outlives the widget and wins over TreeNode::expanded.
+  state.expanded[11u] = true;
+  PrimeFrame::Frame rebuilt;
+  UiNode rebuiltRoot(rebuilt, makeRoot(rebuilt, 240.0f, 200.0f));
+  UiNode rebuiltTree = rebuiltRoot.createTreeView(spec);
+  CHECK(visibleRowLabelAt(rebuilt, rebuiltTree.nodeId(), 20.0f) == "A");
+  CHECK(visibleRowLabelAt(rebuilt, rebuiltTree.nodeId(), 80.0f) == "File");
+}
+
+TEST_CASE("TreeView provider loads only expanded branches and bound labels") {
+  PrimeFrame::Frame frame;
+  PrimeFrame::NodeId rootId = makeRoot(frame, 240.0f, 200.0f);
+  UiNode root(frame, rootId);
+
+  constexpr WidgetIdentityId FolderKey = 1u;
+  constexpr WidgetIdentityId RemoteKey = 2u;
+  constexpr size_t FolderItems = 1000u;
+  bool remoteReady = false;
+  int labelCalls = 0;
+  TreeDataSource source;
+  source.childCount = [&](WidgetIdentityId parent) -> size_t {
+    if (parent == InvalidWidgetIdentityId) {
+      return 2u;
+    }
+    return parent == FolderKey ? FolderItems : 1u;
+  };
+  source.childKey = [](WidgetIdentityId parent, size_t index) -> WidgetIdentityId {
+    if (parent == InvalidWidgetIdentityId) {
+      return index == 0u ? FolderKey : RemoteKey;
+    }
+    return parent * 10000u + index;
+  };
+  source.label = [&](WidgetIdentityId key) -> std::string {
+    ++labelCalls;
+    if (key == FolderKey) {
+      return "Folder";
+    }
+    if (key == RemoteKey) {
+      return "Remote";
+    }
+    return "Item " + std::to_string(key % 10000u);
+  };
+  source.hasChildren = [](WidgetIdentityId key) { return key == FolderKey || key == RemoteKey; };
+  source.childrenReady = [&](WidgetIdentityId parent) {
+    return parent != RemoteKey || remoteReady;
+  };
+  TreeDataProvider provider(std::move(source), 2u);
+
+  TreeViewState state;
+  TreeViewSpec spec;
+  spec.state = &state;
+  spec.provider = &provider;
+  spec.size.preferredWidth = 240.0f;
+  spec.size.preferredHeight = 200.0f;
+  spec.rowStartY = 0.0f;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.keyboardNavigation = true;
+  spec.rowStyle = 0;
+  spec.rowAltStyle = 0;
+  spec.selectionStyle = 0;
+  spec.textStyle = 0;
+  spec.selectedTextStyle = 0;
+
+  UiNode tree = root.createTreeView(spec);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 0.0f) == "Folder");
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 20.0f) == "Remote");
+  CHECK(provider.loadCount() == 1u);
+  CHECK(labelCalls == 2);
+
+  PrimeFrame::LayoutEngine engine;
+  PrimeFrame::LayoutOutput layout;
+  engine.layout(frame, layout);
+
+  PrimeFrame::FocusManager focus;
+  focus.setActiveRoot(frame, layout, rootId);
+
+  // Expanding the folder enumerates its keys once, but labels only for the bound rows.
+  PrimeFrame::EventRouter router;
+  PrimeFrame::Event down;
+  down.type = PrimeFrame::EventType::PointerDown;
+  down.pointerId = 1;
+  down.x = spec.caretBaseX + spec.caretSize * 0.5f;
+  down.y = 10.0f;
+  router.dispatch(down, frame, layout, &focus);
+  CHECK(state.expanded[FolderKey]);
+  CHECK(provider.loadCount() == 2u);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 20.0f) == "Item 0");
+  CHECK(labelCalls < 40);
+
+  PrimeFrame::Event keyDown;
+  keyDown.type = PrimeFrame::EventType::KeyDown;
+  keyDown.key = PrimeStage::keyCodeInt(PrimeStage::KeyCode::Left);
+  router.dispatch(keyDown, frame, layout, &focus);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 20.0f) == "Remote");
+
+  // A branch that is still loading shows a placeholder row and is not cached.
+  keyDown.key = PrimeStage::keyCodeInt(PrimeStage::KeyCode::Down);
+  router.dispatch(keyDown, frame, layout, &focus);
+  keyDown.key = PrimeStage::keyCodeInt(PrimeStage::KeyCode::Right);
+  router.dispatch(keyDown, frame, layout, &focus);
+  CHECK(state.expanded[RemoteKey]);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 40.0f) == "Loading...");
+  CHECK(provider.loadCount() == 2u);
+
+  // Once the children arrive the app invalidates the branch and rebuilds; loading it evicts the
+  // least recently used branch.
+  remoteReady = true;
+  provider.invalidate(RemoteKey);
+  PrimeFrame::Frame rebuilt;
+  UiNode rebuiltRoot(rebuilt, makeRoot(rebuilt, 240.0f, 200.0f));
+  UiNode rebuiltTree = rebuiltRoot.createTreeView(spec);
+  CHECK(visibleRowLabelAt(rebuilt, rebuiltTree.nodeId(), 40.0f) == "Item 0");
+  CHECK(provider.loadCount() == 3u);
+  CHECK(provider.cachedBranchCount() == 2u);
+}
+
+TEST_CASE("TreeView provider keeps the visible expanded branches cached across toggles") {
+  PrimeFrame::Frame frame;
+  PrimeFrame::NodeId rootId = makeRoot(frame, 240.0f, 200.0f);
+  UiNode root(frame, rootId);
+
+  TreeDataSource source;
+  source.childCount = [](WidgetIdentityId parent) -> size_t {
+    return parent == InvalidWidgetIdentityId ? 3u : 2u;
+  };
+  source.childKey = [](WidgetIdentityId parent, size_t index) -> WidgetIdentityId {
+    return parent * 10u + index + 1u;
+  };
+  source.label = [](WidgetIdentityId key) { return "Node " + std::to_string(key); };
+  source.hasChildren = [](WidgetIdentityId key) { return key < 10u; };
+  // Fewer branches than the tree shows expanded.
+  TreeDataProvider provider(std::move(source), 2u);
+
+  TreeViewState state;
+  state.expanded[1u] = true;
+  state.expanded[2u] = true;
+  state.expanded[3u] = true;
+  TreeViewSpec spec;
+  spec.state = &state;
+  spec.provider = &provider;
+  spec.size.preferredWidth = 240.0f;
+  spec.size.preferredHeight = 200.0f;
+  spec.rowStartY = 0.0f;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 0.0f;
+  spec.rowStyle = 0;
+  spec.rowAltStyle = 0;
+  spec.selectionStyle = 0;
+  spec.textStyle = 0;
+  spec.selectedTextStyle = 0;
+
+  UiNode tree = root.createTreeView(spec);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 140.0f) == "Node 31");
+  CHECK(provider.loadCount() == 4u);
+  CHECK(provider.cachedBranchCount() == 4u);
+
+  PrimeFrame::LayoutEngine engine;
+  PrimeFrame::LayoutOutput layout;
+  engine.layout(frame, layout);
+
+  // Collapsing re-flattens from the cache without asking the source again.
+  PrimeFrame::EventRouter router;
+  PrimeFrame::Event down;
+  down.type = PrimeFrame::EventType::PointerDown;
+  down.pointerId = 1;
+  down.x = spec.caretBaseX + spec.caretSize * 0.5f;
+  down.y = 10.0f;
+  router.dispatch(down, frame, layout, nullptr);
+  CHECK_FALSE(state.expanded[1u]);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 20.0f) == "Node 2");
+  CHECK(provider.loadCount() == 4u);
+
+  // Expanding again loads at most the branch being expanded.
+  PrimeFrame::Event up = down;
+  up.type = PrimeFrame::EventType::PointerUp;
+  router.dispatch(up, frame, layout, nullptr);
+  router.dispatch(down, frame, layout, nullptr);
+  CHECK(state.expanded[1u]);
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 20.0f) == "Node 11");
+  CHECK(provider.loadCount() <= 5u);
+}
+
+TEST_CASE("TreeView clicks and caret hits land on the right rows of a scrolled gapped tree") {
+  PrimeFrame::Frame frame;
+  PrimeFrame::NodeId rootId = makeRoot(frame, 240.0f, 100.0f);
+  UiNode root(frame, rootId);
+
+  std::vector<std::string> labels;
+  labels.reserve(20);
+  for (int index = 0; index < 10; ++index) {
+    labels.push_back("Folder " + std::to_string(index));
+    labels.push_back("Child " + std::to_string(index));
+  }
+  TreeViewState state;
+  TreeViewSpec spec;
+  spec.state = &state;
+  spec.size.preferredWidth = 240.0f;
+  spec.size.preferredHeight = 100.0f;
+  spec.rowStartY = 0.0f;
+  spec.rowHeight = 20.0f;
+  spec.rowGap = 4.0f;
+  spec.showScrollBar = false;
+  spec.rowStyle = 0;
+  spec.rowAltStyle = 0;
+  spec.selectionStyle = 0;
+  spec.textStyle = 0;
+  spec.selectedTextStyle = 0;
+  for (int index = 0; index < 10; ++index) {
+    TreeNode folder{labels[static_cast<size_t>(index) * 2u]};
+    folder.key = 100u + static_cast<WidgetIdentityId>(index);
+    folder.expanded = false;
+    folder.children.push_back(TreeNode{labels[static_cast<size_t>(index) * 2u + 1u]});
+    folder.children.back().key = 200u + static_cast<WidgetIdentityId>(index);
+    spec.nodes.push_back(std::move(folder));
+  }
+
+  std::vector<int> selectedRows;
+  spec.callbacks.onSelect = [&](TreeViewRowInfo const& info) {
+    selectedRows.push_back(info.rowIndex);
+  };
+  int expandedRow = -1;
+  spec.callbacks.onExpandedChanged = [&](TreeViewRowInfo const& info, bool expanded) {
+    expandedRow = expanded ? info.rowIndex : -1;
+  };
+
+  UiNode tree = root.createTreeView(spec);
+  PrimeFrame::LayoutEngine engine;
+  PrimeFrame::LayoutOutput layout;
+  engine.layout(frame, layout);
+
+  // Two row pitches of 24 scroll row 2 to the top.
+  PrimeFrame::EventRouter router;
+  PrimeFrame::Event scroll;
+  scroll.type = PrimeFrame::EventType::PointerScroll;
+  scroll.x = 100.0f;
+  scroll.y = 50.0f;
+  scroll.scrollY = 48.0f;
+  router.dispatch(scroll, frame, layout, nullptr);
+  engine.layout(frame, layout);
+
+  auto pointerDown = [&](float x, float y) {
+    PrimeFrame::Event down;
+    down.type = PrimeFrame::EventType::PointerDown;
+    down.pointerId = 1;
+    down.x = x;
+    down.y = y;
+    router.dispatch(down, frame, layout, nullptr);
+    PrimeFrame::Event up = down;
+    up.type = PrimeFrame::EventType::PointerUp;
+    router.dispatch(up, frame, layout, nullptr);
+  };
+
+  pointerDown(100.0f, 3.0f * 24.0f - 48.0f + 10.0f);
+  REQUIRE(selectedRows.size() == 1u);
+  CHECK(selectedRows.back() == 3);
+
+  // The gap below row 3 belongs to no row.
+  pointerDown(100.0f, 3.0f * 24.0f + 22.0f - 48.0f);
+  CHECK(selectedRows.size() == 1u);
+
+  pointerDown(spec.caretBaseX + spec.caretSize * 0.5f, 4.0f * 24.0f - 48.0f + 10.0f);
+  CHECK(expandedRow == 4);
+  auto toggled = state.expanded.find(104u);
+  REQUIRE(toggled != state.expanded.end());
+  CHECK(toggled->second);
+  auto untouched = state.expanded.find(103u);
+  CHECK((untouched == state.expanded.end() || !untouched->second));
+  CHECK(visibleRowLabelAt(frame, tree.nodeId(), 5.0f * 24.0f) == "Child 4");
+}